@@ -173,6 +173,7 @@ export function FlightSimulation() {
   useEffect(() => {
     if (!isRunning || !simulationRef.current || !rendererRef.current) return
     
+    const wasm = getWasmModule()
     let lastTime = performance.now()
     
     const animate = (currentTime: number) => {
@@ -180,6 +181,7 @@ export function FlightSimulation() {
       lastTime = currentTime
       
       // Update simulation
+      wasm?.beginFrame()
       simulationRef.current!.update(deltaTime)
       
       // Get state
@@ -1,5 +1,6 @@
 import { useEffect, useState } from 'react'
 import { getWasmModule } from '@/utils/wasm-loader'
+import { benchmarkBatchMath } from '@/utils/batch-math'
 
 export function WasmTest() {
   const [tests, setTests] = useState<string[]>([])
@@ -48,6 +49,20 @@ export function WasmTest() {
         test.incrementCounter()
         results.push(`✅ Counter: ${test.getCounter()}`)
         
+        // Batch math against the per-object Vector3/Quaternion path; a speedup is only
+        // reported when the batch results match and were measured faster
+        for (const r of benchmarkBatchMath(wasm, 10000)) {
+          const label = `Batch ${r.operation} x${r.count}`
+          const timing = `${r.perObjectMs.toFixed(2)} ms per object, ${r.batchMs.toFixed(3)} ms batched`
+          if (!r.matches) {
+            results.push(`❌ ${label}: results differ from the per-object path`)
+          } else if (r.batchMs < r.perObjectMs) {
+            results.push(`✅ ${label}: ${timing} (${(r.perObjectMs / r.batchMs).toFixed(1)}x faster)`)
+          } else {
+            results.push(`⚠️ ${label}: ${timing} (no speedup)`)
+          }
+        }
+        
       } catch (error) {
         results.push(`❌ Error: ${error instanceof Error ? error.message : 'Unknown error'}`)
       }
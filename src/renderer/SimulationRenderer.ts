@@ -15,6 +15,7 @@ export interface Aircraft {
 export class SimulationRenderer extends WebGLRenderer {
   // private wasm: YSFlightCore | null = null // Will be used later
   private aircraft: Map<string, Aircraft> = new Map()
+  private instancedAircraft: Map<number, THREE.InstancedMesh> = new Map()
   private terrain?: THREE.Mesh
   private cameraManager: CameraManager
   private aircraftManager: AircraftManager
@@ -152,6 +153,42 @@ export class SimulationRenderer extends WebGLRenderer {
     }
   }
   
+  // One InstancedMesh per model id of the core's InstanceBuffer
+  public setInstancedModel(
+    model: number,
+    geometry: THREE.BufferGeometry,
+    material: THREE.Material,
+    capacity: number
+  ): void {
+    this.removeInstancedModel(model)
+    const mesh = new THREE.InstancedMesh(geometry, material, capacity)
+    mesh.instanceMatrix.setUsage(THREE.DynamicDrawUsage)
+    mesh.frustumCulled = false
+    mesh.count = 0
+    this.getScene().add(mesh)
+    this.instancedAircraft.set(model, mesh)
+  }
+  
+  public removeInstancedModel(model: number): void {
+    const mesh = this.instancedAircraft.get(model)
+    if (mesh) {
+      this.getScene().remove(mesh)
+      mesh.dispose()
+      this.instancedAircraft.delete(model)
+    }
+  }
+  
+  // Copy a model's run of column-major matrices (InstanceBuffer.getMatrices) in one upload
+  public updateInstances(model: number, matrices: Float32Array, offset: number, count: number): void {
+    const mesh = this.instancedAircraft.get(model)
+    if (!mesh) return
+    
+    const visible = Math.min(count, mesh.instanceMatrix.count)
+    mesh.instanceMatrix.array.set(matrices.subarray(offset * 16, (offset + visible) * 16))
+    mesh.instanceMatrix.needsUpdate = true
+    mesh.count = visible
+  }
+  
   public addTerrain(): void {
     // Create simple terrain mesh
     const geometry = new THREE.PlaneGeometry(10000, 10000, 100, 100)
@@ -262,6 +299,7 @@ export class SimulationRenderer extends WebGLRenderer {
   public dispose(): void {
     // Remove all aircraft
     this.aircraft.forEach((_, id) => this.removeAircraft(id))
+    this.instancedAircraft.forEach((_, model) => this.removeInstancedModel(model))
     
     // Remove terrain
     if (this.terrain) {
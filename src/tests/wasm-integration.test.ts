@@ -76,4 +76,26 @@ describe.skip('WASM Integration Tests', () => {
     const distance = testModule.calculateDistance(0, 0, 0, 3, 4, 0)
     expect(distance).toBe(5)
   })
+  
+  it('should add vectors through heap buffers', () => {
+    if (!wasm) {
+      expect(wasm).toBeDefined()
+      return
+    }
+    
+    const testModule = new wasm.TestModule('buffers')
+    expect(Array.from(testModule.addVectors([1, 2, 3], new Float32Array([4, 5, 6])))).toEqual([5, 7, 9])
+    
+    const a = new wasm.HeapBuffer(0)
+    const b = new wasm.HeapBuffer(0)
+    const out = new wasm.HeapBuffer(0)
+    a.assign([1, 2])
+    b.assign([10, 20, 30])
+    testModule.addVectorsInto(a, b, out)
+    expect(out.getLength()).toBe(2)
+    expect(Array.from(out.view())).toEqual([11, 22])
+    a.delete()
+    b.delete()
+    out.delete()
+  })
 })
\ No newline at end of file
@@ -11,6 +11,7 @@ export interface Vector3 {
   cross(other: Vector3): Vector3;
   length(): number;
   normalize(): Vector3;
+  delete(): void;
 }
 
 export interface Quaternion {
@@ -20,28 +21,81 @@ export interface Quaternion {
   z: number;
   multiply(other: Quaternion): Quaternion;
   rotateVector(v: Vector3): Vector3;
+  delete(): void;
+}
+
+// Float array in WASM memory owned by the handle; call delete() to free it
+export interface HeapBuffer {
+  resize(length: number): void;
+  // Resize to the array's length and copy it in
+  assign(data: ArrayLike<number>): void;
+  getLength(): number;
+  getCapacity(): number;
+  // Byte offset for HEAPF32 and the batch math functions
+  getOffset(): number;
+  // View of the contents, invalid after a resize past the capacity or memory growth
+  view(): Float32Array;
+  delete(): void;
 }
 
 export interface TestModule {
   getName(): string;
   incrementCounter(): number;
   getCounter(): number;
-  addVectors(a: number[], b: number[]): number[];
+  // Result is a view into WASM memory, valid until the next call
+  addVectors(a: ArrayLike<number>, b: ArrayLike<number>): Float32Array;
+  // Zero-copy over caller-owned buffers; out is resized to the shorter input
+  addVectorsInto(a: HeapBuffer, b: HeapBuffer, out: HeapBuffer): void;
   calculateDistance(x1: number, y1: number, z1: number, 
                    x2: number, y2: number, z2: number): number;
 }
 
+export type WasmVariant = 'baseline' | 'simd' | 'simd-mt';
+
 export interface SystemInfo {
   platform: string;
   wasmSupported: boolean;
+  variant: WasmVariant;   // Build variant the loader picked
   threadsSupported: boolean;
   simdSupported: boolean;
+  kernels: {
+    vectorMath: 'wasm_simd128' | 'sse2' | 'scalar';
+    workerThreads: number;  // Thread pool size for trim tables (1 without threads)
+  };
   memory: {
     heapSize: number;
     stackSize: number;
+    // Tracked C++ allocations, in bytes
+    currentBytes: number;
+    peakBytes: number;
+    allocations: number;
+    lastFrameAllocations: number;
+    // Allocations while stepping the simulation, counted when the check is enabled
+    hotPathCheck: boolean;
+    hotPathAllocations: number;
+    tags: MemoryTagStats[];
+    arenas: ArenaStats[];
   };
 }
 
+// Allocations charged to one subsystem
+export interface MemoryTagStats {
+  name: string;           // other, physics, assets, recorder, network, particles
+  currentBytes: number;
+  peakBytes: number;
+  allocations: number;
+}
+
+// Bump arena usage in bytes
+export interface ArenaStats {
+  name: string;           // 'frame' (reset every tick) or 'load'
+  used: number;
+  capacity: number;
+  highWater: number;
+  blocks: number;
+  blockAllocations: number;  // Calls to the system allocator so far
+}
+
 export interface AircraftState {
   position: { x: number; y: number; z: number };
   velocity: { x: number; y: number; z: number };
@@ -69,6 +123,8 @@ export interface AircraftProperties {
   wingArea: number;
   wingSpan: number;
   maxThrust: number;
+  // Bounding sphere radius (m), HTRADIUS in the DAT file
+  outsideRadius?: number;
 }
 
 export interface FlightSimulation {
@@ -86,6 +142,241 @@ export interface FlightSimulation {
   getState(): AircraftState;
   getProperties(): AircraftProperties;
   reset(): void;
+  // Portable math for bit-identical results across builds and browsers
+  setDeterministic(enabled: boolean): void;
+  // 64-bit state hash as 16 hex digits
+  getChecksum(): string;
+  // Independent copy that shares the aircraft properties
+  clone(): FlightSimulation;
+  // Dynamic state as bytes; view valid until the next saveSnapshot(), copy to keep it
+  saveSnapshot(): Uint8Array;
+  restoreSnapshot(bytes: Uint8Array): boolean;
+}
+
+export interface TrimResult {
+  throttle: number;
+  elevator: number;
+  alpha: number;
+  residual: number;
+  converged: boolean;
+}
+
+export interface TrimCache {
+  addAircraftDat(datText: string): string;
+  // Axes must be strictly ascending; returns false (and keeps the old tables) otherwise
+  compute(altitudes: number[], speeds: number[]): boolean;
+  lookup(name: string, altitude: number, speed: number): TrimResult | null;
+  delete(): void;
+}
+
+export interface EnergyDiagram {
+  // false for invalid DAT text, a non-positive Mach bound, a negative altitude or MIN > MAX
+  compute(
+    datText: string,
+    minMach: number, maxMach: number, machSteps: number,
+    minAltitude: number, maxAltitude: number, altitudeSteps: number
+  ): boolean;
+  // [altitude][mach][channel], valid until the next compute()
+  getData(): Float32Array;
+  getChannelCount(): number;
+  getMachCount(): number;
+  getAltitudeCount(): number;
+  toCsv(): string;
+  delete(): void;
+}
+
+export interface Fleet {
+  addAircraft(x: number, y: number, z: number, heading: number): number;
+  addTrimmedAircraft(
+    trimCache: TrimCache, name: string,
+    x: number, y: number, z: number, heading: number, speed: number
+  ): number;
+  clear(): void;
+  getCount(): number;
+  // Calls with an index outside [0, getCount()) are ignored
+  setAircraftType(index: number, type: string): void;
+  setAircraftProperties(
+    index: number,
+    emptyMass: number, maxFuel: number, wingArea: number,
+    maxThrust: number, thrustMilitary: number,
+    critAOAPos: number, critAOANeg: number,
+    minManeuverSpeed: number, maxSpeed: number
+  ): void;
+  setControls(index: number, throttle: number, aileron: number, elevator: number, rudder: number): void;
+  setAutopilotMode(index: number, mode: number): void;
+  setTargetAltitude(index: number, altitude: number): void;
+  setTargetHeading(index: number, heading: number): void;
+  setTargetSpeed(index: number, speed: number): void;
+  setThrottleTrim(index: number, throttle: number): void;
+  addWaypoint(index: number, x: number, y: number, z: number, speed: number): void;
+  clearWaypoints(index: number): void;
+  setRouteLooping(index: number, loop: boolean): void;
+  getCurrentWaypoint(index: number): number;
+  update(deltaTime: number): void;
+  // null for an invalid index
+  getState(index: number): AircraftState | null;
+  // PHYSICS_FULL or PHYSICS_POINT_MASS; switching never moves the aircraft
+  setPhysicsLod(index: number, lod: number): void;
+  getPhysicsLod(index: number): number;
+  getPointMassCount(): number;
+  // Full physics within fullRadius of any focus point (flat x, y, z array), point mass beyond
+  selectPhysicsLod(focusPoints: number[], fullRadius: number): void;
+  setPointMassInterval(ticks: number): void;
+  setDeterministic(enabled: boolean): void;
+  // Rolling hash over every tick in deterministic mode (16 hex digits)
+  getChecksum(): string;
+  delete(): void;
+}
+
+export interface RollbackSimulation {
+  addAircraft(x: number, y: number, z: number, heading: number): number;
+  // Input for the given tick; late inputs trigger re-simulation on the next step().
+  // false for a non-integral or negative tick, or one outside the history window
+  setInput(index: number, tick: number, throttle: number, aileron: number, elevator: number, rudder: number): boolean;
+  step(ticks: number): void;
+  getCount(): number;
+  getCurrentTick(): number;
+  getOldestTick(): number;
+  getLastResimulatedTicks(): number;
+  getRollbackCount(): number;
+  // null for an invalid index
+  getState(index: number): AircraftState | null;
+  setDeterministic(enabled: boolean): void;
+  // Hash of the current state of every aircraft (16 hex digits)
+  getChecksum(): string;
+  delete(): void;
+}
+
+export interface RemoteAircraft {
+  addAircraft(): number;
+  // Aircraft type registered in the trim cache; returns -1 if unknown
+  addAircraftType(trimCache: TrimCache, name: string): number;
+  // Sender state stamped with the sender's time; older updates and invalid indices are
+  // ignored (returns false)
+  applyUpdate(index: number, state: AircraftState, fuel: number, time: number): boolean;
+  update(deltaTime: number): void;
+  setTime(time: number): void;
+  getTime(): number;
+  getCount(): number;
+  // Invalid indices read as stale, without error and with a null state
+  isStale(index: number): boolean;
+  getPositionError(index: number): number;
+  // Displayed (smoothed) state
+  getState(index: number): AircraftState | null;
+  // View into WASM memory: x, y, z, heading, pitch, roll per aircraft
+  getRenderData(): Float32Array;
+  delete(): void;
+}
+
+// Column-major 4x4 world matrices, one per aircraft, grouped by model id
+export interface InstanceBuffer {
+  // Ignored unless 0 <= index < 65536 and 0 <= model < 1024
+  setModel(index: number, model: number): void;
+  // Also write last build's matrices in the same slot order (motion blur)
+  setKeepPrevious(enabled: boolean): void;
+  resetPrevious(): void;
+  buildFromFleet(fleet: Fleet): void;
+  buildFromRemote(remote: RemoteAircraft): void;
+  getInstanceCount(): number;
+  getModelCount(): number;
+  // Slots [offset, offset + count) hold the instances of a model
+  getGroupOffset(model: number): number;
+  getGroupCount(model: number): number;
+  // Views into WASM memory, invalid after a larger build or memory growth
+  getMatrices(): Float32Array;
+  getPreviousMatrices(): Float32Array;
+  // Aircraft index drawn in each slot
+  getSlotEntities(): Int32Array;
+  delete(): void;
+}
+
+export interface Visibility {
+  // Six planes as nx, ny, nz, constant with inward normals (THREE.Frustum planes)
+  setFrustum(planes: number[] | Float32Array): void;
+  setCamera(x: number, y: number, z: number): void;
+  // Ascending distance / radius ratios starting LOD 1, 2, ... (at most 4)
+  setLodRatios(ratios: number[]): void;
+  // 0 disables distance culling
+  setMaxDistance(distance: number): void;
+  // x, y, z, radius per entity
+  setSpheres(visibilityClass: number, spheres: number[] | Float32Array): void;
+  setAircraftFromFleet(fleet: Fleet): void;
+  setAircraftFromRemote(remote: RemoteAircraft): void;
+  cull(): void;
+  getVisibleCount(visibilityClass: number): number;
+  // Views into WASM memory: visible indices, and a LOD per entity (VISIBILITY_CULLED if hidden);
+  // null for an invalid visibility class
+  getVisible(visibilityClass: number): Int32Array | null;
+  getLods(visibilityClass: number): Uint8Array | null;
+  delete(): void;
+}
+
+export interface ScheduledTaskStats {
+  name: string;
+  rate: number;       // Effective rate (Hz)
+  period: number;     // Base ticks between runs of each item
+  calls: number;
+  meanMs: number;
+  maxMs: number;
+  lastMs: number;
+}
+
+export interface Scheduler {
+  // Fleet tasks at the given rates (Hz); the first playerCount aircraft are players.
+  // False, scheduling nothing, if a rate is not in (0, tick rate]
+  scheduleFleet(
+    fleet: Fleet, playerCount: number,
+    playerRate: number, aiRate: number, autopilotRate: number, fuelRate: number
+  ): boolean;
+  step(): void;
+  // Runs the whole base ticks covered by deltaTime and returns how many ran; negative or
+  // non-finite deltas run nothing
+  advance(deltaTime: number): number;
+  getTime(): number;
+  getTick(): number;
+  getDroppedTicks(): number;
+  setTaskEnabled(task: number, enabled: boolean): boolean;
+  getStats(): ScheduledTaskStats[];
+  getLastTickMs(): number;
+  getMaxTickMs(): number;
+  resetStats(): void;
+  delete(): void;
+}
+
+export interface FlightRecorder {
+  // Call once per physics tick; track i records fleet aircraft i
+  recordFleet(fleet: Fleet): void;
+  recordSimulation(trackIndex: number, simulation: FlightSimulation, time: number): boolean;
+  clear(): void;
+  getTrackCount(): number;
+  // 0 for an invalid track index
+  getTickCount(track: number): number;
+  isFull(): boolean;
+  getAllocatedBytes(): number;
+  getEncodedBytes(): number;
+  // View into WASM memory, valid until the next serializeTrack(); copy before saving.
+  // null for an invalid track index
+  serializeTrack(track: number): Uint8Array | null;
+  delete(): void;
+}
+
+export interface Replay {
+  // Serialized track from FlightRecorder.serializeTrack(); returns -1 if malformed
+  loadTrack(bytes: Uint8Array): number;
+  // Copy of a track still being recorded; returns -1 for an invalid track index
+  addRecordedTrack(recorder: FlightRecorder, track: number): number;
+  clear(): void;
+  seek(time: number): void;
+  advance(deltaTime: number): void;
+  getTime(): number;
+  getStartTime(): number;
+  getEndTime(): number;
+  getGhostCount(): number;
+  // Empty for an invalid index
+  getAircraftName(index: number): string;
+  // Interpolated ghost state at the current replay time; null for an invalid index
+  getState(index: number): AircraftState | null;
+  delete(): void;
 }
 
 export interface YSFlightCore {
@@ -101,6 +392,10 @@ export interface YSFlightCore {
     fromAxisAngle(axis: Vector3, angle: number): Quaternion;
   };
   
+  HeapBuffer: {
+    new(length: number): HeapBuffer;
+  };
+  
   TestModule: {
     new(name: string): TestModule;
   };
@@ -109,16 +404,101 @@ export interface YSFlightCore {
     new(): FlightSimulation;
   };
   
+  Fleet: {
+    new(): Fleet;
+  };
+  
+  TrimCache: {
+    new(): TrimCache;
+  };
+  
+  RollbackSimulation: {
+    // historyLength is clamped to [1, 4096]; a non-positive tickDuration falls back to 1/60
+    new(historyLength: number, tickDuration: number): RollbackSimulation;
+  };
+  
+  RemoteAircraft: {
+    new(): RemoteAircraft;
+  };
+  
+  Scheduler: {
+    new(tickRate: number): Scheduler;
+  };
+  
+  InstanceBuffer: {
+    new(): InstanceBuffer;
+  };
+  
+  Visibility: {
+    new(): Visibility;
+  };
+  
+  EnergyDiagram: {
+    new(): EnergyDiagram;
+  };
+  
+  FlightRecorder: {
+    // keyframeInterval is at least 1; memoryBudgetMB is clamped to [1, 2048]
+    new(keyframeInterval: number, memoryBudgetMB: number): FlightRecorder;
+  };
+  
+  Replay: {
+    new(): Replay;
+  };
+  
+  // Energy diagram channels
+  EM_SPECIFIC_EXCESS_POWER: number;
+  EM_SUSTAINED_TURN_RATE: number;
+  EM_INSTANTANEOUS_TURN_RATE: number;
+  EM_SUSTAINED_LOAD_FACTOR: number;
+  EM_INSTANTANEOUS_LOAD_FACTOR: number;
+  
+  // Autopilot mode flags (combinable)
+  AUTOPILOT_OFF: number;
+  AUTOPILOT_ALTITUDE: number;
+  AUTOPILOT_HEADING: number;
+  AUTOPILOT_SPEED: number;
+  AUTOPILOT_WAYPOINT: number;
+  
+  // Fleet physics level of detail
+  PHYSICS_FULL: number;
+  PHYSICS_POINT_MASS: number;
+  
+  // Visibility classes and the LOD value of hidden entities
+  VISIBILITY_AIRCRAFT: number;
+  VISIBILITY_EMITTERS: number;
+  VISIBILITY_PROJECTILES: number;
+  VISIBILITY_CULLED: number;
+  
   // Global functions
   getVersion(): string;
   getBuildInfo(): string;
   getSystemInfo(): SystemInfo;
+  getArenaStats(): ArenaStats[];
+  setAllocationCheck(enabled: boolean): void;
+  resetMemoryPeaks(): void;
+  // Once per animation frame, before updating any simulation: resets the frame arena and
+  // starts the lastFrameAllocations count
+  beginFrame(): void;
   
   // Math utilities
   degToRad(degrees: number): number;
   radToDeg(radians: number): number;
   clamp(value: number, min: number, max: number): number;
   lerp(a: number, b: number, t: number): number;
+  
+  // Batch math over packed floats in the heap; offsets are byte offsets from _malloc.
+  // Vectors are 3 floats, quaternions 4 (x, y, z, w); out may alias an input.
+  addVectors(a: number, b: number, out: number, count: number): void;
+  crossVectors(a: number, b: number, out: number, count: number): void;
+  normalizeVectors(vectors: number, out: number, count: number): void;
+  multiplyQuaternions(a: number, b: number, out: number, count: number): void;
+  rotateVectors(quaternions: number, vectors: number, out: number, count: number): void;
+  
+  // Heap access
+  HEAPF32: Float32Array;
+  _malloc(bytes: number): number;
+  _free(pointer: number): void;
 }
 
 export interface YSFlightModule {
@@ -0,0 +1,59 @@
+import { loadModuleScript } from './wasm-loader'
+
+// Asset-processing module (ysflight-assets): the DAT compiler. Nothing needs it to start
+// flying, so it is fetched and compiled on the first asset load. It has its own memory;
+// results are copied out as bytes and handed to the physics module.
+
+export interface AssetModule {
+  HEAPU8: Uint8Array;
+  _malloc(size: number): number;
+  _free(ptr: number): void;
+  _ysf_compile_dat(text: number, length: number): number;
+  _ysf_asset_data(): number;
+}
+
+declare global {
+  interface Window {
+    YSFlightAssets?: (options: object) => Promise<AssetModule>;
+  }
+}
+
+let assetPromise: Promise<AssetModule> | null = null;
+
+// Starts the download in the background; later calls share it
+export function loadAssetModule(): Promise<AssetModule> {
+  if (assetPromise) {
+    return assetPromise;
+  }
+
+  assetPromise = (async () => {
+    await loadModuleScript('/ysflight-assets.js');
+    if (!window.YSFlightAssets) {
+      throw new Error('YSFlightAssets not found after loading script');
+    }
+    return window.YSFlightAssets({
+      locateFile: (path: string) => path.endsWith('.wasm') ? '/ysflight-assets.wasm' : path
+    });
+  })();
+
+  // Allow a retry after a failed download
+  assetPromise.catch(() => {
+    assetPromise = null;
+  });
+  return assetPromise;
+}
+
+// Compiled aircraft asset for PhysicsAircraft.loadAsset, or null if the DAT is invalid
+export async function compileAircraftDat(text: string): Promise<Uint8Array | null> {
+  const module = await loadAssetModule();
+  const bytes = new TextEncoder().encode(text);
+  const ptr = module._malloc(bytes.length);
+  module.HEAPU8.set(bytes, ptr);
+  const size = module._ysf_compile_dat(ptr, bytes.length);
+  module._free(ptr);
+  if (size === 0) {
+    return null;
+  }
+  const data = module._ysf_asset_data();
+  return module.HEAPU8.slice(data, data + size);
+}
@@ -0,0 +1,182 @@
+import type { HeapBuffer, YSFlightCore } from '@/types/wasm';
+
+// Typed-array front end for the batch math functions. Inputs are copied into heap buffers
+// owned by this object and processed with a single wasm call, however many elements there
+// are. Vectors are packed as 3 floats, quaternions as 4 (x, y, z, w). Call dispose() when done.
+export class BatchMath {
+  private buffers: HeapBuffer[];
+
+  constructor(private wasm: YSFlightCore) {
+    this.buffers = [new wasm.HeapBuffer(0), new wasm.HeapBuffer(0)];
+  }
+
+  public add(a: Float32Array, b: Float32Array, out?: Float32Array): Float32Array {
+    const count = Math.floor(Math.min(a.length, b.length) / 3);
+    return this.run([a, b], [3, 3], count, 0, out, ([pa, pb]) => this.wasm.addVectors(pa, pb, pa, count));
+  }
+
+  public cross(a: Float32Array, b: Float32Array, out?: Float32Array): Float32Array {
+    const count = Math.floor(Math.min(a.length, b.length) / 3);
+    return this.run([a, b], [3, 3], count, 0, out, ([pa, pb]) => this.wasm.crossVectors(pa, pb, pa, count));
+  }
+
+  public normalize(vectors: Float32Array, out?: Float32Array): Float32Array {
+    const count = Math.floor(vectors.length / 3);
+    return this.run([vectors], [3], count, 0, out, ([p]) => this.wasm.normalizeVectors(p, p, count));
+  }
+
+  public multiplyQuaternions(a: Float32Array, b: Float32Array, out?: Float32Array): Float32Array {
+    const count = Math.floor(Math.min(a.length, b.length) / 4);
+    return this.run([a, b], [4, 4], count, 0, out, ([pa, pb]) => this.wasm.multiplyQuaternions(pa, pb, pa, count));
+  }
+
+  // Rotate vectors[i] by quaternions[i]
+  public rotate(quaternions: Float32Array, vectors: Float32Array, out?: Float32Array): Float32Array {
+    const count = Math.floor(Math.min(quaternions.length / 4, vectors.length / 3));
+    return this.run([quaternions, vectors], [4, 3], count, 1, out,
+      ([pq, pv]) => this.wasm.rotateVectors(pq, pv, pv, count));
+  }
+
+  public dispose(): void {
+    this.buffers.forEach(buffer => buffer.delete());
+    this.buffers = [];
+  }
+
+  // Results are written over input 'resultSlot' and copied out from there
+  private run(inputs: Float32Array[], widths: number[], count: number, resultSlot: number,
+              out: Float32Array | undefined, call: (offsets: number[]) => void): Float32Array {
+    inputs.forEach((_, slot) => this.buffers[slot].resize(count * widths[slot]));
+    // Views are taken after every resize: growing memory detaches older ones
+    const offsets = inputs.map((data, slot) => {
+      this.buffers[slot].view().set(data.subarray(0, count * widths[slot]));
+      return this.buffers[slot].getOffset();
+    });
+    call(offsets);
+
+    const result = out ?? new Float32Array(count * widths[resultSlot]);
+    result.set(this.buffers[resultSlot].view());
+    return result;
+  }
+}
+
+export interface BatchBenchmarkResult {
+  operation: string;
+  count: number;
+  // Mean time of one pass over all elements
+  perObjectMs: number;
+  batchMs: number;
+  // The batch output equals the per-object output bit for bit (both use the same Vec3/Quat math)
+  matches: boolean;
+}
+
+function randomFloats(length: number): Float32Array {
+  const data = new Float32Array(length);
+  for (let i = 0; i < length; i++) {
+    data[i] = Math.random() * 2 - 1;
+  }
+  return data;
+}
+
+// Mean milliseconds per run, repeated until minMs has passed: browsers coarsen
+// performance.now(), so a single batched pass can read as zero
+function timeRepeated(run: () => void, minMs: number): number {
+  let runs = 0;
+  let elapsed = 0;
+  const start = performance.now();
+  do {
+    run();
+    runs++;
+    elapsed = performance.now() - start;
+  } while (elapsed < minMs);
+  return elapsed / runs;
+}
+
+// Times each operation over 'count' elements through the embind Vector3/Quaternion objects
+// (including the delete() calls they need) and through one BatchMath call, and checks that
+// both produce the same values. Only a matching, faster batch result is a speedup.
+export function benchmarkBatchMath(wasm: YSFlightCore, count = 10000, minMs = 50): BatchBenchmarkResult[] {
+  const a = randomFloats(count * 4);
+  const b = randomFloats(count * 4);
+  const vectors = randomFloats(count * 3);
+  const batch = new BatchMath(wasm);
+  const expected = new Float32Array(count * 4);
+  const actual = new Float32Array(count * 4);
+
+  const vector = (data: Float32Array, i: number) => new wasm.Vector3(data[i * 3], data[i * 3 + 1], data[i * 3 + 2]);
+  const quaternion = (data: Float32Array, i: number) =>
+    new wasm.Quaternion(data[i * 4 + 3], data[i * 4], data[i * 4 + 1], data[i * 4 + 2]);
+  const storeVector = (i: number, r: { x: number; y: number; z: number }) => {
+    expected[i * 3] = r.x; expected[i * 3 + 1] = r.y; expected[i * 3 + 2] = r.z;
+  };
+
+  const cases: { operation: string; width: number; perObject: (i: number) => void; batch: () => void }[] = [
+    {
+      operation: 'add',
+      width: 3,
+      perObject: i => {
+        const u = vector(a, i), v = vector(b, i), r = u.add(v);
+        storeVector(i, r);
+        u.delete(); v.delete(); r.delete();
+      },
+      batch: () => batch.add(a.subarray(0, count * 3), b.subarray(0, count * 3), actual.subarray(0, count * 3))
+    },
+    {
+      operation: 'cross',
+      width: 3,
+      perObject: i => {
+        const u = vector(a, i), v = vector(b, i), r = u.cross(v);
+        storeVector(i, r);
+        u.delete(); v.delete(); r.delete();
+      },
+      batch: () => batch.cross(a.subarray(0, count * 3), b.subarray(0, count * 3), actual.subarray(0, count * 3))
+    },
+    {
+      operation: 'normalize',
+      width: 3,
+      perObject: i => {
+        const u = vector(vectors, i), r = u.normalize();
+        storeVector(i, r);
+        u.delete(); r.delete();
+      },
+      batch: () => batch.normalize(vectors, actual.subarray(0, count * 3))
+    },
+    {
+      operation: 'quaternion multiply',
+      width: 4,
+      perObject: i => {
+        const p = quaternion(a, i), q = quaternion(b, i), r = p.multiply(q);
+        expected[i * 4] = r.x; expected[i * 4 + 1] = r.y; expected[i * 4 + 2] = r.z; expected[i * 4 + 3] = r.w;
+        p.delete(); q.delete(); r.delete();
+      },
+      batch: () => batch.multiplyQuaternions(a, b, actual)
+    },
+    {
+      operation: 'rotate vector',
+      width: 3,
+      perObject: i => {
+        const q = quaternion(a, i), u = vector(vectors, i), r = q.rotateVector(u);
+        storeVector(i, r);
+        q.delete(); u.delete(); r.delete();
+      },
+      batch: () => batch.rotate(a, vectors, actual.subarray(0, count * 3))
+    }
+  ];
+
+  const results = cases.map(({ operation, width, perObject, batch: runBatch }) => {
+    const perObjectMs = timeRepeated(() => {
+      for (let i = 0; i < count; i++) {
+        perObject(i);
+      }
+    }, minMs);
+    const batchMs = timeRepeated(runBatch, minMs);
+    const length = count * width;
+    let matches = true;
+    for (let i = 0; i < length && matches; i++) {
+      matches = Object.is(expected[i], actual[i]);
+    }
+    return { operation, count, perObjectMs, batchMs, matches };
+  });
+
+  batch.dispose();
+  return results;
+}
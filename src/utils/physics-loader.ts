@@ -0,0 +1,142 @@
+import { loadModuleScript } from './wasm-loader'
+
+// Slim physics-only module (ysflight-physics): FlightDynamics behind a C ABI, without embind.
+// Much smaller than the full module, so it is the one to load when only the flight model is
+// needed before the first frame. Aircraft come from compiled assets (see asset-loader.ts).
+
+// Exports of wasm/src/physics_api.h; handles and buffers are byte offsets into module memory
+export interface PhysicsModule {
+  HEAPU8: Uint8Array;
+  HEAPF32: Float32Array;
+  _malloc(size: number): number;
+  _free(ptr: number): void;
+  _ysf_create(): number;
+  _ysf_destroy(handle: number): void;
+  _ysf_load_asset(handle: number, data: number, length: number): number;
+  _ysf_initialize(handle: number, x: number, y: number, z: number, heading: number): void;
+  _ysf_set_throttle(handle: number, throttle: number): void;
+  _ysf_set_controls(handle: number, aileron: number, elevator: number, rudder: number): void;
+  _ysf_set_deterministic(handle: number, enabled: number): void;
+  _ysf_update(handle: number, deltaTime: number): void;
+  _ysf_reset(handle: number): void;
+  _ysf_get_state(handle: number, out: number): void;
+  _ysf_get_checksum(handle: number, out: number): void;
+}
+
+declare global {
+  interface Window {
+    YSFlightPhysics?: (options: object) => Promise<PhysicsModule>;
+  }
+}
+
+// Order of the YSF_STATE_* enum
+const STATE_FIELDS = [
+  'x', 'y', 'z', 'vx', 'vy', 'vz',
+  'heading', 'pitch', 'roll', 'headingRate', 'pitchRate', 'rollRate',
+  'throttle', 'thrust', 'aileron', 'elevator', 'rudder',
+  'mass', 'altitude', 'airspeed', 'fuel'
+] as const;
+
+export type PhysicsState = Record<typeof STATE_FIELDS[number], number>;
+
+export class PhysicsAircraft {
+  private module: PhysicsModule;
+  private handle: number;
+  private scratch: number;  // State floats, then checksum text
+
+  constructor(module: PhysicsModule) {
+    this.module = module;
+    this.handle = module._ysf_create();
+    this.scratch = module._malloc(STATE_FIELDS.length * 4 + 32);
+  }
+
+  // Aircraft properties from a compiled asset (compileAircraftDat); false if it is malformed
+  loadAsset(bytes: Uint8Array): boolean {
+    const ptr = this.module._malloc(bytes.length);
+    this.module.HEAPU8.set(bytes, ptr);
+    const ok = this.module._ysf_load_asset(this.handle, ptr, bytes.length) !== 0;
+    this.module._free(ptr);
+    return ok;
+  }
+
+  initialize(x: number, y: number, z: number, heading: number): void {
+    this.module._ysf_initialize(this.handle, x, y, z, heading);
+  }
+
+  setThrottle(throttle: number): void {
+    this.module._ysf_set_throttle(this.handle, throttle);
+  }
+
+  setControlSurfaces(aileron: number, elevator: number, rudder: number): void {
+    this.module._ysf_set_controls(this.handle, aileron, elevator, rudder);
+  }
+
+  setDeterministic(enabled: boolean): void {
+    this.module._ysf_set_deterministic(this.handle, enabled ? 1 : 0);
+  }
+
+  update(deltaTime: number): void {
+    this.module._ysf_update(this.handle, deltaTime);
+  }
+
+  reset(): void {
+    this.module._ysf_reset(this.handle);
+  }
+
+  getState(): PhysicsState {
+    this.module._ysf_get_state(this.handle, this.scratch);
+    const floats = this.module.HEAPF32;
+    const base = this.scratch >> 2;
+    const state = {} as PhysicsState;
+    STATE_FIELDS.forEach((field, i) => {
+      state[field] = floats[base + i];
+    });
+    return state;
+  }
+
+  // Same 16-digit hex as FlightSimulation.getChecksum() in the full module
+  getChecksum(): string {
+    const ptr = this.scratch + STATE_FIELDS.length * 4;
+    this.module._ysf_get_checksum(this.handle, ptr);
+    return new TextDecoder().decode(this.module.HEAPU8.subarray(ptr, ptr + 16));
+  }
+
+  dispose(): void {
+    this.module._ysf_destroy(this.handle);
+    this.module._free(this.scratch);
+    this.handle = 0;
+    this.scratch = 0;
+  }
+}
+
+let physicsModule: PhysicsModule | null = null;
+let physicsPromise: Promise<PhysicsModule> | null = null;
+
+export async function loadPhysicsModule(): Promise<PhysicsModule> {
+  if (physicsModule) {
+    return physicsModule;
+  }
+  if (physicsPromise) {
+    return physicsPromise;
+  }
+
+  physicsPromise = (async () => {
+    await loadModuleScript('/ysflight-physics.js');
+
+    if (!window.YSFlightPhysics) {
+      throw new Error('YSFlightPhysics not found after loading script');
+    }
+
+    const module = await window.YSFlightPhysics({
+      locateFile: (path: string) => path.endsWith('.wasm') ? '/ysflight-physics.wasm' : path
+    });
+    physicsModule = module;
+    return module;
+  })();
+
+  // Allow a retry after a failed download
+  physicsPromise.catch(() => {
+    physicsPromise = null;
+  });
+  return physicsPromise;
+}
@@ -0,0 +1,27 @@
+import { describe, it, expect } from 'vitest'
+import { selectWasmVariants, SIMD_PROBE, THREADS_PROBE } from './wasm-loader'
+
+describe('selectWasmVariants', () => {
+  it('should prefer the threaded SIMD build when both features are available', () => {
+    expect(selectWasmVariants({ simd: true, threads: true })).toEqual(['simd-mt', 'simd', 'baseline'])
+  })
+
+  it('should skip the threaded build without shared memory', () => {
+    expect(selectWasmVariants({ simd: true, threads: false })).toEqual(['simd', 'baseline'])
+  })
+
+  it('should fall back to the baseline without SIMD', () => {
+    expect(selectWasmVariants({ simd: false, threads: true })).toEqual(['baseline'])
+  })
+})
+
+describe('feature probes', () => {
+  // Node supports both features, so each probe must be a valid module
+  it('should validate the SIMD probe', () => {
+    expect(WebAssembly.validate(SIMD_PROBE)).toBe(true)
+  })
+
+  it('should validate the threads probe', () => {
+    expect(WebAssembly.validate(THREADS_PROBE)).toBe(true)
+  })
+})
@@ -1,4 +1,4 @@
-import type { YSFlightCore } from '@/types/wasm'
+import type { YSFlightCore, WasmVariant } from '@/types/wasm'
 
 // Declare the global YSFlightCore that will be loaded
 declare global {
@@ -10,6 +10,90 @@ declare global {
 let wasmModule: YSFlightCore | null = null;
 let initPromise: Promise<YSFlightCore> | null = null;
 
+// Smallest modules using each feature: a v128 result with i8x16.popcnt, and i32.atomic.load
+// (0xfe 0x10, align 2, offset 0) on a shared memory (limits flag 3, min 1, max 1)
+export const SIMD_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0,
+  10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+]);
+export const THREADS_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 4, 1, 96, 0, 0, 3, 2, 1, 0, 5, 4, 1, 3, 1, 1,
+  10, 11, 1, 9, 0, 65, 0, 254, 16, 2, 0, 26, 11
+]);
+
+export interface WasmFeatures {
+  simd: boolean;
+  threads: boolean;
+}
+
+export function detectWasmFeatures(): WasmFeatures {
+  const simd = WebAssembly.validate(SIMD_PROBE);
+  // Shared memory also needs a cross-origin isolated page (COOP/COEP headers)
+  const threads = typeof SharedArrayBuffer !== 'undefined' &&
+    globalThis.crossOriginIsolated === true &&
+    WebAssembly.validate(THREADS_PROBE);
+  return { simd, threads };
+}
+
+// Variants the browser can run, best first; the baseline always comes last
+export function selectWasmVariants(features: WasmFeatures = detectWasmFeatures()): WasmVariant[] {
+  const variants: WasmVariant[] = [];
+  if (features.simd && features.threads) {
+    variants.push('simd-mt');
+  }
+  if (features.simd) {
+    variants.push('simd');
+  }
+  variants.push('baseline');
+  return variants;
+}
+
+function variantFile(variant: WasmVariant): string {
+  return variant === 'baseline' ? 'ysflight-core' : `ysflight-core-${variant}`;
+}
+
+// Adds an Emscripten loader script to the page and waits for it to run
+export function loadModuleScript(src: string): Promise<void> {
+  const script = document.createElement('script');
+  script.src = src;
+  return new Promise<void>((scriptResolve, scriptReject) => {
+    script.onload = () => scriptResolve();
+    script.onerror = () => {
+      script.remove();
+      scriptReject(new Error(`Failed to load WASM script ${src}`));
+    };
+    document.head.appendChild(script);
+  });
+}
+
+async function loadVariant(variant: WasmVariant): Promise<YSFlightCore> {
+  const file = variantFile(variant);
+  
+  // Load the script dynamically
+  await loadModuleScript(`/${file}.js`);
+  
+  // Check if YSFlightCore is available
+  if (!window.YSFlightCore) {
+    throw new Error('YSFlightCore not found after loading script');
+  }
+  
+  // Initialize the module
+  return window.YSFlightCore({
+    locateFile: (path: string) => {
+      if (path.endsWith('.wasm')) {
+        return `/${file}.wasm`;
+      }
+      if (path.endsWith('.worker.js')) {
+        return `/${path}`;
+      }
+      return path;
+    },
+    onRuntimeInitialized: () => {
+      console.log(`WASM Runtime initialized successfully (${variant})`);
+    }
+  });
+}
+
 export async function loadWasmModule(): Promise<YSFlightCore> {
   // Return existing module if already loaded
   if (wasmModule) {
@@ -23,42 +107,20 @@ export async function loadWasmModule(): Promise<YSFlightCore> {
   
   // Start initialization
   initPromise = (async () => {
-    try {
-      // Load the script dynamically
-      const script = document.createElement('script');
-      script.src = '/ysflight-core.js';
-      
-      // Wait for script to load
-      await new Promise<void>((scriptResolve, scriptReject) => {
-        script.onload = () => scriptResolve();
-        script.onerror = () => scriptReject(new Error('Failed to load WASM script'));
-        document.head.appendChild(script);
-      });
-      
-      // Check if YSFlightCore is available
-      if (!window.YSFlightCore) {
-        throw new Error('YSFlightCore not found after loading script');
+    // Fall back to the next variant when one is missing or fails to start
+    let lastError: unknown = null;
+    for (const variant of selectWasmVariants()) {
+      try {
+        const module = await loadVariant(variant);
+        wasmModule = module;
+        return module;
+      } catch (error) {
+        console.warn(`WASM variant ${variant} failed to load:`, error);
+        lastError = error;
       }
-      
-      // Initialize the module
-      const module = await window.YSFlightCore({
-        locateFile: (path: string) => {
-          if (path.endsWith('.wasm')) {
-            return '/ysflight-core.wasm';
-          }
-          return path;
-        },
-        onRuntimeInitialized: () => {
-          console.log('WASM Runtime initialized successfully');
-        }
-      });
-      
-      wasmModule = module;
-      return module;
-    } catch (error) {
-      console.error('Failed to load WASM module:', error);
-      throw error;
     }
+    console.error('Failed to load WASM module:', lastError);
+    throw lastError;
   })();
   
   return initPromise;
@@ -0,0 +1,5 @@
+# Prints the size of a build output: cmake -DFILE=<path> -P report_size.cmake
+file(SIZE ${FILE} BYTES)
+math(EXPR KB "(${BYTES} + 512) / 1024")
+get_filename_component(NAME ${FILE} NAME)
+message(STATUS "${NAME}: ${KB} KB (${BYTES} bytes)")
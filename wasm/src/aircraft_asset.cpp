@@ -0,0 +1,80 @@
+#include "aircraft_asset.h"
+#include <cstring>
+#include <string>
+
+namespace {
+
+const uint32_t kAssetMagic = 0x41465359; // "YSFA"
+const uint32_t kAssetVersion = 1;
+
+// Serialized order; append new fields at the end and bump the version
+float AircraftProperties::* const kFloatFields[] = {
+    &AircraftProperties::emptyMass,
+    &AircraftProperties::maxFuel,
+    &AircraftProperties::wingArea,
+    &AircraftProperties::wingSpan,
+    &AircraftProperties::maxThrust,
+    &AircraftProperties::thrustSFC,
+    &AircraftProperties::Cl0,
+    &AircraftProperties::ClAlpha,
+    &AircraftProperties::Cd0,
+    &AircraftProperties::K,
+    &AircraftProperties::ClMax,
+    &AircraftProperties::aileronEffect,
+    &AircraftProperties::elevatorEffect,
+    &AircraftProperties::rudderEffect,
+    &AircraftProperties::thrustMilitary,
+    &AircraftProperties::criticalAOAPositive,
+    &AircraftProperties::criticalAOANegative,
+    &AircraftProperties::minManeuverableSpeed,
+    &AircraftProperties::maxSpeed,
+    &AircraftProperties::outsideRadius,
+};
+const size_t kFloatFieldCount = sizeof(kFloatFields) / sizeof(kFloatFields[0]);
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 24));
+}
+
+uint32_t readU32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+} // namespace
+
+void serializeAircraftProperties(const AircraftProperties& props, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(12 + props.name.size() + kFloatFieldCount * 4);
+    putU32(out, kAssetMagic);
+    putU32(out, kAssetVersion);
+    putU32(out, static_cast<uint32_t>(props.name.size()));
+    out.insert(out.end(), props.name.begin(), props.name.end());
+    for (size_t i = 0; i < kFloatFieldCount; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, &(props.*kFloatFields[i]), sizeof(bits));
+        putU32(out, bits);
+    }
+}
+
+bool deserializeAircraftProperties(const uint8_t* data, size_t size, AircraftProperties& props) {
+    if (size < 12 || readU32(data) != kAssetMagic || readU32(data + 4) != kAssetVersion) {
+        return false;
+    }
+    const size_t nameLength = readU32(data + 8);
+    if (size - 12 < nameLength || size - 12 - nameLength != kFloatFieldCount * 4) {
+        return false;
+    }
+
+    const uint8_t* in = data + 12;
+    props.name.assign(reinterpret_cast<const char*>(in), nameLength);
+    in += nameLength;
+    for (size_t i = 0; i < kFloatFieldCount; ++i, in += 4) {
+        const uint32_t bits = readU32(in);
+        std::memcpy(&(props.*kFloatFields[i]), &bits, sizeof(bits));
+    }
+    return true;
+}
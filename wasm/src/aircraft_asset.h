@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "simulation.h"
+
+// Compiled aircraft asset: AircraftProperties in a flat little-endian form, so a module can
+// load an aircraft without the DAT parser. Layout: magic "YSFA", version, name length, name
+// bytes, then every float property in a fixed order.
+void serializeAircraftProperties(const AircraftProperties& props, std::vector<uint8_t>& out);
+
+// False on malformed input or a different version; props is unchanged then
+bool deserializeAircraftProperties(const uint8_t* data, size_t size, AircraftProperties& props);
@@ -0,0 +1,67 @@
+#include <emscripten/bind.h>
+#include <sstream>
+#include "dat_loader.h"
+#include "energy_maneuverability.h"
+
+using namespace emscripten;
+
+// Energy-maneuverability diagram for one aircraft type
+class EnergyDiagramWrapper {
+private:
+    EnergyManeuverabilityDiagram diagram;
+    
+public:
+    EnergyDiagramWrapper() {}
+    
+    // Returns false if the DAT text is invalid, a Mach bound is not positive, an altitude is
+    // negative or a range is reversed
+    bool compute(const std::string& datText,
+                 float minMach, float maxMach, int machSteps,
+                 float minAltitude, float maxAltitude, int altitudeSteps) {
+        AircraftProperties props;
+        if (!parseAircraftDat(datText, props)) {
+            return false;
+        }
+        EnergyGridSpec spec;
+        spec.minMach = minMach;
+        spec.maxMach = maxMach;
+        spec.machSteps = machSteps;
+        spec.minAltitude = minAltitude;
+        spec.maxAltitude = maxAltitude;
+        spec.altitudeSteps = altitudeSteps;
+        return diagram.compute(props, spec);
+    }
+    
+    // Float32Array view of [altitude][mach][channel]; valid until the next compute()
+    val getData() const {
+        const std::vector<float>& data = diagram.getData();
+        return val(typed_memory_view(data.size(), data.data()));
+    }
+    
+    int getChannelCount() const { return EM_CHANNEL_COUNT; }
+    int getMachCount() const { return static_cast<int>(diagram.getMachs().size()); }
+    int getAltitudeCount() const { return static_cast<int>(diagram.getAltitudes().size()); }
+    
+    std::string toCsv() const {
+        std::ostringstream out;
+        diagram.writeCsv(out);
+        return out.str();
+    }
+};
+
+EMSCRIPTEN_BINDINGS(analysis_bindings) {
+    constant("EM_SPECIFIC_EXCESS_POWER", static_cast<int>(EM_SPECIFIC_EXCESS_POWER));
+    constant("EM_SUSTAINED_TURN_RATE", static_cast<int>(EM_SUSTAINED_TURN_RATE));
+    constant("EM_INSTANTANEOUS_TURN_RATE", static_cast<int>(EM_INSTANTANEOUS_TURN_RATE));
+    constant("EM_SUSTAINED_LOAD_FACTOR", static_cast<int>(EM_SUSTAINED_LOAD_FACTOR));
+    constant("EM_INSTANTANEOUS_LOAD_FACTOR", static_cast<int>(EM_INSTANTANEOUS_LOAD_FACTOR));
+    
+    class_<EnergyDiagramWrapper>("EnergyDiagram")
+        .constructor<>()
+        .function("compute", &EnergyDiagramWrapper::compute)
+        .function("getData", &EnergyDiagramWrapper::getData)
+        .function("getChannelCount", &EnergyDiagramWrapper::getChannelCount)
+        .function("getMachCount", &EnergyDiagramWrapper::getMachCount)
+        .function("getAltitudeCount", &EnergyDiagramWrapper::getAltitudeCount)
+        .function("toCsv", &EnergyDiagramWrapper::toCsv);
+}
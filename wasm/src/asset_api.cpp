@@ -0,0 +1,25 @@
+#include "asset_api.h"
+#include <string>
+#include <vector>
+#include "aircraft_asset.h"
+#include "dat_loader.h"
+
+namespace {
+
+std::vector<uint8_t> compiled;
+
+} // namespace
+
+size_t ysf_compile_dat(const char* text, size_t length) {
+    AircraftProperties props;
+    if (!parseAircraftDat(std::string(text, length), props)) {
+        compiled.clear();
+        return 0;
+    }
+    serializeAircraftProperties(props, compiled);
+    return compiled.size();
+}
+
+const uint8_t* ysf_asset_data(void) {
+    return compiled.data();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// C interface of the asset module (ysflight-assets), loaded lazily on the first asset load.
+// It shares no memory with the physics module: results stay in this module until the next
+// call, and JavaScript copies the bytes across (see aircraft_asset.h for the format).
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef YSF_API
+#ifdef __EMSCRIPTEN__
+#include <emscripten/em_macros.h>
+#define YSF_API EMSCRIPTEN_KEEPALIVE
+#else
+#define YSF_API
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Compiles DAT text (not null-terminated) into an aircraft asset; returns its size, or 0 if
+// the DAT is invalid. The bytes are at ysf_asset_data() until the next compile.
+YSF_API size_t ysf_compile_dat(const char* text, size_t length);
+YSF_API const uint8_t* ysf_asset_data(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,210 @@
+#include "autopilot.h"
+#include <algorithm>
+#include "deterministic_math.h"
+
+float stepPID(const PIDGains& gains, PIDState& pid, float error, float deltaTime) {
+    float derivative = 0.0f;
+    if (pid.primed && deltaTime > 0) {
+        derivative = (error - pid.previousError) / deltaTime;
+    }
+    pid.previousError = error;
+    pid.primed = true;
+
+    float integral = pid.integral + error * deltaTime;
+    float output = gains.kp * error + gains.ki * integral + gains.kd * derivative;
+
+    // Anti-windup: stop integrating while the output is saturated in the error's direction
+    if (output > gains.outputMax) {
+        output = gains.outputMax;
+        if (error < 0) pid.integral = integral;
+    } else if (output < gains.outputMin) {
+        output = gains.outputMin;
+        if (error > 0) pid.integral = integral;
+    } else {
+        pid.integral = integral;
+    }
+
+    return output;
+}
+
+AutopilotGains::AutopilotGains()
+    : altitudeToClimbRate(0.1f, 0.0f, 0.0f, -20.0f, 20.0f),    // m -> m/s
+      climbRateToPitch(0.02f, 0.002f, 0.0f, -0.3f, 0.3f),      // m/s -> rad
+      pitchToElevator(10.0f, 0.0f, 60.0f, -1.0f, 1.0f),        // rad -> surface (damping dominates the slow pitch response)
+      headingToYawRate(0.1f, 0.0f, 0.0f, -0.1f, 0.1f),         // rad -> rad/s
+      yawRateToRudder(100.0f, 1.0f, 0.0f, -1.0f, 1.0f),        // rad/s -> surface
+      rollToAileron(3.0f, 0.2f, 0.5f, -1.0f, 1.0f),            // rad -> surface
+      speedToThrottle(0.05f, 0.01f, 0.0f, -1.0f, 1.0f),        // m/s -> throttle
+      waypointRadius(500.0f) {
+}
+
+AutopilotSystem::AutopilotSystem() {
+}
+
+void AutopilotSystem::resize(int count) {
+    modes.resize(count, AUTOPILOT_OFF);
+    targetAltitude.resize(count, 0.0f);
+    targetHeading.resize(count, 0.0f);
+    targetSpeed.resize(count, 0.0f);
+    throttleTrim.resize(count, 0.5f);
+
+    altitudeLoop.resize(count);
+    climbRateLoop.resize(count);
+    pitchLoop.resize(count);
+    headingLoop.resize(count);
+    yawRateLoop.resize(count);
+    rollLoop.resize(count);
+    speedLoop.resize(count);
+
+    routes.resize(count);
+    currentWaypoint.resize(count, 0);
+    loopRoute.resize(count, false);
+}
+
+void AutopilotSystem::resetLoops(int slot) {
+    altitudeLoop[slot] = PIDState();
+    climbRateLoop[slot] = PIDState();
+    pitchLoop[slot] = PIDState();
+    headingLoop[slot] = PIDState();
+    yawRateLoop[slot] = PIDState();
+    rollLoop[slot] = PIDState();
+    speedLoop[slot] = PIDState();
+}
+
+void AutopilotSystem::setMode(int slot, uint32_t mode) {
+    if (modes[slot] != mode) {
+        resetLoops(slot);
+    }
+    modes[slot] = mode;
+}
+
+void AutopilotSystem::setTargetAltitude(int slot, float altitude) {
+    targetAltitude[slot] = altitude;
+}
+
+void AutopilotSystem::setTargetHeading(int slot, float heading) {
+    if (!std::isfinite(heading)) {
+        return;
+    }
+    targetHeading[slot] = wrapAngle(heading);
+}
+
+void AutopilotSystem::setTargetSpeed(int slot, float speed) {
+    targetSpeed[slot] = std::max(0.0f, speed);
+}
+
+void AutopilotSystem::setThrottleTrim(int slot, float throttle) {
+    throttleTrim[slot] = std::max(0.0f, std::min(1.0f, throttle));
+}
+
+void AutopilotSystem::addWaypoint(int slot, const Waypoint& waypoint) {
+    routes[slot].push_back(waypoint);
+}
+
+void AutopilotSystem::clearWaypoints(int slot) {
+    routes[slot].clear();
+    currentWaypoint[slot] = 0;
+}
+
+void AutopilotSystem::setRouteLooping(int slot, bool loop) {
+    loopRoute[slot] = loop;
+}
+
+void AutopilotSystem::followRoute(int slot, const AircraftState& state) {
+    const std::vector<Waypoint>& route = routes[slot];
+    if (route.empty()) {
+        return;
+    }
+
+    int index = currentWaypoint[slot];
+    float dx = route[index].position.x - state.position.x;
+    float dz = route[index].position.z - state.position.z;
+
+    // Advance once inside the acceptance radius; hold the last point at the end of an open route
+    if (dx * dx + dz * dz < gains.waypointRadius * gains.waypointRadius) {
+        if (index + 1 < static_cast<int>(route.size())) {
+            index++;
+        } else if (loopRoute[slot]) {
+            index = 0;
+        }
+        currentWaypoint[slot] = index;
+        dx = route[index].position.x - state.position.x;
+        dz = route[index].position.z - state.position.z;
+    }
+
+    targetAltitude[slot] = route[index].position.y;
+    targetHeading[slot] = detmath::atan2(dz, dx);
+    if (route[index].speed > 0) {
+        targetSpeed[slot] = route[index].speed;
+    }
+}
+
+void AutopilotSystem::evaluateSlot(int slot, FlightDynamics& dynamics, float deltaTime) {
+    uint32_t mode = modes[slot];
+    if (mode == AUTOPILOT_OFF) {
+        return;
+    }
+
+    const AircraftState& state = dynamics.getState();
+
+    if (mode & AUTOPILOT_WAYPOINT) {
+        followRoute(slot, state);
+        mode |= AUTOPILOT_ALTITUDE | AUTOPILOT_HEADING | AUTOPILOT_SPEED;
+    }
+
+    // Axes without an engaged mode keep their current inputs
+    ControlInputs controls;
+    controls.throttle = state.throttle;
+    controls.aileron = state.aileron;
+    controls.elevator = state.elevator;
+    controls.rudder = state.rudder;
+
+    if (mode & AUTOPILOT_ALTITUDE) {
+        float climbRate = stepPID(gains.altitudeToClimbRate, altitudeLoop[slot],
+                                  targetAltitude[slot] - state.altitude, deltaTime);
+        float pitch = stepPID(gains.climbRateToPitch, climbRateLoop[slot],
+                              climbRate - state.velocity.y, deltaTime);
+        controls.elevator = stepPID(gains.pitchToElevator, pitchLoop[slot],
+                                    pitch - state.pitch, deltaTime);
+    }
+
+    if (mode & AUTOPILOT_HEADING) {
+        float yawRate = stepPID(gains.headingToYawRate, headingLoop[slot],
+                                wrapAngle(targetHeading[slot] - state.heading), deltaTime);
+        controls.rudder = stepPID(gains.yawRateToRudder, yawRateLoop[slot],
+                                  yawRate - state.headingRate, deltaTime);
+        controls.aileron = stepPID(gains.rollToAileron, rollLoop[slot],
+                                   -state.roll, deltaTime);
+    }
+
+    if (mode & AUTOPILOT_SPEED) {
+        controls.throttle = throttleTrim[slot] +
+            stepPID(gains.speedToThrottle, speedLoop[slot],
+                    targetSpeed[slot] - state.airspeed, deltaTime);
+    }
+
+    dynamics.setControls(controls);
+}
+
+void AutopilotSystem::evaluate(std::vector<FlightDynamics>& aircraft, float deltaTime) {
+    const int count = std::min(size(), static_cast<int>(aircraft.size()));
+    for (int i = 0; i < count; ++i) {
+        evaluateSlot(i, aircraft[i], deltaTime);
+    }
+}
+
+void AutopilotSystem::evaluate(std::vector<FlightDynamics>& aircraft, int begin, int end, float deltaTime) {
+    end = std::min(end, std::min(size(), static_cast<int>(aircraft.size())));
+    for (int i = std::max(0, begin); i < end; ++i) {
+        evaluateSlot(i, aircraft[i], deltaTime);
+    }
+}
+
+void AutopilotSystem::evaluate(std::vector<FlightDynamics>& aircraft, const std::vector<float>& deltaTimes) {
+    const int count = std::min(size(), static_cast<int>(std::min(aircraft.size(), deltaTimes.size())));
+    for (int i = 0; i < count; ++i) {
+        if (deltaTimes[i] > 0) {
+            evaluateSlot(i, aircraft[i], deltaTimes[i]);
+        }
+    }
+}
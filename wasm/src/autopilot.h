@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "simulation.h"
+
+// PID loop gains and output limits
+struct PIDGains {
+    float kp;
+    float ki;
+    float kd;
+    float outputMin;
+    float outputMax;
+
+    PIDGains() : kp(0), ki(0), kd(0), outputMin(-1.0f), outputMax(1.0f) {}
+    PIDGains(float p, float i, float d, float minOut, float maxOut)
+        : kp(p), ki(i), kd(d), outputMin(minOut), outputMax(maxOut) {}
+};
+
+// PID loop memory
+struct PIDState {
+    float integral;
+    float previousError;
+    bool primed;        // previousError is valid
+
+    PIDState() : integral(0), previousError(0), primed(false) {}
+};
+
+// Advance one PID loop and return its clamped output
+float stepPID(const PIDGains& gains, PIDState& pid, float error, float deltaTime);
+
+// Autopilot modes (combinable)
+enum AutopilotMode : uint32_t {
+    AUTOPILOT_OFF      = 0,
+    AUTOPILOT_ALTITUDE = 1u << 0,
+    AUTOPILOT_HEADING  = 1u << 1,
+    AUTOPILOT_SPEED    = 1u << 2,
+    AUTOPILOT_WAYPOINT = 1u << 3   // Drives altitude, heading and speed targets
+};
+
+// Route point for waypoint following
+struct Waypoint {
+    Vec3 position;  // meters
+    float speed;    // m/s
+
+    Waypoint() : speed(0) {}
+    Waypoint(const Vec3& position_, float speed_) : position(position_), speed(speed_) {}
+};
+
+// Gains shared by every controller
+struct AutopilotGains {
+    // Altitude cascade: altitude -> climb rate -> pitch -> elevator
+    PIDGains altitudeToClimbRate;
+    PIDGains climbRateToPitch;
+    PIDGains pitchToElevator;
+
+    // Heading cascade: heading -> yaw rate -> rudder
+    PIDGains headingToYawRate;
+    PIDGains yawRateToRudder;
+
+    // Wings-level hold
+    PIDGains rollToAileron;
+
+    // Speed hold (output is added to the throttle feed-forward)
+    PIDGains speedToThrottle;
+
+    float waypointRadius;   // Horizontal acceptance radius (m)
+
+    AutopilotGains();
+};
+
+// Batched autopilot: one controller slot per aircraft, evaluated in a single pass
+class AutopilotSystem {
+private:
+    AutopilotGains gains;
+
+    // Per-controller data (structure of arrays, indexed by aircraft slot)
+    std::vector<uint32_t> modes;
+    std::vector<float> targetAltitude;
+    std::vector<float> targetHeading;
+    std::vector<float> targetSpeed;
+    std::vector<float> throttleTrim;
+
+    std::vector<PIDState> altitudeLoop;
+    std::vector<PIDState> climbRateLoop;
+    std::vector<PIDState> pitchLoop;
+    std::vector<PIDState> headingLoop;
+    std::vector<PIDState> yawRateLoop;
+    std::vector<PIDState> rollLoop;
+    std::vector<PIDState> speedLoop;
+
+    std::vector<std::vector<Waypoint>> routes;
+    std::vector<int> currentWaypoint;
+    std::vector<bool> loopRoute;
+
+    void resetLoops(int slot);
+    void followRoute(int slot, const AircraftState& state);
+    void evaluateSlot(int slot, FlightDynamics& dynamics, float deltaTime);
+
+public:
+    AutopilotSystem();
+
+    // Controller slots mirror aircraft indices
+    void resize(int count);
+    int size() const { return static_cast<int>(modes.size()); }
+
+    void setGains(const AutopilotGains& newGains) { gains = newGains; }
+    const AutopilotGains& getGains() const { return gains; }
+
+    // Targets
+    void setMode(int slot, uint32_t mode);
+    uint32_t getMode(int slot) const { return modes[slot]; }
+    void setTargetAltitude(int slot, float altitude);
+    void setTargetHeading(int slot, float heading);
+    void setTargetSpeed(int slot, float speed);
+    void setThrottleTrim(int slot, float throttle);
+
+    // Waypoint route
+    void addWaypoint(int slot, const Waypoint& waypoint);
+    void clearWaypoints(int slot);
+    void setRouteLooping(int slot, bool loop);
+    int getCurrentWaypoint(int slot) const { return currentWaypoint[slot]; }
+
+    // Evaluate all engaged controllers and write their outputs into the aircraft controls
+    void evaluate(std::vector<FlightDynamics>& aircraft, float deltaTime);
+    // Slots [begin, end) only
+    void evaluate(std::vector<FlightDynamics>& aircraft, int begin, int end, float deltaTime);
+    // Per-aircraft steps; slots with a zero step are skipped this call
+    void evaluate(std::vector<FlightDynamics>& aircraft, const std::vector<float>& deltaTimes);
+};
@@ -1,10 +1,20 @@
 #include <emscripten.h>
 #include <emscripten/bind.h>
+#include <emscripten/stack.h>
 #include <emscripten/version.h>
 #include <string>
+#include "memory_arena.h"
+#include "memory_stats.h"
+#include "thread_pool.h"
+#include "vector_math.h"
 
 using namespace emscripten;
 
+// Set per build variant by CMakeLists.txt
+#ifndef YSFLIGHT_VARIANT
+#define YSFLIGHT_VARIANT "baseline"
+#endif
+
 // Version information
 std::string getVersion() {
     return "0.1.0";
@@ -14,7 +24,25 @@ std::string getBuildInfo() {
     return std::string("WebFlight WASM Core - Built with Emscripten ") + 
            std::to_string(__EMSCRIPTEN_major__) + "." +
            std::to_string(__EMSCRIPTEN_minor__) + "." +
-           std::to_string(__EMSCRIPTEN_tiny__);
+           std::to_string(__EMSCRIPTEN_tiny__) + " (" YSFLIGHT_VARIANT ")";
+}
+
+// Frame and load arena usage; high-water marks show what a session actually needs
+val getArenaStats() {
+    val arenas = val::array();
+    const MemoryArena* list[] = {&memory::frameArena(), &memory::loadArena()};
+    for (int i = 0; i < 2; ++i) {
+        const MemoryArena& arena = *list[i];
+        val stats = val::object();
+        stats.set("name", val(std::string(arena.getName())));
+        stats.set("used", val(static_cast<double>(arena.getUsed())));
+        stats.set("capacity", val(static_cast<double>(arena.getCapacity())));
+        stats.set("highWater", val(static_cast<double>(arena.getHighWater())));
+        stats.set("blocks", val(arena.getBlockCount()));
+        stats.set("blockAllocations", val(static_cast<double>(arena.getBlockAllocations())));
+        arenas.call<void>("push", stats);
+    }
+    return arenas;
 }
 
 // System information
@@ -22,8 +50,23 @@ val getSystemInfo() {
     val info = val::object();
     info.set("platform", val("web"));
     info.set("wasmSupported", val(true));
-    info.set("threadsSupported", val(false)); // Will be enabled later
-    info.set("simdSupported", val(false));    // Will be enabled later
+    info.set("variant", val(YSFLIGHT_VARIANT));
+#ifdef __EMSCRIPTEN_PTHREADS__
+    info.set("threadsSupported", val(true));
+#else
+    info.set("threadsSupported", val(false));
+#endif
+#ifdef __wasm_simd128__
+    info.set("simdSupported", val(true));
+#else
+    info.set("simdSupported", val(false));
+#endif
+    
+    // Implementations the hot paths compiled to in this variant
+    val kernels = val::object();
+    kernels.set("vectorMath", val(vmath::kBackend));
+    kernels.set("workerThreads", val(WorkStealingPool::hardwareThreads()));
+    info.set("kernels", kernels);
     
     // Memory info
     val memory = val::object();
@@ -32,7 +75,28 @@ val getSystemInfo() {
         return HEAP8.length;
     });
     memory.set("heapSize", val(heapSize));
-    memory.set("stackSize", val(65536)); // Default stack size
+    memory.set("stackSize", val(static_cast<double>(emscripten_stack_get_base() - emscripten_stack_get_end())));
+    
+    // Tracked C++ allocations (operator new), in bytes
+    memory.set("currentBytes", val(static_cast<double>(memory::getCurrentBytes())));
+    memory.set("peakBytes", val(static_cast<double>(memory::getPeakBytes())));
+    memory.set("allocations", val(static_cast<double>(memory::getAllocationCount())));
+    memory.set("lastFrameAllocations", val(static_cast<double>(memory::getLastFrameAllocations())));
+    memory.set("hotPathCheck", val(memory::getHotPathCheck()));
+    memory.set("hotPathAllocations", val(static_cast<double>(memory::getHotPathAllocations())));
+    
+    val tags = val::array();
+    for (int tag = 0; tag < MEM_TAG_COUNT; ++tag) {
+        MemoryTagStats stats = memory::getTagStats(tag);
+        val entry = val::object();
+        entry.set("name", val(std::string(memory::tagName(tag))));
+        entry.set("currentBytes", val(static_cast<double>(stats.currentBytes)));
+        entry.set("peakBytes", val(static_cast<double>(stats.peakBytes)));
+        entry.set("allocations", val(static_cast<double>(stats.allocations)));
+        tags.call<void>("push", entry);
+    }
+    memory.set("tags", tags);
+    memory.set("arenas", getArenaStats());
     info.set("memory", memory);
     
     return info;
@@ -43,4 +107,10 @@ EMSCRIPTEN_BINDINGS(ysflight_core) {
     function("getVersion", &getVersion);
     function("getBuildInfo", &getBuildInfo);
     function("getSystemInfo", &getSystemInfo);
+    function("getArenaStats", &getArenaStats);
+    // Debug mode: count and log allocations made while stepping the simulation
+    function("setAllocationCheck", &memory::setHotPathCheck);
+    function("resetMemoryPeaks", &memory::resetPeaks);
+    // Frame boundary for the arena and lastFrameAllocations; call once per animation frame
+    function("beginFrame", &memory::beginFrame);
 }
\ No newline at end of file
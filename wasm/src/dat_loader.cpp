@@ -0,0 +1,187 @@
+#include "dat_loader.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "memory_stats.h"
+
+namespace {
+
+const float kGravity = 9.80665f;       // kgf -> N
+const float kSpeedOfSound = 340.29f;   // m/s at sea level, for MACH values
+
+// Split a value like "12.0t" into number and lower-case unit suffix
+float parseValue(const std::string& token, std::string& unit) {
+    const char* begin = token.c_str();
+    char* end = nullptr;
+    float value = std::strtof(begin, &end);
+    unit.clear();
+    for (const char* c = end; *c; ++c) {
+        unit.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(*c))));
+    }
+    return value;
+}
+
+float parseWeight(const std::string& token) {
+    std::string unit;
+    float value = parseValue(token, unit);
+    if (unit == "t") return value * 1000.0f;
+    if (unit == "lb") return value * 0.453592f;
+    return value; // kg
+}
+
+// Thrust is given as mass-force (t / kg / lb)
+float parseThrust(const std::string& token) {
+    return parseWeight(token) * kGravity;
+}
+
+float parseAngle(const std::string& token) {
+    std::string unit;
+    float value = parseValue(token, unit);
+    if (unit == "rad") return value;
+    return value * static_cast<float>(M_PI) / 180.0f; // deg (default)
+}
+
+float parseSpeed(const std::string& token) {
+    std::string unit;
+    float value = parseValue(token, unit);
+    if (unit == "mach") return value * kSpeedOfSound;
+    if (unit == "kt") return value * 0.514444f;
+    if (unit == "km/h") return value / 3.6f;
+    if (unit == "mph") return value * 0.44704f;
+    return value; // m/s
+}
+
+float parseArea(const std::string& token) {
+    std::string unit;
+    float value = parseValue(token, unit);
+    if (unit == "ft^2") return value * 0.092903f;
+    return value; // m^2
+}
+
+float parseDistance(const std::string& token) {
+    std::string unit;
+    float value = parseValue(token, unit);
+    if (unit == "ft") return value * 0.3048f;
+    if (unit == "in") return value * 0.0254f;
+    return value; // m
+}
+
+} // namespace
+
+bool parseAircraftDat(const std::string& text, AircraftProperties& props) {
+    MemoryTagScope tag(MEM_ASSETS);
+    std::istringstream input(text);
+    std::string line;
+    bool hasAfterburner = true;
+    bool hasIdentify = false;
+    float afterburnerThrust = -1.0f;
+    float militaryFuelFlow = -1.0f;
+    const float defaultAspectRatio = props.wingSpan * props.wingSpan / props.wingArea;
+
+    while (std::getline(input, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        
+        std::istringstream fields(line);
+        std::string command, value;
+        if (!(fields >> command >> value) || command == "REM") {
+            continue;
+        }
+        
+        if (command == "IDENTIFY") {
+            std::string rest;
+            std::getline(fields, rest);
+            std::string name = value + rest;
+            name.erase(std::remove(name.begin(), name.end(), '"'), name.end());
+            props.name = name;
+            hasIdentify = true;
+        } else if (command == "AFTBURNR") {
+            hasAfterburner = (value == "TRUE");
+        } else if (command == "THRAFTBN") {
+            afterburnerThrust = parseThrust(value);
+        } else if (command == "THRMILIT") {
+            props.thrustMilitary = parseThrust(value);
+        } else if (command == "WEIGHCLN") {
+            props.emptyMass = parseWeight(value);
+        } else if (command == "WEIGFUEL") {
+            props.maxFuel = parseWeight(value);
+        } else if (command == "FUELMILI") {
+            militaryFuelFlow = parseWeight(value); // per second
+        } else if (command == "WINGAREA") {
+            props.wingArea = parseArea(value);
+        } else if (command == "CRITAOAP") {
+            props.criticalAOAPositive = parseAngle(value);
+        } else if (command == "CRITAOAM") {
+            props.criticalAOANegative = parseAngle(value);
+        } else if (command == "MAXSPEED") {
+            props.maxSpeed = parseSpeed(value);
+        } else if (command == "MANESPD1") {
+            props.minManeuverableSpeed = parseSpeed(value);
+        } else if (command == "HTRADIUS") {
+            props.outsideRadius = parseDistance(value);
+        }
+    }
+
+    // Aircraft without afterburner use military power as maximum thrust
+    props.maxThrust = (hasAfterburner && afterburnerThrust > 0) ? afterburnerThrust : props.thrustMilitary;
+
+    if (militaryFuelFlow > 0 && props.thrustMilitary > 0) {
+        props.thrustSFC = militaryFuelFlow / props.thrustMilitary;
+    }
+
+    // DAT has no span; keep the default aspect ratio and rederive induced drag
+    props.wingSpan = std::sqrt(defaultAspectRatio * props.wingArea);
+    float AR = props.wingSpan * props.wingSpan / props.wingArea;
+    props.K = 1.0f / (3.14159f * 0.8f * AR); // Oswald efficiency = 0.8
+
+    return hasIdentify;
+}
+
+bool loadAircraftDat(const std::string& path, AircraftProperties& props) {
+    MemoryTagScope tag(MEM_ASSETS);
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return parseAircraftDat(buffer.str(), props);
+}
+
+std::vector<AircraftProperties> loadAircraftList(const std::string& listPath) {
+    MemoryTagScope tag(MEM_ASSETS);
+    std::vector<AircraftProperties> result;
+    std::ifstream list(listPath);
+    if (!list) {
+        return result;
+    }
+
+    // Entries look like "aircraft/f16.dat aircraft/f16.dnm ...", relative to the list's parent
+    std::string baseDir;
+    size_t slash = listPath.find_last_of('/');
+    if (slash != std::string::npos) {
+        size_t parent = listPath.find_last_of('/', slash == 0 ? 0 : slash - 1);
+        baseDir = (parent == std::string::npos) ? std::string() : listPath.substr(0, parent + 1);
+    }
+
+    std::string line;
+    while (std::getline(list, line)) {
+        std::istringstream fields(line);
+        std::string datPath;
+        if (!(fields >> datPath)) {
+            continue;
+        }
+        
+        AircraftProperties props;
+        if (loadAircraftDat(baseDir + datPath, props)) {
+            result.push_back(props);
+        }
+    }
+    
+    return result;
+}
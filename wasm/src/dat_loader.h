@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "simulation.h"
+
+// Parse YSFlight .dat text into aircraft properties (SI units).
+// Fields the DAT does not specify keep their current values.
+bool parseAircraftDat(const std::string& text, AircraftProperties& props);
+
+// Read and parse a .dat file
+bool loadAircraftDat(const std::string& path, AircraftProperties& props);
+
+// Read every .dat referenced by an aircraft.lst (paths relative to the list's parent directory)
+std::vector<AircraftProperties> loadAircraftList(const std::string& listPath);
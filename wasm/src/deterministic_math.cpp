@@ -0,0 +1,159 @@
+#include "deterministic_math.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// pi/2 split so that n * kPio2Hi is exact for |n| < 2^20
+const double kTwoOverPi = 6.36619772367581382433e-01;
+const double kPio2Hi = 1.57079632673412561417e+00;
+const double kPio2Lo = 6.07710050650619224932e-11;
+const double kPi = 3.14159265358979311600e+00;
+const double kPiOver2 = 1.57079632679489655800e+00;
+const double kPiOver4 = 7.85398163397448278999e-01;
+const double kTanPiOver8 = 4.14213562373095034e-01;
+
+const double kLog2e = 1.44269504088896338700e+00;
+const double kLn2Hi = 6.93147180369123816490e-01;
+const double kLn2Lo = 1.90821492927058770002e-10;
+
+// Taylor polynomials, accurate well beyond float precision on the reduced ranges
+double sinPoly(double r) {
+    double r2 = r * r;
+    double p = -7.64716373181981647590e-13;              // -1/15!
+    p = p * r2 + 1.60590438368216145994e-10;             //  1/13!
+    p = p * r2 - 2.50521083854417187751e-08;             // -1/11!
+    p = p * r2 + 2.75573192239858906526e-06;             //  1/9!
+    p = p * r2 - 1.98412698412698412526e-04;             // -1/7!
+    p = p * r2 + 8.33333333333333321769e-03;             //  1/5!
+    p = p * r2 - 1.66666666666666657415e-01;             // -1/3!
+    return r + r * r2 * p;
+}
+
+double cosPoly(double r) {
+    double r2 = r * r;
+    double p = 4.77947733238738529744e-14;               //  1/16!
+    p = p * r2 - 1.14707455977297247137e-11;             // -1/14!
+    p = p * r2 + 2.08767569878680989792e-09;             //  1/12!
+    p = p * r2 - 2.75573192239858906526e-07;             // -1/10!
+    p = p * r2 + 2.48015873015873015658e-05;             //  1/8!
+    p = p * r2 - 1.38888888888888894189e-03;             // -1/6!
+    p = p * r2 + 4.16666666666666643537e-02;             //  1/4!
+    p = p * r2 - 0.5;
+    return 1.0 + r2 * p;
+}
+
+// atan on |u| <= tan(pi/8)
+double atanPoly(double u) {
+    double u2 = u * u;
+    double p = -1.0 / 23.0;
+    for (int k = 10; k >= 0; --k) {
+        double term = 1.0 / (2 * k + 1);
+        p = p * u2 + ((k & 1) ? -term : term);
+    }
+    return u * p;
+}
+
+// atan on [0, 1]
+double atanUnit(double t) {
+    if (t > kTanPiOver8) {
+        return kPiOver4 + atanPoly((t - 1.0) / (t + 1.0));
+    }
+    return atanPoly(t);
+}
+
+} // namespace
+
+namespace detmath {
+
+void sincos(float x, float& sine, float& cosine) {
+    if (!std::isfinite(x)) {
+        sine = cosine = std::numeric_limits<float>::quiet_NaN();
+        return;
+    }
+
+    double xd = x;
+    double n = std::floor(xd * kTwoOverPi + 0.5);
+    double r = (xd - n * kPio2Hi) - n * kPio2Lo;
+    double s = sinPoly(r);
+    double c = cosPoly(r);
+
+    // Quadrant from n mod 4 in double, exact for any integral n, so the cast cannot overflow
+    switch (static_cast<int>(std::fmod(n, 4.0)) & 3) {
+        case 0: sine = static_cast<float>(s); cosine = static_cast<float>(c); break;
+        case 1: sine = static_cast<float>(c); cosine = static_cast<float>(-s); break;
+        case 2: sine = static_cast<float>(-s); cosine = static_cast<float>(-c); break;
+        default: sine = static_cast<float>(-c); cosine = static_cast<float>(s); break;
+    }
+}
+
+float sin(float x) {
+    float sine, cosine;
+    sincos(x, sine, cosine);
+    return sine;
+}
+
+float cos(float x) {
+    float sine, cosine;
+    sincos(x, sine, cosine);
+    return cosine;
+}
+
+float exp(float x) {
+    if (std::isnan(x)) {
+        return x;
+    }
+    if (x > 88.7228394f) {
+        return std::numeric_limits<float>::infinity();
+    }
+    if (x < -103.972084f) {
+        return 0.0f;
+    }
+
+    // exp(x) = 2^n * exp(r), |r| <= ln2 / 2
+    double xd = x;
+    double n = std::floor(xd * kLog2e + 0.5);
+    double r = (xd - n * kLn2Hi) - n * kLn2Lo;
+
+    double p = 2.08767569878680989792e-09;               // 1/12!
+    p = p * r + 2.50521083854417187751e-08;              // 1/11!
+    p = p * r + 2.75573192239858906526e-07;              // 1/10!
+    p = p * r + 2.75573192239858906526e-06;              // 1/9!
+    p = p * r + 2.48015873015873015658e-05;              // 1/8!
+    p = p * r + 1.98412698412698412526e-04;              // 1/7!
+    p = p * r + 1.38888888888888894189e-03;              // 1/6!
+    p = p * r + 8.33333333333333321769e-03;              // 1/5!
+    p = p * r + 4.16666666666666643537e-02;              // 1/4!
+    p = p * r + 1.66666666666666657415e-01;              // 1/3!
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    return static_cast<float>(std::ldexp(p, static_cast<int>(n)));
+}
+
+float atan2(float y, float x) {
+    if (std::isnan(x) || std::isnan(y)) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    double ax = std::fabs(static_cast<double>(x));
+    double ay = std::fabs(static_cast<double>(y));
+    double angle;
+    if (ay == 0.0) {
+        angle = 0.0;
+    } else if (std::isinf(ax) && std::isinf(ay)) {
+        angle = kPiOver4;
+    } else if (ay > ax) {
+        angle = kPiOver2 - atanUnit(ax / ay);
+    } else {
+        angle = atanUnit(ay / ax);
+    }
+
+    if (std::signbit(x)) {
+        angle = kPi - angle;
+    }
+    return static_cast<float>(std::signbit(y) ? -angle : angle);
+}
+
+} // namespace detmath
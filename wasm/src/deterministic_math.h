@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Portable transcendental functions with bit-identical results on every IEEE-754 target
+// (native and WASM). Argument reduction and polynomials use a fixed sequence of double
+// operations, and the result is rounded to float once. Build with -ffp-contract=off so the
+// compiler cannot fuse multiply-adds.
+namespace detmath {
+
+float sin(float x);
+float cos(float x);
+void sincos(float x, float& sine, float& cosine);
+float exp(float x);
+float atan2(float y, float x);
+
+// Order-dependent 64-bit hash of 32-bit words (FNV-1a on words)
+inline uint64_t hashWords(const uint32_t* words, int count, uint64_t seed) {
+    uint64_t hash = seed;
+    for (int i = 0; i < count; ++i) {
+        hash = (hash ^ words[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+const uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+} // namespace detmath
@@ -0,0 +1,129 @@
+#include "energy_maneuverability.h"
+#include <algorithm>
+#include <limits>
+#include "memory_arena.h"
+
+namespace {
+
+const float kGravity = 9.81f;
+
+// Highest lift coefficient the stall model allows (the peak sits just past 0.8 x critical AoA)
+float maxLiftCoefficient(const AircraftProperties& props) {
+    float best = 0.0f;
+    const int samples = 64;
+    for (int i = 0; i <= samples; ++i) {
+        float alpha = props.criticalAOAPositive * static_cast<float>(i) / samples;
+        best = std::max(best, props.liftCoefficient(alpha));
+    }
+    return best;
+}
+
+} // namespace
+
+float speedOfSound(float altitude) {
+    float temperature = 288.15f - 0.0065f * std::min(std::max(altitude, 0.0f), 11000.0f);
+    return std::sqrt(1.4f * 287.05f * temperature);
+}
+
+bool EnergyManeuverabilityDiagram::compute(const AircraftProperties& props, const EnergyGridSpec& gridSpec) {
+    if (!gridSpec.isValid()) {
+        machs.clear();
+        altitudes.clear();
+        data.clear();
+        return false;
+    }
+    spec = gridSpec;
+    spec.machSteps = std::max(1, spec.machSteps);
+    spec.altitudeSteps = std::max(1, spec.altitudeSteps);
+
+    const int machCount = spec.machSteps;
+    const int altitudeCount = spec.altitudeSteps;
+
+    machs.resize(machCount);
+    altitudes.resize(altitudeCount);
+    for (int i = 0; i < machCount; ++i) {
+        machs[i] = machCount > 1
+            ? spec.minMach + (spec.maxMach - spec.minMach) * i / (machCount - 1) : spec.minMach;
+    }
+    for (int i = 0; i < altitudeCount; ++i) {
+        altitudes[i] = altitudeCount > 1
+            ? spec.minAltitude + (spec.maxAltitude - spec.minAltitude) * i / (altitudeCount - 1) : spec.minAltitude;
+    }
+    data.assign(static_cast<size_t>(machCount) * altitudeCount * EM_CHANNEL_COUNT, 0.0f);
+
+    // Atmosphere comes from the dynamics model itself
+    FlightDynamics dynamics;
+    dynamics.setProperties(props);
+
+    const float weight = (props.emptyMass + props.maxFuel * spec.fuelFraction) * kGravity;
+    const float thrust = props.maxThrust * spec.throttle;
+    const float S = props.wingArea;
+    const float ClLimit = maxLiftCoefficient(props);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    // Structure-of-arrays scratch for one altitude row; the loops below are branch-free
+    // so the compiler can vectorize them across Mach numbers
+    MemoryArena& arena = memory::frameArena();
+    ArenaScope scratch(arena);
+    float* speed = arena.allocateArray<float>(machCount);
+    float* qS = arena.allocateArray<float>(machCount);
+    float* extraCd = arena.allocateArray<float>(machCount);
+
+    for (int a = 0; a < altitudeCount; ++a) {
+        const float rho = dynamics.getAirDensity(altitudes[a]);
+        const float soundSpeed = speedOfSound(altitudes[a]);
+        float* row = &data[static_cast<size_t>(a) * machCount * EM_CHANNEL_COUNT];
+
+        for (int m = 0; m < machCount; ++m) {
+            float V = machs[m] * soundSpeed;
+            speed[m] = V;
+            qS[m] = 0.5f * rho * V * V * S;
+            extraCd[m] = props.dragRiseCoefficient(V);
+        }
+
+        for (int m = 0; m < machCount; ++m) {
+            const float V = speed[m];
+            const float dynamicLift = qS[m];
+            const float parasiteCd = props.Cd0 + extraCd[m];
+
+            // Level 1 g flight
+            float ClLevel = weight / dynamicLift;
+            float dragLevel = dynamicLift * (parasiteCd + props.K * ClLevel * ClLevel);
+            float ps = (thrust - dragLevel) * V / weight;
+
+            // Instantaneous: maximum lift
+            float nInstant = dynamicLift * ClLimit / weight;
+
+            // Sustained: lift at which induced drag uses up the excess thrust
+            float ClThrust = std::sqrt(std::max(0.0f, (thrust / dynamicLift - parasiteCd) / props.K));
+            float nSustained = dynamicLift * std::min(ClThrust, ClLimit) / weight;
+
+            float turnInstant = kGravity * std::sqrt(std::max(0.0f, nInstant * nInstant - 1.0f)) / V;
+            float turnSustained = kGravity * std::sqrt(std::max(0.0f, nSustained * nSustained - 1.0f)) / V;
+
+            float* point = row + static_cast<size_t>(m) * EM_CHANNEL_COUNT;
+            point[EM_SPECIFIC_EXCESS_POWER] = ClLevel <= ClLimit ? ps : nan;
+            point[EM_SUSTAINED_TURN_RATE] = turnSustained;
+            point[EM_INSTANTANEOUS_TURN_RATE] = turnInstant;
+            point[EM_SUSTAINED_LOAD_FACTOR] = nSustained;
+            point[EM_INSTANTANEOUS_LOAD_FACTOR] = nInstant;
+        }
+    }
+    return true;
+}
+
+void EnergyManeuverabilityDiagram::writeCsv(std::ostream& out) const {
+    const float radToDeg = 180.0f / static_cast<float>(M_PI);
+    out << "altitude_m,mach,ps_mps,sustained_turn_dps,instantaneous_turn_dps,sustained_g,instantaneous_g\n";
+    for (size_t a = 0; a < altitudes.size(); ++a) {
+        for (size_t m = 0; m < machs.size(); ++m) {
+            int ai = static_cast<int>(a), mi = static_cast<int>(m);
+            out << altitudes[a] << ',' << machs[m] << ','
+                << at(ai, mi, EM_SPECIFIC_EXCESS_POWER) << ','
+                << at(ai, mi, EM_SUSTAINED_TURN_RATE) * radToDeg << ','
+                << at(ai, mi, EM_INSTANTANEOUS_TURN_RATE) * radToDeg << ','
+                << at(ai, mi, EM_SUSTAINED_LOAD_FACTOR) << ','
+                << at(ai, mi, EM_INSTANTANEOUS_LOAD_FACTOR) << '\n';
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cmath>
+#include <ostream>
+#include <vector>
+#include "simulation.h"
+
+// Values stored per grid point
+enum EnergyChannel {
+    EM_SPECIFIC_EXCESS_POWER = 0,    // Ps at 1 g (m/s)
+    EM_SUSTAINED_TURN_RATE,          // rad/s, thrust = drag
+    EM_INSTANTANEOUS_TURN_RATE,      // rad/s, at maximum lift
+    EM_SUSTAINED_LOAD_FACTOR,        // g
+    EM_INSTANTANEOUS_LOAD_FACTOR,    // g
+    EM_CHANNEL_COUNT
+};
+
+struct EnergyGridSpec {
+    float minMach;
+    float maxMach;
+    int machSteps;
+    float minAltitude;      // m
+    float maxAltitude;      // m
+    int altitudeSteps;
+    float throttle;         // Fraction of maximum thrust
+    float fuelFraction;     // Fuel load used for the weight
+
+    EnergyGridSpec()
+        : minMach(0.1f), maxMach(2.0f), machSteps(96),
+          minAltitude(0.0f), maxAltitude(15000.0f), altitudeSteps(64),
+          throttle(1.0f), fuelFraction(0.5f) {}
+
+    // Mach bounds must be positive (zero airspeed has no lift) and altitudes non-negative,
+    // all finite and in ascending order
+    bool isValid() const {
+        return std::isfinite(minMach) && std::isfinite(maxMach) && minMach > 0 && maxMach >= minMach &&
+               std::isfinite(minAltitude) && std::isfinite(maxAltitude) &&
+               minAltitude >= 0 && maxAltitude >= minAltitude;
+    }
+};
+
+// Energy-maneuverability diagram over a Mach x altitude grid, evaluated from the
+// FlightDynamics force model. Points the aircraft cannot hold in level flight have Ps = NaN.
+class EnergyManeuverabilityDiagram {
+private:
+    EnergyGridSpec spec;
+    std::vector<float> machs;
+    std::vector<float> altitudes;
+    std::vector<float> data;    // [altitude][mach][channel]
+
+public:
+    EnergyManeuverabilityDiagram() {}
+
+    // Returns false, leaving the diagram empty, if the grid spec is invalid
+    bool compute(const AircraftProperties& props, const EnergyGridSpec& gridSpec);
+
+    const EnergyGridSpec& getSpec() const { return spec; }
+    const std::vector<float>& getMachs() const { return machs; }
+    const std::vector<float>& getAltitudes() const { return altitudes; }
+    const std::vector<float>& getData() const { return data; }
+
+    float at(int altitudeIndex, int machIndex, EnergyChannel channel) const {
+        return data[(static_cast<size_t>(altitudeIndex) * machs.size() + machIndex) * EM_CHANNEL_COUNT + channel];
+    }
+
+    // One row per grid point; turn rates in deg/s
+    void writeCsv(std::ostream& out) const;
+};
+
+// ISA speed of sound (troposphere lapse, isothermal above 11 km)
+float speedOfSound(float altitude);
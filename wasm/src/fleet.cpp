@@ -0,0 +1,176 @@
+#include "fleet.h"
+#include <algorithm>
+#include <limits>
+#include "deterministic_math.h"
+#include "memory_stats.h"
+
+AircraftFleet::AircraftFleet()
+    : time(0), tickCount(0), pointMassInterval(4), deterministic(false), separateFuel(false),
+      checksum(detmath::kHashSeed) {
+}
+
+int AircraftFleet::addAircraft(const Vec3& position, float heading) {
+    MemoryTagScope tag(MEM_PHYSICS);
+    aircraft.emplace_back();
+    aircraft.back().setDeterministic(deterministic);
+    aircraft.back().setSeparateFuelUpdate(separateFuel);
+    aircraft.back().initialize(position, heading);
+    lods.push_back(PHYSICS_FULL);
+    autopilot.resize(size());
+    return size() - 1;
+}
+
+int AircraftFleet::addTrimmedAircraft(std::shared_ptr<const AircraftProperties> properties,
+                                      const Vec3& position, float heading, float speed,
+                                      const TrimResult& trim) {
+    MemoryTagScope tag(MEM_PHYSICS);
+    aircraft.emplace_back();
+    aircraft.back().setDeterministic(deterministic);
+    aircraft.back().setSeparateFuelUpdate(separateFuel);
+    aircraft.back().setProperties(std::move(properties));
+    applyTrim(aircraft.back(), position, heading, speed, trim);
+    lods.push_back(PHYSICS_FULL);
+    autopilot.resize(size());
+    autopilot.setThrottleTrim(size() - 1, trim.throttle);
+    return size() - 1;
+}
+
+void AircraftFleet::clear() {
+    aircraft.clear();
+    lods.clear();
+    autopilot.resize(0);
+    time = 0;
+    tickCount = 0;
+    checksum = detmath::kHashSeed;
+}
+
+void AircraftFleet::setSeparateFuelUpdate(bool enabled) {
+    separateFuel = enabled;
+    for (FlightDynamics& dynamics : aircraft) {
+        dynamics.setSeparateFuelUpdate(enabled);
+    }
+}
+
+void AircraftFleet::updateAutopilot(int begin, int end, float deltaTime) {
+    MemoryTagScope tag(MEM_PHYSICS);
+    autopilot.evaluate(aircraft, begin, end, deltaTime);
+}
+
+void AircraftFleet::updatePhysics(int begin, int end, float deltaTime) {
+    MemoryTagScope tag(MEM_PHYSICS);
+    end = std::min(end, size());
+    for (int i = std::max(0, begin); i < end; ++i) {
+        if (lods[i] == PHYSICS_FULL) {
+            aircraft[i].update(deltaTime);
+        } else {
+            aircraft[i].updatePointMass(deltaTime);
+        }
+    }
+}
+
+void AircraftFleet::updateFuel(int begin, int end, float deltaTime) {
+    MemoryTagScope tag(MEM_PHYSICS);
+    end = std::min(end, size());
+    for (int i = std::max(0, begin); i < end; ++i) {
+        aircraft[i].updateFuel(deltaTime);
+    }
+}
+
+void AircraftFleet::setDeterministic(bool enabled) {
+    deterministic = enabled;
+    for (FlightDynamics& dynamics : aircraft) {
+        dynamics.setDeterministic(enabled);
+    }
+}
+
+int AircraftFleet::getPointMassCount() const {
+    int count = 0;
+    for (uint8_t lod : lods) {
+        count += lod == PHYSICS_POINT_MASS ? 1 : 0;
+    }
+    return count;
+}
+
+void AircraftFleet::selectPhysicsLod(const std::vector<Vec3>& focus, float fullRadius) {
+    const float promote = fullRadius * fullRadius;
+    const float demote = promote * 1.21f;   // (1.1 x fullRadius)^2
+    for (int i = 0; i < size(); ++i) {
+        const Vec3& position = aircraft[i].getState().position;
+        float nearest = std::numeric_limits<float>::max();
+        for (const Vec3& point : focus) {
+            nearest = std::min(nearest, (position - point).lengthSquared());
+        }
+        if (nearest <= promote) {
+            lods[i] = PHYSICS_FULL;
+        } else if (nearest > demote) {
+            lods[i] = PHYSICS_POINT_MASS;
+        }
+    }
+}
+
+void AircraftFleet::update(float deltaTime) {
+    MemoryTagScope tag(MEM_PHYSICS);
+    // Point-mass aircraft are controlled and pushed every pointMassInterval ticks over the
+    // whole interval, staggered by index to keep ticks even
+    const int count = size();
+    steps.resize(count);
+    for (int i = 0; i < count; ++i) {
+        if (lods[i] == PHYSICS_FULL) {
+            steps[i] = deltaTime;
+        } else {
+            steps[i] = (tickCount + i) % pointMassInterval == 0 ? deltaTime * pointMassInterval : 0.0f;
+        }
+    }
+    autopilot.evaluate(aircraft, steps);
+    
+    for (int i = 0; i < count; ++i) {
+        FlightDynamics& dynamics = aircraft[i];
+        if (lods[i] == PHYSICS_FULL) {
+            dynamics.update(deltaTime);
+            continue;
+        }
+        if (steps[i] > 0) {
+            dynamics.updatePointMassDynamics(steps[i]);
+        }
+        dynamics.advanceKinematics(deltaTime);
+    }
+    finishTick(deltaTime);
+}
+
+void AircraftFleet::finishTick(float deltaTime) {
+    time += deltaTime;
+    tickCount++;
+
+    if (deterministic) {
+        for (const FlightDynamics& dynamics : aircraft) {
+            checksum = dynamics.checksum(checksum);
+        }
+    }
+}
+
+bool scheduleFleet(MultiRateScheduler& scheduler, AircraftFleet& fleet, int playerCount, const FleetRates& rates) {
+    if (!scheduler.acceptsRate(rates.player) || !scheduler.acceptsRate(rates.ai) ||
+        !scheduler.acceptsRate(rates.autopilot) || !scheduler.acceptsRate(rates.fuel)) {
+        return false;
+    }
+    AircraftFleet* target = &fleet;
+    fleet.setSeparateFuelUpdate(true);
+
+    scheduler.addSlicedTask("autopilot", rates.autopilot,
+        [target]() { return target->size(); },
+        [target](int begin, int end, float deltaTime) { target->updateAutopilot(begin, end, deltaTime); });
+    scheduler.addSlicedTask("player physics", rates.player,
+        [target, playerCount]() { return std::min(playerCount, target->size()); },
+        [target](int begin, int end, float deltaTime) { target->updatePhysics(begin, end, deltaTime); });
+    scheduler.addSlicedTask("ai physics", rates.ai,
+        [target, playerCount]() { return std::max(0, target->size() - playerCount); },
+        [target, playerCount](int begin, int end, float deltaTime) {
+            target->updatePhysics(begin + playerCount, end + playerCount, deltaTime);
+        });
+    scheduler.addSlicedTask("fuel", rates.fuel,
+        [target]() { return target->size(); },
+        [target](int begin, int end, float deltaTime) { target->updateFuel(begin, end, deltaTime); });
+    scheduler.addTask("clock", scheduler.getTickRate(),
+        [target](float deltaTime) { target->finishTick(deltaTime); });
+    return true;
+}
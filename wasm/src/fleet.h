@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "autopilot.h"
+#include "scheduler.h"
+#include "simulation.h"
+#include "trim.h"
+
+// Physics level of detail of a fleet aircraft
+enum PhysicsLod : uint8_t {
+    PHYSICS_FULL = 0,           // 6-DOF FlightDynamics::update every tick
+    PHYSICS_POINT_MASS = 1      // 3-DOF point mass; forces every pointMassInterval ticks
+};
+
+// Batched store of simulated aircraft.
+// AI controllers for the whole fleet run in one pass before the physics step.
+class AircraftFleet {
+private:
+    std::vector<FlightDynamics> aircraft;
+    std::vector<uint8_t> lods;          // PhysicsLod per aircraft
+    std::vector<float> steps;           // Autopilot and force step per aircraft this tick
+    AutopilotSystem autopilot;
+    double time;            // Simulated seconds since creation or clear()
+    int64_t tickCount;
+    int pointMassInterval;
+    bool deterministic;
+    bool separateFuel;
+    uint64_t checksum;      // Rolling state hash, updated every tick in deterministic mode
+
+public:
+    AircraftFleet();
+
+    // Add an aircraft and return its index
+    int addAircraft(const Vec3& position, float heading);
+    // Add an aircraft of the given type already in trimmed level flight
+    int addTrimmedAircraft(std::shared_ptr<const AircraftProperties> properties, const Vec3& position,
+                           float heading, float speed, const TrimResult& trim);
+    void clear();
+    int size() const { return static_cast<int>(aircraft.size()); }
+
+    FlightDynamics& getAircraft(int index) { return aircraft[index]; }
+    const FlightDynamics& getAircraft(int index) const { return aircraft[index]; }
+
+    AutopilotSystem& getAutopilot() { return autopilot; }
+    const AutopilotSystem& getAutopilot() const { return autopilot; }
+
+    double getTime() const { return time; }
+    int64_t getTickCount() const { return tickCount; }
+    
+    // Both levels advance the same state, so switching never makes the aircraft jump
+    void setPhysicsLod(int index, PhysicsLod lod) { lods[index] = lod; }
+    PhysicsLod getPhysicsLod(int index) const { return static_cast<PhysicsLod>(lods[index]); }
+    int getPointMassCount() const;
+    // Full physics within fullRadius of any focus point (players), point mass beyond
+    // 1.1 x fullRadius; in between the current level is kept
+    void selectPhysicsLod(const std::vector<Vec3>& focus, float fullRadius);
+    // Ticks between point-mass force evaluations (position and attitude still move every tick)
+    void setPointMassInterval(int ticks) { pointMassInterval = ticks > 0 ? ticks : 1; }
+    int getPointMassInterval() const { return pointMassInterval; }
+
+    // Portable math for every aircraft (current and future) plus a per-tick rolling checksum
+    void setDeterministic(bool enabled);
+    bool isDeterministic() const { return deterministic; }
+    uint64_t getChecksum() const { return checksum; }
+
+    // Evaluate autopilots, then step every aircraft
+    void update(float deltaTime);
+    
+    // Parts of update() over aircraft [begin, end), for callers running each at its own rate
+    // (see MultiRateScheduler). Point-mass aircraft take their whole step in updatePhysics.
+    void updateAutopilot(int begin, int end, float deltaTime);
+    void updatePhysics(int begin, int end, float deltaTime);
+    // Only needed with separate fuel updates; otherwise updatePhysics burns fuel every step
+    void updateFuel(int begin, int end, float deltaTime);
+    void setSeparateFuelUpdate(bool enabled);
+    // End of a tick run through the parts above: advances time and the tick count and folds
+    // the checksum, as update() does
+    void finishTick(float deltaTime);
+};
+
+// Update rates for a fleet driven by a MultiRateScheduler
+struct FleetRates {
+    float player;       // Physics of player aircraft (Hz)
+    float ai;           // Physics of the others
+    float autopilot;
+    float fuel;         // Mass and fuel burn
+
+    FleetRates() : player(240.0f), ai(60.0f), autopilot(20.0f), fuel(1.0f) {}
+};
+
+// Register the fleet's autopilot, physics, fuel and clock as scheduler tasks, in that order.
+// The first playerCount aircraft are the players'. Fuel updates are switched to separate mode.
+// Returns false, registering nothing, if a rate is not one the scheduler can run.
+// The fleet must outlive the scheduler's use of the tasks.
+bool scheduleFleet(MultiRateScheduler& scheduler, AircraftFleet& fleet, int playerCount,
+                   const FleetRates& rates = FleetRates());
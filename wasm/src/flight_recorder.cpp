@@ -0,0 +1,576 @@
+#include "flight_recorder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "fleet.h"
+#include "memory_stats.h"
+
+namespace {
+
+const uint32_t kTrackMagic = 0x52465359; // "YSFR"
+const uint32_t kTrackVersion = 1;
+
+const uint32_t kKeyframeBytes = REC_FIELD_COUNT * 4;
+const uint32_t kMaxDeltaBytes = 3 + REC_FIELD_COUNT * 5; // Mask varint + worst-case residuals
+
+const double kTimeScale = 1e4;          // 0.1 ms
+const float kPositionScale = 100.0f;    // cm
+const float kVelocityScale = 100.0f;    // cm/s
+const float kAngleScale = 65536.0f / (2.0f * static_cast<float>(M_PI));
+const float kRateScale = 1e4f;
+const float kFuelScale = 100.0f;        // 10 g
+const float kControlScale = 1024.0f;
+const int32_t kControlBias = 1024;      // Keeps control values non-negative for XOR coding
+
+// Per-field coding parameters, table-driven so the residual loops stay branch-free.
+// Angles wrap at 16 bits (shift 16); control inputs are XOR-coded against the previous tick.
+const int kWrapShift[REC_FIELD_COUNT] = {
+    0, 0, 0, 0, 0, 0, 0, 16, 16, 16, 0, 0, 0, 0, 0, 0, 0, 0
+};
+const uint32_t kXorCoded[REC_FIELD_COUNT] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, ~0u, ~0u, ~0u, ~0u
+};
+
+int32_t wrapBits(uint32_t value, int shift) {
+    return static_cast<int32_t>(value << shift) >> shift;
+}
+
+int32_t wrapAngle16(int32_t value) {
+    return wrapBits(static_cast<uint32_t>(value), 16);
+}
+
+// Largest float below 2^31 that still leaves room for kControlBias
+const float kQuantizeLimit = 2147418112.0f;   // 2^31 - 2^16
+
+// Round half away from zero; avoids a libm call per field. A diverged aircraft records
+// NaN as 0 and out-of-range values clamped, so every platform writes the same stream.
+int32_t quantize(float value, float scale) {
+    float scaled = value * scale;
+    if (!std::isfinite(scaled)) {
+        return 0;
+    }
+    scaled = std::min(std::max(scaled + std::copysign(0.5f, scaled), -kQuantizeLimit), kQuantizeLimit);
+    return static_cast<int32_t>(scaled);
+}
+
+// Linear extrapolation for kinematic fields, previous value for controls
+// Widened so corrupted values cannot overflow
+float dequantizeControl(int32_t value) {
+    return static_cast<float>(static_cast<int64_t>(value) - kControlBias) / kControlScale;
+}
+
+int32_t predict(int field, const RecordedFrame& previous, const RecordedFrame& beforePrevious) {
+    uint32_t last = static_cast<uint32_t>(previous.values[field]);
+    uint32_t slope = (last - static_cast<uint32_t>(beforePrevious.values[field])) & ~kXorCoded[field];
+    return wrapBits(last + slope, kWrapShift[field]);
+}
+
+// Residual as an unsigned code (zigzag for deltas, raw bits for XOR)
+uint32_t encodeResidual(int field, int32_t value, int32_t predicted) {
+    int32_t delta = wrapBits(static_cast<uint32_t>(value) - static_cast<uint32_t>(predicted), kWrapShift[field]);
+    uint32_t zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+    uint32_t xorCode = static_cast<uint32_t>(value ^ predicted);
+    return (xorCode & kXorCoded[field]) | (zigzag & ~kXorCoded[field]);
+}
+
+int32_t decodeResidual(int field, uint32_t code, int32_t predicted) {
+    uint32_t delta = (code >> 1) ^ (~(code & 1) + 1);
+    uint32_t value = static_cast<uint32_t>(wrapBits(static_cast<uint32_t>(predicted) + delta, kWrapShift[field]));
+    uint32_t xorValue = code ^ static_cast<uint32_t>(predicted);
+    return static_cast<int32_t>((xorValue & kXorCoded[field]) | (value & ~kXorCoded[field]));
+}
+
+uint8_t* writeVarint(uint8_t* out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+// Null if the varint runs past end or is longer than five bytes
+const uint8_t* readVarint(const uint8_t* in, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (in == end) {
+            return nullptr;
+        }
+        uint8_t byte = *in++;
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return in;
+        }
+    }
+    return nullptr;
+}
+
+void writeU32(uint8_t* out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+uint32_t readU32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+// Append helpers for serialization
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    uint8_t bytes[4];
+    writeU32(bytes, value);
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+void putFloat(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU32(out, bits);
+}
+
+void putFrame(std::vector<uint8_t>& out, const RecordedFrame& frame) {
+    for (int i = 0; i < REC_FIELD_COUNT; ++i) {
+        putU32(out, static_cast<uint32_t>(frame.values[i]));
+    }
+}
+
+// Bounds-checked reader for deserialization
+struct ByteReader {
+    const uint8_t* data;
+    size_t size;
+    size_t position;
+
+    bool u32(uint32_t& value) {
+        if (size - position < 4) return false;
+        value = readU32(data + position);
+        position += 4;
+        return true;
+    }
+
+    bool f32(float& value) {
+        uint32_t bits;
+        if (!u32(bits)) return false;
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool frame(RecordedFrame& frame) {
+        for (int i = 0; i < REC_FIELD_COUNT; ++i) {
+            uint32_t value;
+            if (!u32(value)) return false;
+            frame.values[i] = static_cast<int32_t>(value);
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+void quantizeFrame(double time, const AircraftState& state, float fuel, RecordedFrame& frame) {
+    int32_t* v = frame.values;
+    double scaledTime = std::isfinite(time) ? std::min(std::max(time * kTimeScale, -1e18), 1e18) : 0.0;
+    v[REC_TIME] = static_cast<int32_t>(static_cast<int64_t>(scaledTime + std::copysign(0.5, scaledTime)));
+    v[REC_POSITION_X] = quantize(state.position.x, kPositionScale);
+    v[REC_POSITION_Y] = quantize(state.position.y, kPositionScale);
+    v[REC_POSITION_Z] = quantize(state.position.z, kPositionScale);
+    v[REC_VELOCITY_X] = quantize(state.velocity.x, kVelocityScale);
+    v[REC_VELOCITY_Y] = quantize(state.velocity.y, kVelocityScale);
+    v[REC_VELOCITY_Z] = quantize(state.velocity.z, kVelocityScale);
+    v[REC_HEADING] = wrapAngle16(quantize(state.heading, kAngleScale));
+    v[REC_PITCH] = wrapAngle16(quantize(state.pitch, kAngleScale));
+    v[REC_ROLL] = wrapAngle16(quantize(state.roll, kAngleScale));
+    v[REC_HEADING_RATE] = quantize(state.headingRate, kRateScale);
+    v[REC_PITCH_RATE] = quantize(state.pitchRate, kRateScale);
+    v[REC_ROLL_RATE] = quantize(state.rollRate, kRateScale);
+    v[REC_FUEL] = quantize(fuel, kFuelScale);
+    v[REC_THROTTLE] = quantize(state.throttle, kControlScale) + kControlBias;
+    v[REC_AILERON] = quantize(state.aileron, kControlScale) + kControlBias;
+    v[REC_ELEVATOR] = quantize(state.elevator, kControlScale) + kControlBias;
+    v[REC_RUDDER] = quantize(state.rudder, kControlScale) + kControlBias;
+}
+
+void dequantizeFrame(const RecordedFrame& frame, float maxThrust, float emptyMass, RecordedSample& sample) {
+    const int32_t* v = frame.values;
+    AircraftState& state = sample.state;
+
+    sample.time = recordedTime(v[REC_TIME]);
+    state.position = Vec3(v[REC_POSITION_X] / kPositionScale,
+                          v[REC_POSITION_Y] / kPositionScale,
+                          v[REC_POSITION_Z] / kPositionScale);
+    state.velocity = Vec3(v[REC_VELOCITY_X] / kVelocityScale,
+                          v[REC_VELOCITY_Y] / kVelocityScale,
+                          v[REC_VELOCITY_Z] / kVelocityScale);
+    state.heading = v[REC_HEADING] / kAngleScale;
+    state.pitch = v[REC_PITCH] / kAngleScale;
+    state.roll = v[REC_ROLL] / kAngleScale;
+    state.headingRate = v[REC_HEADING_RATE] / kRateScale;
+    state.pitchRate = v[REC_PITCH_RATE] / kRateScale;
+    state.rollRate = v[REC_ROLL_RATE] / kRateScale;
+    sample.fuel = v[REC_FUEL] / kFuelScale;
+    state.throttle = dequantizeControl(v[REC_THROTTLE]);
+    state.aileron = dequantizeControl(v[REC_AILERON]);
+    state.elevator = dequantizeControl(v[REC_ELEVATOR]);
+    state.rudder = dequantizeControl(v[REC_RUDDER]);
+
+    // Derived fields
+    state.thrust = state.throttle * maxThrust;
+    state.mass = emptyMass + sample.fuel;
+    state.altitude = state.position.y;
+    state.airspeed = state.velocity.length();
+}
+
+// RecordedTrack implementation
+RecordedTrack::RecordedTrack(const std::string& name, float maxThrust_, float emptyMass_,
+                             uint32_t keyframeInterval_)
+    : aircraftName(name), maxThrust(maxThrust_), emptyMass(emptyMass_),
+      keyframeInterval(std::max(1u, keyframeInterval_)), tickCount(0), allocatedBytes(0) {
+    std::memset(&previous, 0, sizeof(previous));
+    std::memset(&beforePrevious, 0, sizeof(beforePrevious));
+}
+
+bool RecordedTrack::wouldGrow() const {
+    uint32_t needed = (tickCount % keyframeInterval == 0) ? kKeyframeBytes : kMaxDeltaBytes;
+    return chunks.empty() || kChunkSize - chunkUsed.back() < needed;
+}
+
+uint8_t* RecordedTrack::reserve(uint32_t bytes) {
+    // Frames never straddle chunks
+    if (chunks.empty() || kChunkSize - chunkUsed.back() < bytes) {
+        chunks.emplace_back(new uint8_t[kChunkSize]);
+        chunkUsed.push_back(0);
+        allocatedBytes += kChunkSize;
+    }
+    return chunks.back().get() + chunkUsed.back();
+}
+
+void RecordedTrack::append(const RecordedFrame& frame) {
+    if (tickCount % keyframeInterval == 0) {
+        uint8_t* out = reserve(kKeyframeBytes);
+
+        Keyframe keyframe;
+        keyframe.tick = tickCount;
+        keyframe.time = frame.values[REC_TIME];
+        keyframe.chunk = static_cast<uint32_t>(chunks.size() - 1);
+        keyframe.offset = chunkUsed.back();
+        keyframes.push_back(keyframe);
+
+        for (int i = 0; i < REC_FIELD_COUNT; ++i) {
+            writeU32(out + i * 4, static_cast<uint32_t>(frame.values[i]));
+        }
+        chunkUsed.back() += kKeyframeBytes;
+
+        // Prediction restarts from the keyframe
+        beforePrevious = frame;
+    } else {
+        uint8_t* start = reserve(kMaxDeltaBytes);
+
+        uint32_t codes[REC_FIELD_COUNT];
+        uint32_t mask = 0;
+        for (int i = 0; i < REC_FIELD_COUNT; ++i) {
+            codes[i] = encodeResidual(i, frame.values[i], predict(i, previous, beforePrevious));
+            mask |= static_cast<uint32_t>(codes[i] != 0) << i;
+        }
+
+        uint8_t* out = writeVarint(start, mask);
+        for (int i = 0; i < REC_FIELD_COUNT; ++i) {
+            if (mask & (1u << i)) {
+                out = writeVarint(out, codes[i]);
+            }
+        }
+        chunkUsed.back() += static_cast<uint32_t>(out - start);
+
+        beforePrevious = previous;
+    }
+
+    previous = frame;
+    tickCount++;
+}
+
+size_t RecordedTrack::getEncodedBytes() const {
+    size_t total = 0;
+    for (uint32_t used : chunkUsed) {
+        total += used;
+    }
+    return total;
+}
+
+void RecordedTrack::serialize(std::vector<uint8_t>& out) const {
+    MemoryTagScope tag(MEM_RECORDER);
+    out.clear();
+    out.reserve(64 + aircraftName.size() + keyframes.size() * 16 + getEncodedBytes() + chunks.size() * 4);
+
+    putU32(out, kTrackMagic);
+    putU32(out, kTrackVersion);
+    putU32(out, static_cast<uint32_t>(aircraftName.size()));
+    out.insert(out.end(), aircraftName.begin(), aircraftName.end());
+    putFloat(out, maxThrust);
+    putFloat(out, emptyMass);
+    putU32(out, keyframeInterval);
+    putU32(out, tickCount);
+    putFrame(out, previous);
+    putFrame(out, beforePrevious);
+
+    putU32(out, static_cast<uint32_t>(keyframes.size()));
+    for (const Keyframe& keyframe : keyframes) {
+        putU32(out, keyframe.tick);
+        putU32(out, static_cast<uint32_t>(keyframe.time));
+        putU32(out, keyframe.chunk);
+        putU32(out, keyframe.offset);
+    }
+
+    putU32(out, static_cast<uint32_t>(chunks.size()));
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        putU32(out, chunkUsed[i]);
+        out.insert(out.end(), chunks[i].get(), chunks[i].get() + chunkUsed[i]);
+    }
+}
+
+std::unique_ptr<RecordedTrack> RecordedTrack::deserialize(const uint8_t* data, size_t size) {
+    MemoryTagScope tag(MEM_RECORDER);
+    ByteReader in = {data, size, 0};
+    uint32_t magic, version, nameLength;
+    if (!in.u32(magic) || magic != kTrackMagic || !in.u32(version) || version != kTrackVersion ||
+        !in.u32(nameLength) || size - in.position < nameLength) {
+        return nullptr;
+    }
+    std::string name(reinterpret_cast<const char*>(data + in.position), nameLength);
+    in.position += nameLength;
+
+    float maxThrust, emptyMass;
+    uint32_t interval, ticks;
+    if (!in.f32(maxThrust) || !in.f32(emptyMass) || !in.u32(interval) || interval == 0 || !in.u32(ticks)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<RecordedTrack> track(new RecordedTrack(name, maxThrust, emptyMass, interval));
+    track->tickCount = ticks;
+    if (!in.frame(track->previous) || !in.frame(track->beforePrevious)) {
+        return nullptr;
+    }
+
+    // One keyframe every interval ticks, starting at tick 0
+    uint32_t keyframeCount;
+    if (!in.u32(keyframeCount) || keyframeCount != (static_cast<uint64_t>(ticks) + interval - 1) / interval ||
+        (size - in.position) / 16 < keyframeCount) {
+        return nullptr;
+    }
+    track->keyframes.resize(keyframeCount);
+    for (uint32_t i = 0; i < keyframeCount; ++i) {
+        Keyframe& keyframe = track->keyframes[i];
+        uint32_t time;
+        in.u32(keyframe.tick);
+        in.u32(time);
+        in.u32(keyframe.chunk);
+        in.u32(keyframe.offset);
+        keyframe.time = static_cast<int32_t>(time);
+        if (keyframe.tick != static_cast<uint64_t>(i) * interval ||
+            (i > 0 && keyframe.time < track->keyframes[i - 1].time)) {
+            return nullptr;
+        }
+    }
+
+    // Every chunk carries at least its size and one byte, which bounds the allocations by the
+    // input size; only the last chunk gets full capacity so recording can continue
+    uint32_t chunkCount;
+    if (!in.u32(chunkCount) || (size - in.position) / 5 < chunkCount) {
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < chunkCount; ++i) {
+        uint32_t used;
+        if (!in.u32(used) || used == 0 || used > kChunkSize || size - in.position < used) {
+            return nullptr;
+        }
+        uint32_t capacity = i + 1 == chunkCount ? kChunkSize : used;
+        track->chunks.emplace_back(new uint8_t[capacity]);
+        track->chunkUsed.push_back(used);
+        track->allocatedBytes += capacity;
+        std::memcpy(track->chunks.back().get(), data + in.position, used);
+        in.position += used;
+    }
+    if (in.position != size) {
+        return nullptr;
+    }
+
+    // The data must decode to exactly tickCount frames, each keyframe where the sequential
+    // decode reaches it, with nothing left over
+    TrackDecoder decoder(*track);
+    RecordedFrame frame;
+    for (uint32_t tick = 0; tick < ticks; ++tick) {
+        const Keyframe* keyframe = tick % interval == 0 ? &track->keyframes[tick / interval] : nullptr;
+        if (keyframe && !decoder.isAt(keyframe->chunk, keyframe->offset)) {
+            return nullptr;
+        }
+        if (!decoder.next(frame) || (keyframe && frame.values[REC_TIME] != keyframe->time)) {
+            return nullptr;
+        }
+    }
+    // Recording continues from the stored prediction history, so it must be the one the
+    // stream itself ends with
+    if (!decoder.atEnd() ||
+        std::memcmp(&decoder.getPrevious(), &track->previous, sizeof(RecordedFrame)) != 0 ||
+        std::memcmp(&decoder.getBeforePrevious(), &track->beforePrevious, sizeof(RecordedFrame)) != 0) {
+        return nullptr;
+    }
+    return track;
+}
+
+std::unique_ptr<RecordedTrack> RecordedTrack::clone() const {
+    MemoryTagScope tag(MEM_RECORDER);
+    std::unique_ptr<RecordedTrack> track(new RecordedTrack(aircraftName, maxThrust, emptyMass, keyframeInterval));
+    track->tickCount = tickCount;
+    track->keyframes = keyframes;
+    track->chunkUsed = chunkUsed;
+    track->previous = previous;
+    track->beforePrevious = beforePrevious;
+
+    // Same layout as deserialize: used bytes only, full capacity for the last chunk
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        uint32_t capacity = i + 1 == chunks.size() ? kChunkSize : chunkUsed[i];
+        track->chunks.emplace_back(new uint8_t[capacity]);
+        track->allocatedBytes += capacity;
+        std::memcpy(track->chunks.back().get(), chunks[i].get(), chunkUsed[i]);
+    }
+    return track;
+}
+
+// TrackDecoder implementation
+TrackDecoder::TrackDecoder(const RecordedTrack& track_)
+    : track(&track_), tick(0), chunk(0), offset(0) {
+    std::memset(&previous, 0, sizeof(previous));
+    std::memset(&beforePrevious, 0, sizeof(beforePrevious));
+}
+
+void TrackDecoder::seekKeyframe(size_t keyframeIndex) {
+    if (keyframeIndex >= track->keyframes.size()) {
+        tick = track->tickCount;
+        return;
+    }
+    const RecordedTrack::Keyframe& keyframe = track->keyframes[keyframeIndex];
+    tick = keyframe.tick;
+    chunk = keyframe.chunk;
+    offset = keyframe.offset;
+}
+
+bool TrackDecoder::isAt(uint32_t chunk_, uint32_t offset_) const {
+    // A frame that ends a chunk leaves the position at its end; the next one starts the next chunk
+    if (chunk + 1 < track->chunks.size() && offset == track->chunkUsed[chunk]) {
+        return chunk_ == chunk + 1 && offset_ == 0;
+    }
+    return chunk_ == chunk && offset_ == offset;
+}
+
+bool TrackDecoder::atEnd() const {
+    if (track->chunks.empty()) {
+        return tick == 0;
+    }
+    return chunk + 1 == track->chunks.size() && offset == track->chunkUsed[chunk];
+}
+
+bool TrackDecoder::next(RecordedFrame& frame) {
+    if (tick >= track->tickCount || chunk >= track->chunks.size()) {
+        return false;
+    }
+    if (offset >= track->chunkUsed[chunk]) {
+        if (chunk + 1 >= track->chunks.size()) {
+            return fail();
+        }
+        chunk++;
+        offset = 0;
+    }
+
+    const uint8_t* start = track->chunks[chunk].get() + offset;
+    const uint8_t* end = track->chunks[chunk].get() + track->chunkUsed[chunk];
+    if (tick % track->keyframeInterval == 0) {
+        if (end - start < static_cast<ptrdiff_t>(kKeyframeBytes)) {
+            return fail();
+        }
+        for (int i = 0; i < REC_FIELD_COUNT; ++i) {
+            frame.values[i] = static_cast<int32_t>(readU32(start + i * 4));
+        }
+        offset += kKeyframeBytes;
+        beforePrevious = frame;
+    } else {
+        uint32_t mask;
+        const uint8_t* in = readVarint(start, end, mask);
+        if (!in || (mask >> REC_FIELD_COUNT) != 0) {
+            return fail();
+        }
+        for (int i = 0; i < REC_FIELD_COUNT; ++i) {
+            int32_t predicted = predict(i, previous, beforePrevious);
+            uint32_t code = 0;
+            if (mask & (1u << i)) {
+                in = readVarint(in, end, code);
+                if (!in) {
+                    return fail();
+                }
+            }
+            frame.values[i] = decodeResidual(i, code, predicted);
+        }
+        offset += static_cast<uint32_t>(in - start);
+        beforePrevious = previous;
+    }
+
+    previous = frame;
+    tick++;
+    return true;
+}
+
+bool TrackDecoder::fail() {
+    // Malformed data ends the track
+    tick = track->tickCount;
+    return false;
+}
+
+// FlightRecorder implementation
+FlightRecorder::FlightRecorder(uint32_t keyframeInterval_, size_t memoryBudget_)
+    : keyframeInterval(keyframeInterval_), memoryBudget(memoryBudget_),
+      allocatedBytes(0), full(false) {
+}
+
+void FlightRecorder::recordFleet(const AircraftFleet& fleet) {
+    for (int i = 0; i < fleet.size(); ++i) {
+        recordAircraft(i, fleet.getTime(), fleet.getAircraft(i));
+    }
+}
+
+bool FlightRecorder::recordAircraft(int trackIndex, double time, const FlightDynamics& dynamics) {
+    MemoryTagScope tag(MEM_RECORDER);
+    if (full || trackIndex < 0 || trackIndex > getTrackCount()) {
+        return false;
+    }
+
+    if (trackIndex == getTrackCount()) {
+        const AircraftProperties& props = dynamics.getProperties();
+        tracks.emplace_back(new RecordedTrack(props.name, props.maxThrust, props.emptyMass, keyframeInterval));
+    }
+
+    RecordedTrack& track = *tracks[trackIndex];
+    if (track.wouldGrow()) {
+        if (allocatedBytes + RecordedTrack::kChunkSize > memoryBudget) {
+            full = true;
+            return false;
+        }
+        allocatedBytes += RecordedTrack::kChunkSize;
+    }
+
+    RecordedFrame frame;
+    quantizeFrame(time, dynamics.getState(), dynamics.getFuel(), frame);
+    track.append(frame);
+    return true;
+}
+
+void FlightRecorder::clear() {
+    tracks.clear();
+    allocatedBytes = 0;
+    full = false;
+}
+
+size_t FlightRecorder::getEncodedBytes() const {
+    size_t total = 0;
+    for (const std::unique_ptr<RecordedTrack>& track : tracks) {
+        total += track->getEncodedBytes();
+    }
+    return total;
+}
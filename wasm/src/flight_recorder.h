@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "simulation.h"
+
+class AircraftFleet;
+
+// Quantized fields of one recorded tick
+enum RecordField {
+    REC_TIME = 0,                                   // 0.1 ms
+    REC_POSITION_X, REC_POSITION_Y, REC_POSITION_Z, // cm
+    REC_VELOCITY_X, REC_VELOCITY_Y, REC_VELOCITY_Z, // cm/s
+    REC_HEADING, REC_PITCH, REC_ROLL,               // 2^-16 turn, wraps
+    REC_HEADING_RATE, REC_PITCH_RATE, REC_ROLL_RATE,// 1e-4 rad/s
+    REC_FUEL,                                       // 10 g
+    REC_THROTTLE, REC_AILERON, REC_ELEVATOR, REC_RUDDER, // 1/1024
+    REC_FIELD_COUNT
+};
+
+struct RecordedFrame {
+    int32_t values[REC_FIELD_COUNT];
+};
+
+// Seconds from a quantized REC_TIME value
+inline double recordedTime(int32_t quantizedTime) {
+    return quantizedTime * 1e-4;
+}
+
+// Decoded tick
+struct RecordedSample {
+    double time;
+    AircraftState state;
+    float fuel;
+};
+
+// Quantize state, fuel and controls at the given time
+void quantizeFrame(double time, const AircraftState& state, float fuel, RecordedFrame& frame);
+// Rebuild a sample; thrust and mass need the aircraft's maximum thrust and empty mass
+void dequantizeFrame(const RecordedFrame& frame, float maxThrust, float emptyMass, RecordedSample& sample);
+
+// Recorded tick stream of one aircraft.
+// Every keyframeInterval-th tick is stored raw; other ticks store residuals against a
+// prediction from the previous ticks (linear extrapolation for kinematic fields, XOR
+// against the previous tick for control inputs), with a bit mask of non-zero residuals.
+// Data lives in fixed-size chunks that are never reallocated.
+class RecordedTrack {
+public:
+    struct Keyframe {
+        uint32_t tick;
+        int32_t time;       // Quantized (REC_TIME units)
+        uint32_t chunk;
+        uint32_t offset;
+    };
+
+    static const uint32_t kChunkSize = 64 * 1024;
+
+private:
+    std::string aircraftName;
+    float maxThrust;
+    float emptyMass;
+    uint32_t keyframeInterval;
+
+    std::vector<std::unique_ptr<uint8_t[]>> chunks;
+    std::vector<uint32_t> chunkUsed;
+    std::vector<Keyframe> keyframes;
+    uint32_t tickCount;
+    size_t allocatedBytes;
+
+    // Prediction history for the encoder
+    RecordedFrame previous;
+    RecordedFrame beforePrevious;
+
+    uint8_t* reserve(uint32_t bytes);
+
+    friend class TrackDecoder;
+
+public:
+    RecordedTrack(const std::string& name, float maxThrust, float emptyMass, uint32_t keyframeInterval);
+
+    void append(const RecordedFrame& frame);
+    // True when the next append needs a new chunk
+    bool wouldGrow() const;
+
+    const std::string& getAircraftName() const { return aircraftName; }
+    float getMaxThrust() const { return maxThrust; }
+    float getEmptyMass() const { return emptyMass; }
+    uint32_t getKeyframeInterval() const { return keyframeInterval; }
+    uint32_t getTickCount() const { return tickCount; }
+    const std::vector<Keyframe>& getKeyframes() const { return keyframes; }
+
+    // Encoded bytes and allocated chunk memory
+    size_t getEncodedBytes() const;
+    size_t getAllocatedBytes() const { return allocatedBytes; }
+
+    // Flat binary form for saving; deserialize decodes the whole track once and returns null
+    // on malformed input
+    void serialize(std::vector<uint8_t>& out) const;
+    static std::unique_ptr<RecordedTrack> deserialize(const uint8_t* data, size_t size);
+    // Independent copy, e.g. a snapshot of a track that is still being recorded
+    std::unique_ptr<RecordedTrack> clone() const;
+};
+
+// Sequential reader over a track, starting from any keyframe
+class TrackDecoder {
+private:
+    const RecordedTrack* track;
+    uint32_t tick;
+    uint32_t chunk;
+    uint32_t offset;
+    RecordedFrame previous;
+    RecordedFrame beforePrevious;
+
+    bool fail();
+
+public:
+    explicit TrackDecoder(const RecordedTrack& track);
+
+    void seekKeyframe(size_t keyframeIndex);
+    // Next tick to be returned by next()
+    uint32_t getTick() const { return tick; }
+    // False at the end of the track or on malformed data (every read is bounds-checked)
+    bool next(RecordedFrame& frame);
+
+    // Whether the next frame starts at the given chunk offset / all data has been read
+    bool isAt(uint32_t chunk, uint32_t offset) const;
+    bool atEnd() const;
+    // Prediction history after the last frame returned by next()
+    const RecordedFrame& getPrevious() const { return previous; }
+    const RecordedFrame& getBeforePrevious() const { return beforePrevious; }
+};
+
+// Records every aircraft of a fleet (or a single aircraft) once per physics tick
+class FlightRecorder {
+private:
+    std::vector<std::unique_ptr<RecordedTrack>> tracks;
+    uint32_t keyframeInterval;
+    size_t memoryBudget;
+    size_t allocatedBytes;
+    bool full;
+
+public:
+    explicit FlightRecorder(uint32_t keyframeInterval = 120, size_t memoryBudget = 64 * 1024 * 1024);
+
+    // Track i records fleet aircraft i; new aircraft get new tracks
+    void recordFleet(const AircraftFleet& fleet);
+    // trackIndex may be at most getTrackCount(), which starts a new track; returns false
+    // for any other index or once the recorder is full
+    bool recordAircraft(int trackIndex, double time, const FlightDynamics& dynamics);
+
+    void clear();
+
+    int getTrackCount() const { return static_cast<int>(tracks.size()); }
+    const RecordedTrack& getTrack(int index) const { return *tracks[index]; }
+
+    // Recording stops once the chunk memory would exceed the budget
+    bool isFull() const { return full; }
+    size_t getAllocatedBytes() const { return allocatedBytes; }
+    size_t getEncodedBytes() const;
+};
@@ -0,0 +1,113 @@
+#include "heap_buffer.h"
+#include <emscripten/bind.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+using namespace emscripten;
+
+namespace {
+
+// 16-byte aligned so SIMD kernels can load straight from the buffer
+float* allocateFloats(size_t count) {
+    if (count == 0) {
+        return nullptr;
+    }
+    return static_cast<float*>(::operator new(count * sizeof(float), std::align_val_t(16)));
+}
+
+void freeFloats(float* data) {
+    ::operator delete(data, std::align_val_t(16));
+}
+
+} // namespace
+
+HeapBuffer::HeapBuffer(int count) : storage(nullptr), length(0), capacity(0) {
+    resize(count);
+}
+
+HeapBuffer::~HeapBuffer() {
+    freeFloats(storage);
+}
+
+void HeapBuffer::resize(int count) {
+    size_t requested = static_cast<size_t>(std::max(0, count));
+    if (requested > capacity) {
+        // Grow geometrically so repeated small increases stay amortized
+        size_t grown = std::max(requested, capacity * 2);
+        float* moved = allocateFloats(grown);
+        if (length > 0) {
+            std::memcpy(moved, storage, length * sizeof(float));
+        }
+        freeFloats(storage);
+        storage = moved;
+        capacity = grown;
+    }
+    length = requested;
+}
+
+void HeapBuffer::assign(const val& array) {
+    resize(array["length"].as<int>());
+    if (length > 0) {
+        view().call<void>("set", array);
+    }
+}
+
+val HeapBuffer::view() const {
+    return val(typed_memory_view(length, storage));
+}
+
+void copyBytes(const val& array, std::vector<uint8_t>& out) {
+    out.resize(array["length"].as<size_t>());
+    if (!out.empty()) {
+        val(typed_memory_view(out.size(), out.data())).call<void>("set", array);
+    }
+}
+
+ScratchPool::Lease::Lease(ScratchPool* owner, std::unique_ptr<HeapBuffer> leased)
+    : pool(owner), buffer(std::move(leased)) {}
+
+ScratchPool::Lease::~Lease() {
+    if (buffer) {
+        pool->release(std::move(buffer));
+    }
+}
+
+ScratchPool::Lease ScratchPool::acquire(int count) {
+    std::unique_ptr<HeapBuffer> buffer;
+    if (available.empty()) {
+        buffer.reset(new HeapBuffer(count));
+    } else {
+        // Most recently returned first: it is the likeliest to be large enough and cached
+        buffer = std::move(available.back());
+        available.pop_back();
+        buffer->resize(count);
+    }
+    return Lease(this, std::move(buffer));
+}
+
+ScratchPool::Lease ScratchPool::copy(const val& array) {
+    Lease lease = acquire(0);
+    lease->assign(array);
+    return lease;
+}
+
+void ScratchPool::release(std::unique_ptr<HeapBuffer> buffer) {
+    available.push_back(std::move(buffer));
+}
+
+ScratchPool& ScratchPool::shared() {
+    static ScratchPool pool;
+    return pool;
+}
+
+EMSCRIPTEN_BINDINGS(heap_buffer_bindings) {
+    class_<HeapBuffer>("HeapBuffer")
+        .constructor<int>()
+        .function("resize", &HeapBuffer::resize)
+        .function("assign", &HeapBuffer::assign)
+        .function("getLength", &HeapBuffer::getLength)
+        .function("getCapacity", &HeapBuffer::getCapacity)
+        .function("getOffset", &HeapBuffer::getOffset)
+        .function("view", &HeapBuffer::view);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <emscripten/val.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Float array in the WASM heap that JS reads and writes in place. Whoever owns the object
+// frees the storage; from JS that is delete() on the HeapBuffer handle.
+class HeapBuffer {
+private:
+    float* storage;
+    size_t length;
+    size_t capacity;
+
+public:
+    explicit HeapBuffer(int count = 0);
+    ~HeapBuffer();
+
+    HeapBuffer(const HeapBuffer&) = delete;
+    HeapBuffer& operator=(const HeapBuffer&) = delete;
+
+    // Keeps the first min(old, new) values; growing past the capacity moves the storage
+    void resize(int count);
+    // Resize to the length of a JS array or typed array and copy it in with one set()
+    void assign(const emscripten::val& array);
+
+    float* data() { return storage; }
+    const float* data() const { return storage; }
+    int getLength() const { return static_cast<int>(length); }
+    int getCapacity() const { return static_cast<int>(capacity); }
+    // Byte offset into the heap, for HEAPF32 (offset / 4) and the offset-based entry points
+    uintptr_t getOffset() const { return reinterpret_cast<uintptr_t>(storage); }
+    // Float32Array over the contents; invalid after a resize past the capacity or memory growth
+    emscripten::val view() const;
+};
+
+// Copy a JS array or typed array of bytes into 'out', resized to its length, with one set()
+// instead of reading it element by element
+void copyBytes(const emscripten::val& array, std::vector<uint8_t>& out);
+
+// Heap buffers reused across binding calls, so copying JS input in does not allocate once
+// the pool has warmed up. Leases return their buffer when they go out of scope.
+class ScratchPool {
+public:
+    class Lease {
+    private:
+        ScratchPool* pool;
+        std::unique_ptr<HeapBuffer> buffer;
+
+    public:
+        Lease(ScratchPool* owner, std::unique_ptr<HeapBuffer> leased);
+        Lease(Lease&& other) = default;
+        ~Lease();
+
+        HeapBuffer& operator*() const { return *buffer; }
+        HeapBuffer* operator->() const { return buffer.get(); }
+    };
+
+    // A buffer of 'count' floats with unspecified contents
+    Lease acquire(int count);
+    // A buffer holding a copy of a JS array or typed array
+    Lease copy(const emscripten::val& array);
+
+    int getFreeCount() const { return static_cast<int>(available.size()); }
+
+    // Pool shared by the bindings (the module is single-threaded)
+    static ScratchPool& shared();
+
+private:
+    std::vector<std::unique_ptr<HeapBuffer>> available;
+
+    void release(std::unique_ptr<HeapBuffer> buffer);
+};
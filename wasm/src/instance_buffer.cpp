@@ -0,0 +1,145 @@
+#include "instance_buffer.h"
+#include <algorithm>
+#include <cstring>
+#include "vector_math.h"
+
+InstanceMatrixBuffer::InstanceMatrixBuffer() : keepPrevious(false) {
+    groupOffsets.push_back(0);
+}
+
+void InstanceMatrixBuffer::setModel(int entity, int model) {
+    if (entity < 0 || entity >= kMaxEntities || model < 0 || model >= kMaxModels) {
+        return;
+    }
+    if (entity >= static_cast<int>(models.size())) {
+        models.resize(entity + 1, 0);
+    }
+    models[entity] = model;
+}
+
+int InstanceMatrixBuffer::getModel(int entity) const {
+    return entity >= 0 && entity < static_cast<int>(models.size()) ? models[entity] : 0;
+}
+
+void InstanceMatrixBuffer::setKeepPrevious(bool enabled) {
+    keepPrevious = enabled;
+    if (!enabled) {
+        previousMatrices.clear();
+        resetPrevious();
+    }
+}
+
+void InstanceMatrixBuffer::resetPrevious() {
+    std::fill(hasLast.begin(), hasLast.end(), 0);
+}
+
+void InstanceMatrixBuffer::resizePoses(int count) {
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    heading.resize(count);
+    pitch.resize(count);
+    roll.resize(count);
+}
+
+void InstanceMatrixBuffer::build(const float* poses, int count, int stride) {
+    resizePoses(count);
+    for (int i = 0; i < count; ++i) {
+        const float* pose = poses + static_cast<size_t>(i) * stride;
+        x[i] = pose[0];
+        y[i] = pose[1];
+        z[i] = pose[2];
+        heading[i] = pose[3];
+        pitch[i] = pose[4];
+        roll[i] = pose[5];
+    }
+    writeMatrices();
+}
+
+void InstanceMatrixBuffer::build(const AircraftFleet& fleet) {
+    const int count = fleet.size();
+    resizePoses(count);
+    for (int i = 0; i < count; ++i) {
+        const AircraftState& state = fleet.getAircraft(i).getState();
+        x[i] = state.position.x;
+        y[i] = state.position.y;
+        z[i] = state.position.z;
+        heading[i] = state.heading;
+        pitch[i] = state.pitch;
+        roll[i] = state.roll;
+    }
+    writeMatrices();
+}
+
+void InstanceMatrixBuffer::build(const RemoteEntitySet& entities) {
+    build(entities.getRenderData().data(), entities.size(), RemoteEntitySet::kRenderStride);
+}
+
+void InstanceMatrixBuffer::writeMatrices() {
+    const int count = static_cast<int>(x.size());
+    if (static_cast<int>(models.size()) < count) {
+        models.resize(count, 0);
+    }
+
+    // Counting sort by model keeps entity order within each group
+    int modelCount = 0;
+    for (int i = 0; i < count; ++i) {
+        modelCount = std::max(modelCount, models[i] + 1);
+    }
+    groupOffsets.assign(modelCount + 1, 0);
+    for (int i = 0; i < count; ++i) {
+        groupOffsets[models[i] + 1]++;
+    }
+    for (int m = 0; m < modelCount; ++m) {
+        groupOffsets[m + 1] += groupOffsets[m];
+    }
+    slotEntities.resize(count);
+    groupCursors.assign(groupOffsets.begin(), groupOffsets.end() - 1);
+    for (int i = 0; i < count; ++i) {
+        slotEntities[groupCursors[models[i]]++] = i;
+    }
+
+    // Rotation of a 'YXZ' Euler, as Three.js builds it, plus the translation; built four
+    // entities at a time in entity order, then copied into the grouped slots
+    entityMatrices.resize(static_cast<size_t>(count) * kMatrixFloats);
+    vmath::eulerYXZMatrices(x.data(), y.data(), z.data(), heading.data(), pitch.data(), roll.data(),
+                            entityMatrices.data(), count);
+    matrices.resize(static_cast<size_t>(count) * kMatrixFloats);
+    for (int slot = 0; slot < count; ++slot) {
+        std::memcpy(&matrices[static_cast<size_t>(slot) * kMatrixFloats],
+                    &entityMatrices[static_cast<size_t>(slotEntities[slot]) * kMatrixFloats],
+                    kMatrixFloats * sizeof(float));
+    }
+
+    if (!keepPrevious) {
+        return;
+    }
+
+    lastByEntity.resize(static_cast<size_t>(count) * kMatrixFloats);
+    hasLast.resize(count, 0);
+    previousMatrices.resize(matrices.size());
+    for (int slot = 0; slot < count; ++slot) {
+        const int i = slotEntities[slot];
+        float* last = &lastByEntity[static_cast<size_t>(i) * kMatrixFloats];
+        const float* current = &matrices[static_cast<size_t>(slot) * kMatrixFloats];
+        const float* source = hasLast[i] ? last : current;
+        std::memcpy(&previousMatrices[static_cast<size_t>(slot) * kMatrixFloats], source,
+                    kMatrixFloats * sizeof(float));
+        std::memcpy(last, current, kMatrixFloats * sizeof(float));
+        hasLast[i] = 1;
+    }
+}
+
+int InstanceMatrixBuffer::getGroupOffset(int model) const {
+    if (model < 0 || model >= getModelCount()) {
+        return getInstanceCount();
+    }
+    return groupOffsets[model];
+}
+
+int InstanceMatrixBuffer::getGroupCount(int model) const {
+    if (model < 0 || model >= getModelCount()) {
+        return 0;
+    }
+    return groupOffsets[model + 1] - groupOffsets[model];
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "fleet.h"
+#include "remote_entity.h"
+
+// World matrices for instanced rendering of every aircraft, grouped by model.
+// Each build() writes one column-major 4x4 matrix per entity into a single contiguous array,
+// with the entities of each model in a consecutive run of slots, so one InstancedMesh per model
+// uploads its whole run in one call. The rotation matches a Three.js Euler
+// (pitch, heading, roll) in 'YXZ' order followed by the translation.
+// Optionally the previous build's matrix of each entity is written to a parallel array in the
+// same slot order (for motion blur); entities without one repeat their current matrix.
+class InstanceMatrixBuffer {
+public:
+    static const int kMatrixFloats = 16;
+    // Limits of setModel; ids come from JS and size the per-entity and per-model arrays.
+    // Entities match the 16-bit network ids.
+    static const int kMaxEntities = 65536;
+    static const int kMaxModels = 1024;
+
+private:
+    std::vector<int> models;                // Model id per entity
+    std::vector<float> x, y, z, heading, pitch, roll;   // Poses of this build
+
+    std::vector<float> matrices;            // kMatrixFloats per slot
+    std::vector<float> entityMatrices;      // Matrices of this build, by entity index
+    std::vector<float> previousMatrices;    // Same slots, previous build
+    std::vector<float> lastByEntity;        // Last matrix of every entity, by entity index
+    std::vector<uint8_t> hasLast;
+    std::vector<int> slotEntities;          // Entity drawn in each slot
+    std::vector<int> groupOffsets;          // First slot per model, plus the end
+    std::vector<int> groupCursors;          // Scratch for the counting sort
+    bool keepPrevious;
+
+    void resizePoses(int count);
+    void writeMatrices();
+
+public:
+    InstanceMatrixBuffer();
+
+    // Model ids are small non-negative integers; entities default to model 0. Calls with an
+    // entity outside [0, kMaxEntities) or a model outside [0, kMaxModels) are ignored.
+    void setModel(int entity, int model);
+    int getModel(int entity) const;
+
+    void setKeepPrevious(bool enabled);
+    bool isKeepingPrevious() const { return keepPrevious; }
+    // Forget previous matrices, e.g. after a teleport or a change of entity set
+    void resetPrevious();
+
+    // Build from a flat pose array of 'stride' floats per entity: x, y, z, heading, pitch, roll
+    void build(const float* poses, int count, int stride);
+    void build(const AircraftFleet& fleet);
+    void build(const RemoteEntitySet& entities);
+
+    int getInstanceCount() const { return static_cast<int>(slotEntities.size()); }
+    const std::vector<float>& getMatrices() const { return matrices; }
+    const std::vector<float>& getPreviousMatrices() const { return previousMatrices; }
+    const std::vector<int>& getSlotEntities() const { return slotEntities; }
+
+    // Slot range of a model: [getGroupOffset, getGroupOffset + getGroupCount)
+    int getModelCount() const { return static_cast<int>(groupOffsets.size()) - 1; }
+    int getGroupOffset(int model) const;
+    int getGroupCount(int model) const;
+};
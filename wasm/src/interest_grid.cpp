@@ -0,0 +1,372 @@
+#include "interest_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Calls visit(x, z) for every cell of 'range' outside 'keep'. Rows that overlap 'keep' only
+// visit the columns on either side of it, so the work follows the cells visited.
+template <typename Range, typename Visit>
+void forEachCellOutside(const Range& range, const Range& keep, Visit visit) {
+    for (int x = range.minX; x <= range.maxX; ++x) {
+        if (x < keep.minX || x > keep.maxX || keep.minZ > keep.maxZ) {
+            for (int z = range.minZ; z <= range.maxZ; ++z) {
+                visit(x, z);
+            }
+            continue;
+        }
+        for (int z = range.minZ; z <= std::min(range.maxZ, keep.minZ - 1); ++z) {
+            visit(x, z);
+        }
+        for (int z = std::max(range.minZ, keep.maxZ + 1); z <= range.maxZ; ++z) {
+            visit(x, z);
+        }
+    }
+}
+
+} // namespace
+
+const InterestGrid::CellRange InterestGrid::kNoCells = {1, 0, 1, 0};
+
+InterestGrid::InterestGrid(float cellSize_, float hysteresis_) : cellSize(cellSize_), hysteresis(hysteresis_) {
+}
+
+int64_t InterestGrid::cellKey(int x, int z) const {
+    // Shift as unsigned: left-shifting a negative signed value is undefined
+    return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z));
+}
+
+int InterestGrid::cellCoordinate(float value) const {
+    float cell = std::floor(value / cellSize);
+    return static_cast<int>(std::max(-1.0e9f, std::min(1.0e9f, cell)));
+}
+
+InterestGrid::Cell& InterestGrid::acquireCell(int64_t key) {
+    CellMap::iterator cell = cells.find(key);
+    if (cell != cells.end()) {
+        return cell->second;
+    }
+    if (spareCells.empty()) {
+        return cells[key];
+    }
+    // Map nodes keep their address through extract and insert, as Entity::cellData needs
+    CellMap::node_type node = std::move(spareCells.back());
+    spareCells.pop_back();
+    node.key() = key;
+    return cells.insert(std::move(node)).position->second;
+}
+
+void InterestGrid::releaseCell(int64_t key) {
+    CellMap::iterator cell = cells.find(key);
+    if (cell != cells.end() && cell->second.firstEntity < 0 && cell->second.observers.empty()) {
+        spareCells.push_back(cells.extract(cell));
+    }
+}
+
+void InterestGrid::linkEntity(int id, Cell& cell) {
+    Entity& entity = entities[id];
+    entity.cellData = &cell;
+    entity.previousInCell = -1;
+    entity.nextInCell = cell.firstEntity;
+    if (cell.firstEntity >= 0) {
+        entities[cell.firstEntity].previousInCell = id;
+    }
+    cell.firstEntity = id;
+}
+
+void InterestGrid::unlinkEntity(int id) {
+    Entity& entity = entities[id];
+    if (entity.previousInCell >= 0) {
+        entities[entity.previousInCell].nextInCell = entity.nextInCell;
+    } else {
+        entity.cellData->firstEntity = entity.nextInCell;
+    }
+    if (entity.nextInCell >= 0) {
+        entities[entity.nextInCell].previousInCell = entity.previousInCell;
+    }
+    entity.cellData = nullptr;
+}
+
+void InterestGrid::reserveCells() {
+    // Live cells never exceed the observers' ranges plus one cell per entity
+    size_t bound = 0;
+    for (const Observer& observer : observers) {
+        if (observer.alive) {
+            bound += static_cast<size_t>(observer.rangeCells);
+        }
+    }
+    for (const Entity& entity : entities) {
+        bound += entity.alive ? 1 : 0;
+    }
+    cells.reserve(bound);
+
+    CellMap pool;
+    while (cells.size() + spareCells.size() < bound) {
+        pool[0];
+        spareCells.push_back(pool.extract(pool.begin()));
+    }
+    // Each observer registers at most once per cell
+    for (CellMap::value_type& cell : cells) {
+        cell.second.observers.reserve(observers.size());
+    }
+    for (CellMap::node_type& node : spareCells) {
+        node.mapped().observers.reserve(observers.size());
+    }
+}
+
+int InterestGrid::coveredHalfWidth(const Observer& observer) const {
+    // Everything an entity can be at without leaving the outer band
+    float reach = observer.bands.empty() ? 0.0f : observer.bands.back().radius * (1.0f + hysteresis);
+    return static_cast<int>(std::min(1.0e4f, std::ceil(reach / cellSize)));
+}
+
+InterestGrid::CellRange InterestGrid::coveredRange(const Observer& observer, const Vec3& position) const {
+    // Counted from the observer's cell, so the range has the same size wherever it lies;
+    // position +/- reach rounds coarsely far from the origin
+    int half = coveredHalfWidth(observer);
+    int x = cellCoordinate(position.x);
+    int z = cellCoordinate(position.z);
+    CellRange range = {x - half, x + half, z - half, z + half};
+    return range;
+}
+
+void InterestGrid::registerObserver(int observer, const CellRange& range, const CellRange& keep) {
+    forEachCellOutside(range, keep, [this, observer](int x, int z) {
+        acquireCell(cellKey(x, z)).observers.push_back(observer);
+    });
+}
+
+void InterestGrid::unregisterObserver(int observer, const CellRange& range, const CellRange& keep) {
+    forEachCellOutside(range, keep, [this, observer](int x, int z) {
+        int64_t key = cellKey(x, z);
+        CellMap::iterator cell = cells.find(key);
+        if (cell == cells.end()) {
+            return;
+        }
+        std::vector<int>& list = cell->second.observers;
+        std::vector<int>::iterator found = std::find(list.begin(), list.end(), observer);
+        if (found != list.end()) {
+            *found = list.back();
+            list.pop_back();
+        }
+        releaseCell(key);
+    });
+}
+
+void InterestGrid::scanCovered(int observer) {
+    const CellRange& range = observers[observer].covered;
+    for (int x = range.minX; x <= range.maxX; ++x) {
+        for (int z = range.minZ; z <= range.maxZ; ++z) {
+            std::unordered_map<int64_t, Cell>::const_iterator cell = cells.find(cellKey(x, z));
+            if (cell == cells.end()) {
+                continue;
+            }
+            for (int entity = cell->second.firstEntity; entity >= 0; entity = entities[entity].nextInCell) {
+                evaluate(observer, entity);
+            }
+        }
+    }
+}
+
+void InterestGrid::setBand(Observer& observer, int entity, int band) {
+    int current = observer.bandOf[entity];
+    if (current == band) {
+        return;
+    }
+
+    if (current < 0) {
+        observer.relevantSlot[entity] = static_cast<int>(observer.relevant.size());
+        observer.relevant.push_back(entity);
+        observer.events.push_back({entity, band});
+    } else if (band < 0) {
+        int slot = observer.relevantSlot[entity];
+        int last = observer.relevant.back();
+        observer.relevant[slot] = last;
+        observer.relevantSlot[last] = slot;
+        observer.relevant.pop_back();
+        observer.relevantSlot[entity] = -1;
+        observer.events.push_back({entity, -1});
+    }
+    observer.bandOf[entity] = static_cast<int8_t>(band);
+}
+
+void InterestGrid::evaluate(int observer, int entity) {
+    Observer& o = observers[observer];
+    float distanceSquared = (entities[entity].position - o.position).lengthSquared();
+
+    int current = o.bandOf[entity];
+    const int bandCount = static_cast<int>(o.enterSquared.size());
+    if (current < 0 && (bandCount == 0 || distanceSquared > o.enterSquared[bandCount - 1])) {
+        return;     // Common case: far away and not tracked
+    }
+
+    int band = -1;
+    for (int i = 0; i < bandCount; ++i) {
+        if (distanceSquared <= o.enterSquared[i]) {
+            band = i;
+            break;
+        }
+    }
+
+    // Stay in the current band until clearly outside it
+    if (current >= 0 && (band < 0 || band > current) && distanceSquared <= o.leaveSquared[current]) {
+        band = current;
+    }
+    setBand(o, entity, band);
+}
+
+int InterestGrid::addEntity(const Vec3& position) {
+    int id = static_cast<int>(entities.size());
+    Entity entity;
+    entity.position = position;
+    entity.cell = cellKey(cellCoordinate(position.x), cellCoordinate(position.z));
+    entity.alive = true;
+
+    entities.push_back(entity);
+    Cell& cell = acquireCell(entity.cell);
+    linkEntity(id, cell);
+
+    for (Observer& observer : observers) {
+        observer.bandOf.push_back(-1);
+        observer.relevantSlot.push_back(-1);
+    }
+    for (int observer : cell.observers) {
+        evaluate(observer, id);
+    }
+    reserveCells();
+    return id;
+}
+
+void InterestGrid::moveEntity(int id, const Vec3& position) {
+    Entity& entity = entities[id];
+    if (!entity.alive) {
+        return;
+    }
+    entity.position = position;
+
+    int64_t key = cellKey(cellCoordinate(position.x), cellCoordinate(position.z));
+    if (key != entity.cell) {
+        // Observers of the old cell may lose the entity
+        Cell& oldCell = *entity.cellData;
+        unlinkEntity(id);
+        for (int observer : oldCell.observers) {
+            evaluate(observer, id);
+        }
+        releaseCell(entity.cell);
+
+        entity.cell = key;
+        linkEntity(id, acquireCell(key));
+    }
+
+    for (int observer : entity.cellData->observers) {
+        evaluate(observer, id);
+    }
+}
+
+void InterestGrid::removeEntity(int id) {
+    Entity& entity = entities[id];
+    if (!entity.alive) {
+        return;
+    }
+
+    Cell& cell = *entity.cellData;
+    for (int observer : cell.observers) {
+        setBand(observers[observer], id, -1);
+    }
+    unlinkEntity(id);
+    entity.alive = false;
+    releaseCell(entity.cell);
+}
+
+int InterestGrid::addObserver(const Vec3& position, const std::vector<InterestBand>& bands) {
+    int id = static_cast<int>(observers.size());
+    observers.emplace_back();
+    Observer& observer = observers.back();
+    observer.position = position;
+    observer.scanPosition = position;
+    observer.bands = bands;
+    for (const InterestBand& band : bands) {
+        float leave = band.radius * (1.0f + hysteresis);
+        observer.enterSquared.push_back(band.radius * band.radius);
+        observer.leaveSquared.push_back(leave * leave);
+    }
+    observer.bandOf.assign(entities.size(), -1);
+    observer.relevantSlot.assign(entities.size(), -1);
+    observer.alive = true;
+
+    int span = 2 * coveredHalfWidth(observer) + 1;
+    observer.rangeCells = span * span;
+
+    observer.covered = coveredRange(observer, position);
+    registerObserver(id, observer.covered, kNoCells);
+    scanCovered(id);
+    reserveCells();
+    return id;
+}
+
+void InterestGrid::moveObserver(int id, const Vec3& position) {
+    Observer& observer = observers[id];
+    if (!observer.alive) {
+        return;
+    }
+    observer.position = position;
+
+    CellRange range = coveredRange(observer, position);
+    const CellRange& old = observer.covered;
+    bool covered = range.minX != old.minX || range.maxX != old.maxX ||
+                   range.minZ != old.minZ || range.maxZ != old.maxZ;
+    if (covered) {
+        // Only the cells leaving and entering the range change
+        unregisterObserver(id, old, range);
+        registerObserver(id, range, old);
+        observer.covered = range;
+    }
+
+    // Backwards, since leaving entities are swap-removed from the list
+    for (int i = static_cast<int>(observer.relevant.size()) - 1; i >= 0; --i) {
+        evaluate(id, observer.relevant[i]);
+    }
+
+    float dx = position.x - observer.scanPosition.x;
+    float dz = position.z - observer.scanPosition.z;
+    float rescan = cellSize * 0.25f;
+    if (covered || dx * dx + dz * dz > rescan * rescan) {
+        observer.scanPosition = position;
+        scanCovered(id);
+    }
+}
+
+void InterestGrid::removeObserver(int id) {
+    Observer& observer = observers[id];
+    if (!observer.alive) {
+        return;
+    }
+    unregisterObserver(id, observer.covered, kNoCells);
+    observer.alive = false;
+    observer.bandOf.assign(observer.bandOf.size(), -1);
+    observer.relevant.clear();
+    observer.events.clear();
+}
+
+int InterestGrid::getBand(int observer, int entity) const {
+    return observers[observer].bandOf[entity];
+}
+
+bool InterestGrid::isDue(int observer, int entity, int64_t update) const {
+    const Observer& o = observers[observer];
+    int band = o.bandOf[entity];
+    if (band < 0) {
+        return false;
+    }
+    int interval = std::max(1, o.bands[band].interval);
+    return (update + entity) % interval == 0;
+}
+
+void InterestGrid::collectDue(int observer, int64_t update, std::vector<int>& due) const {
+    due.clear();
+    for (int entity : observers[observer].relevant) {
+        if (isDue(observer, entity, update)) {
+            due.push_back(entity);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "simulation.h"
+
+// Distance band of an observer's area of interest
+struct InterestBand {
+    float radius;       // Outer edge (m)
+    int interval;       // Updates are due every 'interval' calls to collectDue
+};
+
+// Entity entering (band >= 0) or leaving (band -1) an observer's area of interest
+struct InterestEvent {
+    int entity;
+    int band;
+};
+
+// Interest management on a uniform grid over the horizontal plane.
+// Entities live in one cell; observers are registered in every cell their outermost band
+// overlaps. Moving an entity only re-evaluates it against the observers of its old and new
+// cells, so work per tick follows the number of moved entities rather than entities x observers.
+// Each observer keeps its relevant entities with their distance band and an event list of
+// entities entering and leaving its area of interest.
+class InterestGrid {
+private:
+    struct Cell {
+        int firstEntity = -1;   // Entities in the cell are linked through Entity::nextInCell
+        std::vector<int> observers;
+    };
+
+    // Inclusive range of cell coordinates; empty when min > max
+    struct CellRange {
+        int minX, maxX, minZ, maxZ;
+    };
+    static const CellRange kNoCells;
+
+    struct Entity {
+        Vec3 position;
+        int64_t cell;
+        Cell* cellData;         // Map nodes are stable, so the cell can be kept by pointer
+        int previousInCell;     // -1 at either end of the cell's list
+        int nextInCell;
+        bool alive;
+    };
+
+    struct Observer {
+        Vec3 position;
+        Vec3 scanPosition;      // Position at the last full scan of covered cells
+        std::vector<InterestBand> bands;
+        std::vector<float> enterSquared;    // Squared band radii
+        std::vector<float> leaveSquared;    // Squared radii including hysteresis
+        CellRange covered;
+        int rangeCells;                     // Cells in 'covered'
+        std::vector<int8_t> bandOf;         // Per entity, -1 when not relevant
+        std::vector<int> relevant;
+        std::vector<int> relevantSlot;      // Per entity, index in relevant
+        std::vector<InterestEvent> events;
+        bool alive;
+    };
+
+    typedef std::unordered_map<int64_t, Cell> CellMap;
+    CellMap cells;                               // Only cells with entities or observers
+    std::vector<CellMap::node_type> spareCells;  // Released cells, reused with their capacity
+    std::vector<Entity> entities;
+    std::vector<Observer> observers;
+    float cellSize;
+    float hysteresis;
+
+    int64_t cellKey(int x, int z) const;
+    int cellCoordinate(float value) const;
+    // Cells are taken from and returned to spareCells, so a steady state allocates nothing
+    Cell& acquireCell(int64_t key);
+    // Releases the cell once it holds neither entities nor observers
+    void releaseCell(int64_t key);
+    void linkEntity(int entity, Cell& cell);
+    void unlinkEntity(int entity);
+    // Pools enough cells for every observer range and entity, outside the tick path
+    void reserveCells();
+    int coveredHalfWidth(const Observer& observer) const;
+    CellRange coveredRange(const Observer& observer, const Vec3& position) const;
+    // Register in / unregister from the cells of a range that are not also in 'keep'
+    void registerObserver(int observer, const CellRange& range, const CellRange& keep);
+    void unregisterObserver(int observer, const CellRange& range, const CellRange& keep);
+    void scanCovered(int observer);
+    void evaluate(int observer, int entity);
+    void setBand(Observer& observer, int entity, int band);
+
+public:
+    // Hysteresis: fraction of a band radius an entity may overshoot before dropping out of it
+    explicit InterestGrid(float cellSize = 4000.0f, float hysteresis = 0.05f);
+
+    // Entity ids are assigned in order and never reused
+    int addEntity(const Vec3& position);
+    void moveEntity(int entity, const Vec3& position);
+    void removeEntity(int entity);
+    int getEntityCount() const { return static_cast<int>(entities.size()); }
+
+    // Bands ordered from nearest to farthest; the last radius bounds the area of interest
+    int addObserver(const Vec3& position, const std::vector<InterestBand>& bands);
+    // Relevant entities are re-evaluated; covered cells are rescanned once the observer has
+    // moved a quarter cell, so stationary entities are picked up with that much delay.
+    // Only the rows and columns entering or leaving the covered range change registration.
+    void moveObserver(int observer, const Vec3& position);
+    void removeObserver(int observer);
+
+    // Band of an entity for an observer, -1 if outside its area of interest
+    int getBand(int observer, int entity) const;
+    const std::vector<int>& getRelevant(int observer) const { return observers[observer].relevant; }
+
+    // Enter/leave events since the last clearEvents
+    const std::vector<InterestEvent>& getEvents(int observer) const { return observers[observer].events; }
+    void clearEvents(int observer) { observers[observer].events.clear(); }
+
+    // Relevant entities due at this update count, staggered by entity id within each band
+    bool isDue(int observer, int entity, int64_t update) const;
+    void collectDue(int observer, int64_t update, std::vector<int>& due) const;
+
+    float getCellSize() const { return cellSize; }
+    int getCellCount() const { return static_cast<int>(cells.size()); }
+};
@@ -1,54 +1,32 @@
 #include <emscripten/bind.h>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include "vector_math.h"
 
 using namespace emscripten;
 
-// Vector3 class for basic 3D math
+// Vector3 for JS, backed by the shared Vec3
 class Vector3 {
 public:
     float x, y, z;
     
     Vector3() : x(0), y(0), z(0) {}
     Vector3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+    Vector3(const Vec3& v) : x(v.x), y(v.y), z(v.z) {}
     
-    Vector3 add(const Vector3& other) const {
-        return Vector3(x + other.x, y + other.y, z + other.z);
-    }
-    
-    Vector3 subtract(const Vector3& other) const {
-        return Vector3(x - other.x, y - other.y, z - other.z);
-    }
-    
-    Vector3 multiply(float scalar) const {
-        return Vector3(x * scalar, y * scalar, z * scalar);
-    }
-    
-    float dot(const Vector3& other) const {
-        return x * other.x + y * other.y + z * other.z;
-    }
-    
-    Vector3 cross(const Vector3& other) const {
-        return Vector3(
-            y * other.z - z * other.y,
-            z * other.x - x * other.z,
-            x * other.y - y * other.x
-        );
-    }
-    
-    float length() const {
-        return std::sqrt(x * x + y * y + z * z);
-    }
+    Vec3 vec() const { return Vec3(x, y, z); }
     
-    Vector3 normalize() const {
-        float len = length();
-        if (len > 0) {
-            return multiply(1.0f / len);
-        }
-        return *this;
-    }
+    Vector3 add(const Vector3& other) const { return vec() + other.vec(); }
+    Vector3 subtract(const Vector3& other) const { return vec() - other.vec(); }
+    Vector3 multiply(float scalar) const { return vec() * scalar; }
+    float dot(const Vector3& other) const { return vec().dot(other.vec()); }
+    Vector3 cross(const Vector3& other) const { return vec().cross(other.vec()); }
+    float length() const { return vec().length(); }
+    Vector3 normalize() const { return vec().normalized(); }
 };
 
-// Quaternion for rotations
+// Quaternion for JS (w first), backed by the shared Quat
 class Quaternion {
 public:
     float w, x, y, z;
@@ -56,47 +34,16 @@ public:
     Quaternion() : w(1), x(0), y(0), z(0) {}
     Quaternion(float w_, float x_, float y_, float z_) 
         : w(w_), x(x_), y(y_), z(z_) {}
+    Quaternion(const Quat& q) : w(q.w), x(q.x), y(q.y), z(q.z) {}
     
-    static Quaternion fromAxisAngle(const Vector3& axis, float angle) {
-        float halfAngle = angle * 0.5f;
-        float s = std::sin(halfAngle);
-        Vector3 normalizedAxis = axis.normalize();
-        
-        return Quaternion(
-            std::cos(halfAngle),
-            normalizedAxis.x * s,
-            normalizedAxis.y * s,
-            normalizedAxis.z * s
-        );
-    }
+    Quat quat() const { return Quat(x, y, z, w); }
     
-    Quaternion multiply(const Quaternion& other) const {
-        return Quaternion(
-            w * other.w - x * other.x - y * other.y - z * other.z,
-            w * other.x + x * other.w + y * other.z - z * other.y,
-            w * other.y - x * other.z + y * other.w + z * other.x,
-            w * other.z + x * other.y - y * other.x + z * other.w
-        );
+    static Quaternion fromAxisAngle(const Vector3& axis, float angle) {
+        return Quat::fromAxisAngle(axis.vec(), angle);
     }
     
-    Vector3 rotateVector(const Vector3& v) const {
-        // Quaternion rotation formula: q * v * q^-1
-        float qx2 = x * x;
-        float qy2 = y * y;
-        float qz2 = z * z;
-        float qwx = w * x;
-        float qwy = w * y;
-        float qwz = w * z;
-        float qxy = x * y;
-        float qxz = x * z;
-        float qyz = y * z;
-        
-        return Vector3(
-            v.x * (1 - 2 * (qy2 + qz2)) + v.y * 2 * (qxy - qwz) + v.z * 2 * (qxz + qwy),
-            v.x * 2 * (qxy + qwz) + v.y * (1 - 2 * (qx2 + qz2)) + v.z * 2 * (qyz - qwx),
-            v.x * 2 * (qxz - qwy) + v.y * 2 * (qyz + qwx) + v.z * (1 - 2 * (qx2 + qy2))
-        );
-    }
+    Quaternion multiply(const Quaternion& other) const { return quat() * other.quat(); }
+    Vector3 rotateVector(const Vector3& v) const { return quat().rotate(v.vec()); }
 };
 
 // Math utilities
@@ -120,6 +67,39 @@ namespace MathUtils {
     }
 }
 
+// Batch math over packed floats in the wasm heap, one call per array.
+// Arguments are byte offsets (HeapBuffer.getOffset() or _malloc); vectors take 3 floats and
+// quaternions 4 (x, y, z, w). The output may be one of the inputs.
+namespace BatchMath {
+    const float* input(uintptr_t offset) {
+        return reinterpret_cast<const float*>(offset);
+    }
+    
+    float* output(uintptr_t offset) {
+        return reinterpret_cast<float*>(offset);
+    }
+    
+    void addVectors(uintptr_t a, uintptr_t b, uintptr_t out, int count) {
+        vmath::addVectors(input(a), input(b), output(out), std::max(0, count));
+    }
+    
+    void crossVectors(uintptr_t a, uintptr_t b, uintptr_t out, int count) {
+        vmath::crossVectors(input(a), input(b), output(out), std::max(0, count));
+    }
+    
+    void normalizeVectors(uintptr_t vectors, uintptr_t out, int count) {
+        vmath::normalizeVectors(input(vectors), output(out), std::max(0, count));
+    }
+    
+    void multiplyQuaternions(uintptr_t a, uintptr_t b, uintptr_t out, int count) {
+        vmath::multiplyQuaternions(input(a), input(b), output(out), std::max(0, count));
+    }
+    
+    void rotateVectors(uintptr_t quaternions, uintptr_t vectors, uintptr_t out, int count) {
+        vmath::rotateVectors(input(quaternions), input(vectors), output(out), std::max(0, count));
+    }
+}
+
 // Bindings
 EMSCRIPTEN_BINDINGS(math_utils) {
     // Vector3 bindings
@@ -154,4 +134,11 @@ EMSCRIPTEN_BINDINGS(math_utils) {
     function("radToDeg", &MathUtils::radToDeg);
     function("clamp", &MathUtils::clamp);
     function("lerp", &MathUtils::lerp);
+    
+    // Batch math on heap offsets
+    function("addVectors", &BatchMath::addVectors);
+    function("crossVectors", &BatchMath::crossVectors);
+    function("normalizeVectors", &BatchMath::normalizeVectors);
+    function("multiplyQuaternions", &BatchMath::multiplyQuaternions);
+    function("rotateVectors", &BatchMath::rotateVectors);
 }
\ No newline at end of file
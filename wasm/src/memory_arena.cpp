@@ -0,0 +1,88 @@
+#include "memory_arena.h"
+#include <algorithm>
+#include "memory_stats.h"
+
+MemoryArena::MemoryArena(const char* name_, size_t blockSize)
+    : name(name_), defaultBlockSize(std::max<size_t>(blockSize, 64)), current(0), offset(0),
+      usedBeforeCurrent(0), capacity(0), highWater(0), blockAllocations(0), generation(0) {
+}
+
+void MemoryArena::addBlock(size_t minimumSize) {
+    Block block;
+    block.size = std::max(defaultBlockSize, minimumSize);
+    block.data.reset(new uint8_t[block.size]);
+    capacity += block.size;
+    blockAllocations++;
+    blocks.push_back(std::move(block));
+}
+
+void* MemoryArena::allocate(size_t bytes, size_t alignment) {
+    if (blocks.empty()) {
+        addBlock(bytes + alignment);
+    }
+    for (;;) {
+        Block& block = blocks[current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        const uintptr_t aligned = (base + offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        const size_t start = aligned - base;
+        if (start + bytes <= block.size) {
+            offset = start + bytes;
+            highWater = std::max(highWater, getUsed());
+            return block.data.get() + start;
+        }
+
+        // The rest of this block is abandoned until the next reset or rewind
+        usedBeforeCurrent += block.size;
+        offset = 0;
+        if (current + 1 == blocks.size()) {
+            addBlock(bytes + alignment);
+        }
+        current++;
+    }
+}
+
+void MemoryArena::reset() {
+    if (blocks.size() > 1) {
+        // One block big enough for this cycle's peak
+        size_t total = capacity;
+        blocks.clear();
+        capacity = 0;
+        addBlock(total);
+    }
+    current = 0;
+    offset = 0;
+    usedBeforeCurrent = 0;
+    generation++;
+}
+
+bool MemoryArena::rewind(const Marker& marker) {
+    if (marker.generation != generation) {
+        return false;
+    }
+    current = marker.block;
+    offset = marker.offset;
+    usedBeforeCurrent = 0;
+    for (size_t i = 0; i < current && i < blocks.size(); ++i) {
+        usedBeforeCurrent += blocks[i].size;
+    }
+    return true;
+}
+
+namespace memory {
+
+MemoryArena& frameArena() {
+    thread_local MemoryArena arena("frame", 256 * 1024);
+    return arena;
+}
+
+MemoryArena& loadArena() {
+    thread_local MemoryArena arena("load", 1024 * 1024);
+    return arena;
+}
+
+void beginFrame() {
+    frameArena().reset();
+    markFrame();
+}
+
+} // namespace memory
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Bump-pointer arena. Allocation is a pointer increment inside the current block; nothing
+// is freed individually. reset() releases everything at once and, if the cycle needed more
+// than one block, merges them into a single block of the combined size so the next cycle
+// of the same shape makes no allocator calls at all.
+class MemoryArena {
+public:
+    // Position to rewind to; see ArenaScope. Only valid until the next reset().
+    struct Marker {
+        size_t block;
+        size_t offset;
+        uint64_t generation;
+    };
+
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+
+    const char* name;
+    size_t defaultBlockSize;
+    std::vector<Block> blocks;
+    size_t current;             // Block being filled
+    size_t offset;              // Bytes used in the current block
+    size_t usedBeforeCurrent;   // Bytes used in earlier blocks this cycle
+    size_t capacity;
+    size_t highWater;
+    uint64_t blockAllocations;  // Calls to the system allocator
+    uint64_t generation;        // Incremented by reset(); invalidates older markers
+
+    void addBlock(size_t minimumSize);
+
+public:
+    explicit MemoryArena(const char* name, size_t blockSize = 64 * 1024);
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // Uninitialized storage for trivially destructible values (the arena runs no destructors)
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destroyed");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void reset();
+    Marker mark() const { return Marker{current, offset, generation}; }
+    // Free everything allocated since the marker. Markers taken before the last reset() may
+    // point into blocks it merged away; they are rejected and the arena is left as it is.
+    bool rewind(const Marker& marker);
+
+    const char* getName() const { return name; }
+    size_t getUsed() const { return usedBeforeCurrent + offset; }
+    size_t getCapacity() const { return capacity; }
+    size_t getHighWater() const { return highWater; }
+    int getBlockCount() const { return static_cast<int>(blocks.size()); }
+    uint64_t getBlockAllocations() const { return blockAllocations; }
+};
+
+// Rewinds an arena to where it was when the scope began
+class ArenaScope {
+private:
+    MemoryArena& arena;
+    MemoryArena::Marker marker;
+
+public:
+    explicit ArenaScope(MemoryArena& arena_) : arena(arena_), marker(arena_.mark()) {}
+    ~ArenaScope() { arena.rewind(marker); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+// Standard allocator over an arena; deallocation is a no-op until the arena resets
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    MemoryArena* arena;
+
+    explicit ArenaAllocator(MemoryArena& arena_) : arena(&arena_) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Per-thread arenas shared by the core
+namespace memory {
+
+// Scratch that lives until the end of the current simulation tick
+MemoryArena& frameArena();
+// Temporaries of asset and table processing (parsing, trim solving)
+MemoryArena& loadArena();
+
+// Called once per frame by whatever owns it (scheduler, server session, or JS through the
+// beginFrame binding) before stepping; never by the individual simulation wrappers
+void beginFrame();
+
+} // namespace memory
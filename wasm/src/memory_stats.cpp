@@ -0,0 +1,221 @@
+#include "memory_stats.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// YSFLIGHT_NO_ALLOCATION_TRACKING keeps the system allocator (slim builds); the scopes
+// still compile and the statistics stay at zero.
+
+namespace {
+
+// Stored just before every pointer handed out; keeps the allocation 16-byte aligned
+struct AllocationHeader {
+    uint64_t size;
+    uint32_t tag;
+    uint32_t offset;    // From the start of the underlying block to the user pointer
+};
+static_assert(sizeof(AllocationHeader) == 16, "header must keep 16-byte alignment");
+
+const size_t kHeaderSize = sizeof(AllocationHeader);
+const int kReportedHotPathAllocations = 8;
+
+std::atomic<int64_t> tagCurrent[MEM_TAG_COUNT];
+std::atomic<int64_t> tagPeak[MEM_TAG_COUNT];
+std::atomic<uint64_t> tagAllocations[MEM_TAG_COUNT];
+std::atomic<int64_t> totalCurrent(0);
+std::atomic<int64_t> totalPeak(0);
+std::atomic<bool> hotPathCheck(false);
+std::atomic<uint64_t> hotPathAllocations(0);
+
+thread_local int currentTag = MEM_OTHER;
+thread_local int hotPathDepth = 0;
+thread_local uint64_t threadAllocations = 0;
+thread_local uint64_t frameStartAllocations = 0;
+thread_local uint64_t lastFrameAllocations = 0;
+
+#ifndef YSFLIGHT_NO_ALLOCATION_TRACKING
+thread_local bool reporting = false;
+
+void raisePeak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+void record(const AllocationHeader& header) {
+    const int64_t size = static_cast<int64_t>(header.size);
+    raisePeak(tagPeak[header.tag], tagCurrent[header.tag].fetch_add(size, std::memory_order_relaxed) + size);
+    raisePeak(totalPeak, totalCurrent.fetch_add(size, std::memory_order_relaxed) + size);
+    tagAllocations[header.tag].fetch_add(1, std::memory_order_relaxed);
+    threadAllocations++;
+
+    if (hotPathDepth > 0 && !reporting && hotPathCheck.load(std::memory_order_relaxed)) {
+        uint64_t count = hotPathAllocations.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (count <= static_cast<uint64_t>(kReportedHotPathAllocations)) {
+            reporting = true;
+            std::fprintf(stderr, "hot path allocation #%llu: %llu bytes (%s)\n",
+                         static_cast<unsigned long long>(count), static_cast<unsigned long long>(header.size),
+                         memory::tagName(static_cast<int>(header.tag)));
+            reporting = false;
+        }
+    }
+}
+
+void* trackedAllocate(size_t size, size_t alignment) {
+    // Over-aligned requests put the header in a leading gap of 'alignment' bytes
+    const size_t offset = alignment > kHeaderSize ? alignment : kHeaderSize;
+    void* block;
+    if (alignment > kHeaderSize) {
+        size_t total = (offset + size + alignment - 1) & ~(alignment - 1);
+        block = std::aligned_alloc(alignment, total);
+    } else {
+        block = std::malloc(offset + size);
+    }
+    if (!block) {
+        return nullptr;
+    }
+
+    uint8_t* user = static_cast<uint8_t*>(block) + offset;
+    AllocationHeader* header = reinterpret_cast<AllocationHeader*>(user - kHeaderSize);
+    header->size = size;
+    header->tag = static_cast<uint32_t>(currentTag);
+    header->offset = static_cast<uint32_t>(offset);
+    record(*header);
+    return user;
+}
+
+void trackedFree(void* pointer) {
+    if (!pointer) {
+        return;
+    }
+    uint8_t* user = static_cast<uint8_t*>(pointer);
+    const AllocationHeader* header = reinterpret_cast<const AllocationHeader*>(user - kHeaderSize);
+    const int64_t size = static_cast<int64_t>(header->size);
+    tagCurrent[header->tag].fetch_sub(size, std::memory_order_relaxed);
+    totalCurrent.fetch_sub(size, std::memory_order_relaxed);
+    std::free(user - header->offset);
+}
+
+void* allocateOrThrow(size_t size, size_t alignment) {
+    void* pointer = trackedAllocate(size > 0 ? size : 1, alignment);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+#endif
+
+} // namespace
+
+namespace memory {
+
+const char* tagName(int tag) {
+    static const char* names[MEM_TAG_COUNT] = {"other", "physics", "assets", "recorder", "network", "particles"};
+    return tag >= 0 && tag < MEM_TAG_COUNT ? names[tag] : "unknown";
+}
+
+MemoryTagStats getTagStats(int tag) {
+    MemoryTagStats stats = {0, 0, 0};
+    if (tag >= 0 && tag < MEM_TAG_COUNT) {
+        stats.currentBytes = tagCurrent[tag].load(std::memory_order_relaxed);
+        stats.peakBytes = tagPeak[tag].load(std::memory_order_relaxed);
+        stats.allocations = tagAllocations[tag].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+int64_t getCurrentBytes() {
+    return totalCurrent.load(std::memory_order_relaxed);
+}
+
+int64_t getPeakBytes() {
+    return totalPeak.load(std::memory_order_relaxed);
+}
+
+uint64_t getAllocationCount() {
+    uint64_t total = 0;
+    for (int tag = 0; tag < MEM_TAG_COUNT; ++tag) {
+        total += tagAllocations[tag].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t getLastFrameAllocations() {
+    return lastFrameAllocations;
+}
+
+void resetPeaks() {
+    for (int tag = 0; tag < MEM_TAG_COUNT; ++tag) {
+        tagPeak[tag].store(tagCurrent[tag].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    totalPeak.store(totalCurrent.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void setHotPathCheck(bool enabled) {
+    hotPathCheck.store(enabled, std::memory_order_relaxed);
+}
+
+bool getHotPathCheck() {
+    return hotPathCheck.load(std::memory_order_relaxed);
+}
+
+uint64_t getHotPathAllocations() {
+    return hotPathAllocations.load(std::memory_order_relaxed);
+}
+
+void markFrame() {
+    lastFrameAllocations = threadAllocations - frameStartAllocations;
+    frameStartAllocations = threadAllocations;
+}
+
+} // namespace memory
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag) : previous(currentTag) {
+    currentTag = tag;
+}
+
+MemoryTagScope::~MemoryTagScope() {
+    currentTag = previous;
+}
+
+HotPathScope::HotPathScope() {
+    hotPathDepth++;
+}
+
+HotPathScope::~HotPathScope() {
+    hotPathDepth--;
+}
+
+#ifndef YSFLIGHT_NO_ALLOCATION_TRACKING
+// Replacement global allocation functions
+void* operator new(size_t size) { return allocateOrThrow(size, 0); }
+void* operator new[](size_t size) { return allocateOrThrow(size, 0); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size > 0 ? size : 1, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size > 0 ? size : 1, 0); }
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size > 0 ? size : 1, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size > 0 ? size : 1, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Subsystems heap allocations are charged to
+enum MemoryTag {
+    MEM_OTHER = 0,      // Anything outside a tagged scope
+    MEM_PHYSICS,
+    MEM_ASSETS,
+    MEM_RECORDER,
+    MEM_NETWORK,
+    MEM_PARTICLES,      // Reserved for effects; no native users yet
+    MEM_TAG_COUNT
+};
+
+struct MemoryTagStats {
+    int64_t currentBytes;
+    int64_t peakBytes;
+    uint64_t allocations;   // Since start
+};
+
+// Allocation tracking. The global operator new/delete of the module record the size and
+// the active tag of every allocation in a small header, so current and peak bytes per
+// subsystem are exact without changing container types.
+namespace memory {
+
+const char* tagName(int tag);
+MemoryTagStats getTagStats(int tag);
+int64_t getCurrentBytes();
+int64_t getPeakBytes();
+uint64_t getAllocationCount();
+// Allocations made on this thread during the previous frame (between beginFrame calls)
+uint64_t getLastFrameAllocations();
+// Start the peaks over from the current values
+void resetPeaks();
+
+// Debug check: count (and report the first few) allocations made inside a HotPathScope
+void setHotPathCheck(bool enabled);
+bool getHotPathCheck();
+uint64_t getHotPathAllocations();
+
+// Frame boundary for the per-frame count; called from memory::beginFrame
+void markFrame();
+
+} // namespace memory
+
+// Charges allocations on this thread to a tag until the scope ends
+class MemoryTagScope {
+private:
+    int previous;
+
+public:
+    explicit MemoryTagScope(MemoryTag tag);
+    ~MemoryTagScope();
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+};
+
+// Marks the simulation hot path, where the allocation check expects no allocations
+class HotPathScope {
+public:
+    HotPathScope();
+    ~HotPathScope();
+
+    HotPathScope(const HotPathScope&) = delete;
+    HotPathScope& operator=(const HotPathScope&) = delete;
+};
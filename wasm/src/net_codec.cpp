@@ -0,0 +1,536 @@
+#include "net_codec.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const float kPi = static_cast<float>(M_PI);
+
+const NetFieldRange kFieldRanges[NET_FIELD_COUNT] = {
+    {-131072.0f, 131072.0f, 24, 12, false},     // Position x: 1.6 cm
+    {-1024.0f, 31744.0f, 21, 12, false},        // Position y
+    {-131072.0f, 131072.0f, 24, 12, false},     // Position z
+    {-1024.0f, 1024.0f, 17, 8, false},          // Velocity: 1.6 cm/s
+    {-1024.0f, 1024.0f, 17, 8, false},
+    {-1024.0f, 1024.0f, 17, 8, false},
+    {-kPi, kPi, 16, 8, true},                   // Heading, pitch, roll
+    {-kPi, kPi, 16, 8, true},
+    {-kPi, kPi, 16, 8, true},
+    {-8.0f, 8.0f, 14, 6, false},                // Angular rates (rad/s)
+    {-8.0f, 8.0f, 14, 6, false},
+    {-8.0f, 8.0f, 14, 6, false},
+    {0.0f, 1.0f, 8, 4, false},                  // Throttle
+    {-1.0f, 1.0f, 8, 4, false},                 // Aileron, elevator, rudder
+    {-1.0f, 1.0f, 8, 4, false},
+    {-1.0f, 1.0f, 8, 4, false},
+    {0.0f, 32768.0f, 16, 6, false},             // Fuel: 0.5 kg
+};
+
+const int kBaselineAgeBits = 6;     // Enough for SnapshotEncoder::kHistorySize - 1
+
+uint32_t fieldMask(int bits) {
+    return bits >= 32 ? 0xffffffffu : (1u << bits) - 1;
+}
+
+int32_t signExtend(uint32_t value, int bits) {
+    return static_cast<int32_t>(value << (32 - bits)) >> (32 - bits);
+}
+
+uint32_t quantizeField(int field, float value) {
+    const NetFieldRange& range = kFieldRanges[field];
+    const uint32_t mask = fieldMask(range.bits);
+    if (range.wraps) {
+        float steps = static_cast<float>(mask) + 1.0f;
+        float scaled = (value - range.min) / (range.max - range.min) * steps;
+        if (!std::isfinite(scaled)) {
+            return 0;
+        }
+        // Reduce by whole turns first so huge angles cannot overflow the cast
+        float turns = std::fmod(std::floor(scaled + 0.5f), steps);
+        return static_cast<uint32_t>(static_cast<int64_t>(turns)) & mask;
+    }
+    float scaled = (value - range.min) / (range.max - range.min) * static_cast<float>(mask);
+    scaled = std::max(0.0f, std::min(static_cast<float>(mask), scaled));
+    return static_cast<uint32_t>(scaled + 0.5f);
+}
+
+float dequantizeField(int field, uint32_t value) {
+    const NetFieldRange& range = kFieldRanges[field];
+    const uint32_t mask = fieldMask(range.bits);
+    float steps = range.wraps ? static_cast<float>(mask) + 1.0f : static_cast<float>(mask);
+    float result = range.min + static_cast<float>(value) / steps * (range.max - range.min);
+    if (range.wraps && result >= range.max) {
+        result -= range.max - range.min;
+    }
+    return result;
+}
+
+// Field coding against a baseline: unchanged, short delta or full value
+enum FieldCode { FIELD_UNCHANGED, FIELD_DELTA, FIELD_FULL };
+
+FieldCode classifyField(int field, uint32_t value, uint32_t baseline, int32_t& delta) {
+    const NetFieldRange& range = kFieldRanges[field];
+    delta = signExtend((value - baseline) & fieldMask(range.bits), range.bits);
+    if (delta == 0) {
+        return FIELD_UNCHANGED;
+    }
+    const int32_t limit = 1 << (range.deltaBits - 1);
+    return (delta >= -limit && delta < limit) ? FIELD_DELTA : FIELD_FULL;
+}
+
+size_t fieldBits(const NetEntityState& state, const NetEntityState* baseline) {
+    size_t bits = 0;
+    for (int i = 0; i < NET_FIELD_COUNT; ++i) {
+        const NetFieldRange& range = kFieldRanges[i];
+        if (!baseline) {
+            bits += range.bits;
+            continue;
+        }
+        int32_t delta;
+        switch (classifyField(i, state.values[i], baseline->values[i], delta)) {
+            case FIELD_UNCHANGED: bits += 1; break;
+            case FIELD_DELTA: bits += 2 + range.deltaBits; break;
+            case FIELD_FULL: bits += 2 + range.bits; break;
+        }
+    }
+    return bits;
+}
+
+void writeFields(BitWriter& writer, const NetEntityState& state, const NetEntityState* baseline) {
+    for (int i = 0; i < NET_FIELD_COUNT; ++i) {
+        const NetFieldRange& range = kFieldRanges[i];
+        if (!baseline) {
+            writer.writeBits(state.values[i], range.bits);
+            continue;
+        }
+        int32_t delta;
+        FieldCode code = classifyField(i, state.values[i], baseline->values[i], delta);
+        writer.writeBool(code != FIELD_UNCHANGED);
+        if (code == FIELD_DELTA) {
+            writer.writeBool(true);
+            writer.writeBits(static_cast<uint32_t>(delta) & fieldMask(range.deltaBits), range.deltaBits);
+        } else if (code == FIELD_FULL) {
+            writer.writeBool(false);
+            writer.writeBits(state.values[i], range.bits);
+        }
+    }
+}
+
+void readFields(BitReader& reader, NetEntityState& state, const NetEntityState* baseline) {
+    for (int i = 0; i < NET_FIELD_COUNT; ++i) {
+        const NetFieldRange& range = kFieldRanges[i];
+        if (!baseline) {
+            state.values[i] = reader.readBits(range.bits);
+            continue;
+        }
+        if (!reader.readBool()) {
+            state.values[i] = baseline->values[i];
+        } else if (reader.readBool()) {
+            int32_t delta = signExtend(reader.readBits(range.deltaBits), range.deltaBits);
+            state.values[i] = (baseline->values[i] + static_cast<uint32_t>(delta)) & fieldMask(range.bits);
+        } else {
+            state.values[i] = reader.readBits(range.bits);
+        }
+    }
+}
+
+bool sequenceNewer(uint16_t a, uint16_t b) {
+    return static_cast<int16_t>(a - b) > 0;
+}
+
+} // namespace
+
+// BitWriter implementation
+BitWriter::BitWriter(uint8_t* buffer_, size_t capacityBytes)
+    : buffer(buffer_), capacityBits(capacityBytes * 8), positionBits(0), overflow(false) {
+}
+
+void BitWriter::writeBits(uint32_t value, int bits) {
+    if (positionBits + bits > capacityBits) {
+        overflow = true;
+        return;
+    }
+    for (int i = 0; i < bits; ) {
+        size_t byte = positionBits >> 3;
+        int bitOffset = static_cast<int>(positionBits & 7);
+        int count = std::min(8 - bitOffset, bits - i);
+        uint32_t chunk = (value >> i) & ((1u << count) - 1);
+        if (bitOffset == 0) {
+            buffer[byte] = 0;
+        }
+        buffer[byte] |= static_cast<uint8_t>(chunk << bitOffset);
+        positionBits += count;
+        i += count;
+    }
+}
+
+// BitReader implementation
+BitReader::BitReader(const uint8_t* data_, size_t sizeBytes)
+    : data(data_), sizeBits(sizeBytes * 8), positionBits(0), error(false) {
+}
+
+uint32_t BitReader::readBits(int bits) {
+    if (positionBits + bits > sizeBits) {
+        error = true;
+        positionBits = sizeBits;
+        return 0;
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < bits; ) {
+        size_t byte = positionBits >> 3;
+        int bitOffset = static_cast<int>(positionBits & 7);
+        int count = std::min(8 - bitOffset, bits - i);
+        uint32_t chunk = (static_cast<uint32_t>(data[byte]) >> bitOffset) & ((1u << count) - 1);
+        value |= chunk << i;
+        positionBits += count;
+        i += count;
+    }
+    return value;
+}
+
+// Quantization
+const NetFieldRange& getNetFieldRange(int field) {
+    return kFieldRanges[field];
+}
+
+void quantizeNetState(const AircraftState& state, float fuel, NetEntityState& out) {
+    const float values[NET_FIELD_COUNT] = {
+        state.position.x, state.position.y, state.position.z,
+        state.velocity.x, state.velocity.y, state.velocity.z,
+        state.heading, state.pitch, state.roll,
+        state.headingRate, state.pitchRate, state.rollRate,
+        state.throttle, state.aileron, state.elevator, state.rudder,
+        fuel
+    };
+    for (int i = 0; i < NET_FIELD_COUNT; ++i) {
+        out.values[i] = quantizeField(i, values[i]);
+    }
+}
+
+void dequantizeNetState(const NetEntityState& in, AircraftState& state, float& fuel) {
+    float values[NET_FIELD_COUNT];
+    for (int i = 0; i < NET_FIELD_COUNT; ++i) {
+        values[i] = dequantizeField(i, in.values[i]);
+    }
+    state.position = Vec3(values[NET_POSITION_X], values[NET_POSITION_Y], values[NET_POSITION_Z]);
+    state.velocity = Vec3(values[NET_VELOCITY_X], values[NET_VELOCITY_Y], values[NET_VELOCITY_Z]);
+    state.heading = values[NET_HEADING];
+    state.pitch = values[NET_PITCH];
+    state.roll = values[NET_ROLL];
+    state.headingRate = values[NET_HEADING_RATE];
+    state.pitchRate = values[NET_PITCH_RATE];
+    state.rollRate = values[NET_ROLL_RATE];
+    state.throttle = values[NET_THROTTLE];
+    state.aileron = values[NET_AILERON];
+    state.elevator = values[NET_ELEVATOR];
+    state.rudder = values[NET_RUDDER];
+    fuel = values[NET_FUEL];
+
+    state.altitude = state.position.y;
+    state.airspeed = state.velocity.length();
+}
+
+// SnapshotEncoder implementation
+SnapshotEncoder::SnapshotEncoder(size_t packetBudget_)
+    : nextSequence(0), packetBudget(packetBudget_) {
+    for (SentPacket& packet : history) {
+        packet.sequence = 0;
+        packet.acknowledged = true;     // Nothing to acknowledge yet
+    }
+}
+
+void SnapshotEncoder::setEntity(uint16_t id, const NetEntityState& state, float priority) {
+    if (id >= entities.size()) {
+        Entity inactive = {};
+        entities.resize(static_cast<size_t>(id) + 1, inactive);
+    }
+    Entity& entity = entities[id];
+    if (!entity.active) {
+        entity.active = true;
+        entity.accumulator = 0;
+        entity.hasBaseline = false;
+        despawns.erase(std::remove(despawns.begin(), despawns.end(), id), despawns.end());
+    }
+    entity.state = state;
+    entity.priority = priority;
+}
+
+void SnapshotEncoder::removeEntity(uint16_t id) {
+    if (id >= entities.size() || !entities[id].active) {
+        return;
+    }
+    Entity& entity = entities[id];
+    entity.active = false;
+    entity.hasBaseline = false;
+    entity.removedSequence = nextSequence;
+    despawns.push_back(id);
+}
+
+size_t SnapshotEncoder::writePacket(uint8_t* buffer, size_t capacity) {
+    const size_t budgetBits = std::min(capacity, packetBudget) * 8;
+    const uint16_t sequence = nextSequence++;
+
+    // Accumulate priority; baselines older than the peer's history cannot be referenced
+    candidates.clear();
+    for (size_t id = 0; id < entities.size(); ++id) {
+        Entity& entity = entities[id];
+        if (!entity.active || entity.priority <= 0) {
+            continue;
+        }
+        entity.accumulator += entity.priority;
+        if (entity.hasBaseline && static_cast<uint16_t>(sequence - entity.baselineSequence) >= kHistorySize) {
+            entity.hasBaseline = false;
+        }
+        candidates.push_back(static_cast<uint16_t>(id));
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](uint16_t a, uint16_t b) {
+        float priorityA = entities[a].accumulator;
+        float priorityB = entities[b].accumulator;
+        return priorityA != priorityB ? priorityA > priorityB : a < b;
+    });
+
+    // Despawns first, then the highest accumulated priority while the worst-case size still fits
+    size_t usedBits = 16 + 1 + 1;   // Sequence and the two end markers
+    size_t despawnCount = 0;
+    while (despawnCount < despawns.size() && usedBits + 17 <= budgetBits) {
+        usedBits += 17;
+        despawnCount++;
+    }
+    chosen.clear();
+    for (uint16_t id : candidates) {
+        const Entity& entity = entities[id];
+        size_t bits = 1 + 17 + 1 + (entity.hasBaseline ? kBaselineAgeBits : 0) +
+                      fieldBits(entity.state, entity.hasBaseline ? &entity.baseline : nullptr);
+        if (usedBits + bits <= budgetBits) {
+            usedBits += bits;
+            chosen.push_back(id);
+        }
+    }
+    std::sort(chosen.begin(), chosen.end());
+
+    BitWriter writer(buffer, budgetBits / 8);
+    writer.writeBits(sequence, 16);
+
+    SentPacket& sent = history[sequence % kHistorySize];
+    sent.sequence = sequence;
+    sent.acknowledged = false;
+    sent.ids.clear();
+    sent.states.clear();
+    sent.despawns.assign(despawns.begin(), despawns.begin() + despawnCount);
+
+    int previousId = -1;
+    for (uint16_t id : chosen) {
+        Entity& entity = entities[id];
+        writer.writeBool(true);
+        bool consecutive = previousId >= 0 && id == previousId + 1;
+        writer.writeBool(consecutive);
+        if (!consecutive) {
+            writer.writeBits(id, 16);
+        }
+        writer.writeBool(entity.hasBaseline);
+        if (entity.hasBaseline) {
+            writer.writeBits(static_cast<uint16_t>(sequence - entity.baselineSequence), kBaselineAgeBits);
+        }
+        writeFields(writer, entity.state, entity.hasBaseline ? &entity.baseline : nullptr);
+
+        entity.accumulator = 0;
+        sent.ids.push_back(id);
+        sent.states.push_back(entity.state);
+        previousId = id;
+    }
+    writer.writeBool(false);
+
+    for (uint16_t id : sent.despawns) {
+        writer.writeBool(true);
+        writer.writeBits(id, 16);
+    }
+    writer.writeBool(false);
+
+    return writer.getBytesWritten();
+}
+
+void SnapshotEncoder::acknowledge(uint16_t sequence) {
+    SentPacket& sent = history[sequence % kHistorySize];
+    if (sent.acknowledged || sent.sequence != sequence) {
+        return;
+    }
+    sent.acknowledged = true;
+
+    for (size_t i = 0; i < sent.ids.size(); ++i) {
+        if (sent.ids[i] >= entities.size()) {
+            continue;
+        }
+        Entity& entity = entities[sent.ids[i]];
+        if (entity.active && (!entity.hasBaseline || sequenceNewer(sequence, entity.baselineSequence))) {
+            entity.baseline = sent.states[i];
+            entity.baselineSequence = sequence;
+            entity.hasBaseline = true;
+        }
+    }
+
+    // Despawns the peer now has, unless the entity was removed again after this packet
+    for (uint16_t id : sent.despawns) {
+        const Entity& entity = entities[id];
+        if (!entity.active && !sequenceNewer(entity.removedSequence, sequence)) {
+            despawns.erase(std::remove(despawns.begin(), despawns.end(), id), despawns.end());
+        }
+    }
+}
+
+// SnapshotDecoder implementation
+SnapshotDecoder::SnapshotDecoder() : lastSequence(0), hasSequence(false) {
+    for (ReceivedPacket& packet : history) {
+        packet.valid = false;
+        packet.sequence = 0;
+    }
+}
+
+const NetEntityState* SnapshotDecoder::findBaseline(uint16_t sequence, uint16_t id) const {
+    const ReceivedPacket& packet = history[sequence % SnapshotEncoder::kHistorySize];
+    if (!packet.valid || packet.sequence != sequence) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < packet.ids.size(); ++i) {
+        if (packet.ids[i] == id) {
+            return &packet.states[i];
+        }
+    }
+    return nullptr;
+}
+
+bool SnapshotDecoder::readPacket(const uint8_t* data, size_t size, uint16_t& sequence) {
+    BitReader reader(data, size);
+    sequence = static_cast<uint16_t>(reader.readBits(16));
+
+    pendingIds.clear();
+    pendingStates.clear();
+    int previousId = -1;
+    while (!reader.hasError() && reader.readBool()) {
+        int id;
+        if (reader.readBool()) {
+            if (previousId < 0 || previousId == 0xffff) {
+                return false;
+            }
+            id = previousId + 1;
+        } else {
+            id = static_cast<int>(reader.readBits(16));
+        }
+
+        const NetEntityState* baseline = nullptr;
+        if (reader.readBool()) {
+            uint16_t age = static_cast<uint16_t>(reader.readBits(kBaselineAgeBits));
+            baseline = age == 0 ? nullptr : findBaseline(static_cast<uint16_t>(sequence - age),
+                                                          static_cast<uint16_t>(id));
+            if (!baseline) {
+                return false;
+            }
+        }
+
+        NetEntityState state;
+        readFields(reader, state, baseline);
+        pendingIds.push_back(static_cast<uint16_t>(id));
+        pendingStates.push_back(state);
+        previousId = id;
+    }
+    pendingDespawns.clear();
+    while (!reader.hasError() && reader.readBool()) {
+        pendingDespawns.push_back(static_cast<uint16_t>(reader.readBits(16)));
+    }
+    if (reader.hasError()) {
+        return false;
+    }
+
+    // Keep the packet as a baseline for later ones
+    ReceivedPacket& packet = history[sequence % SnapshotEncoder::kHistorySize];
+    packet.valid = true;
+    packet.sequence = sequence;
+    packet.ids.swap(pendingIds);
+    packet.states.swap(pendingStates);
+
+    updated.clear();
+    for (size_t i = 0; i < packet.ids.size(); ++i) {
+        uint16_t id = packet.ids[i];
+        if (id >= entities.size()) {
+            Entity missing = {};
+            entities.resize(static_cast<size_t>(id) + 1, missing);
+        }
+        Entity& entity = entities[id];
+        if ((!entity.received && !entity.removed) || sequenceNewer(sequence, entity.sequence)) {
+            entity.received = true;
+            entity.removed = false;
+            entity.sequence = sequence;
+            entity.state = packet.states[i];
+            updated.push_back(id);
+        }
+    }
+
+    // A despawn only wins over states from older packets
+    removed.clear();
+    for (uint16_t id : pendingDespawns) {
+        if (id >= entities.size()) {
+            Entity missing = {};
+            entities.resize(static_cast<size_t>(id) + 1, missing);
+        }
+        Entity& entity = entities[id];
+        if ((!entity.received && !entity.removed) || sequenceNewer(sequence, entity.sequence)) {
+            if (entity.received) {
+                removed.push_back(id);
+            }
+            entity.received = false;
+            entity.removed = true;
+            entity.sequence = sequence;
+        }
+    }
+
+    if (!hasSequence || sequenceNewer(sequence, lastSequence)) {
+        lastSequence = sequence;
+        hasSequence = true;
+    }
+    return true;
+}
+
+bool SnapshotDecoder::getEntity(uint16_t id, NetEntityState& state) const {
+    if (id >= entities.size() || !entities[id].received) {
+        return false;
+    }
+    state = entities[id].state;
+    return true;
+}
+
+// LoopbackChannel implementation
+LoopbackChannel::LoopbackChannel(int latencyTicks_, float lossRate_, uint32_t seed)
+    : head(0), queued(0), latencyTicks(latencyTicks_), lossRate(lossRate_), randomState(seed), tick(0),
+      bytesSent(0) {
+}
+
+void LoopbackChannel::send(const uint8_t* data, size_t size) {
+    bytesSent += size;
+
+    // Linear congruential generator keeps losses reproducible
+    randomState = randomState * 1664525u + 1013904223u;
+    if (static_cast<float>(randomState >> 8) * (1.0f / 16777216.0f) < lossRate) {
+        return;
+    }
+
+    if (queued == ring.size()) {
+        // Unroll the ring so the queue starts at slot 0, then grow it
+        std::rotate(ring.begin(), ring.begin() + head, ring.end());
+        ring.resize(std::max<size_t>(8, ring.size() * 2));
+        head = 0;
+    }
+    Packet& packet = ring[(head + queued) % ring.size()];
+    packet.deliveryTick = tick + latencyTicks;
+    packet.data.assign(data, data + size);
+    queued++;
+}
+
+bool LoopbackChannel::receive(std::vector<uint8_t>& data) {
+    if (queued == 0 || ring[head].deliveryTick > tick) {
+        return false;
+    }
+    // The caller's previous buffer stays in the slot for a later send
+    data.swap(ring[head].data);
+    head = (head + 1) % ring.size();
+    queued--;
+    return true;
+}
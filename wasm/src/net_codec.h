@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "simulation.h"
+
+// Bit-packed writer over a caller-provided buffer; sets overflow instead of writing past the end
+class BitWriter {
+private:
+    uint8_t* buffer;
+    size_t capacityBits;
+    size_t positionBits;
+    bool overflow;
+
+public:
+    BitWriter(uint8_t* buffer, size_t capacityBytes);
+
+    void writeBits(uint32_t value, int bits);   // bits <= 32, least significant first
+    void writeBool(bool value) { writeBits(value ? 1u : 0u, 1); }
+
+    size_t getBitsWritten() const { return positionBits; }
+    size_t getBytesWritten() const { return (positionBits + 7) / 8; }
+    bool hasOverflowed() const { return overflow; }
+};
+
+// Reader matching BitWriter; reads past the end return zero and set the error flag
+class BitReader {
+private:
+    const uint8_t* data;
+    size_t sizeBits;
+    size_t positionBits;
+    bool error;
+
+public:
+    BitReader(const uint8_t* data, size_t sizeBytes);
+
+    uint32_t readBits(int bits);
+    bool readBool() { return readBits(1) != 0; }
+
+    size_t getBitsRemaining() const { return positionBits < sizeBits ? sizeBits - positionBits : 0; }
+    bool hasError() const { return error; }
+};
+
+// Replicated aircraft fields
+enum NetField {
+    NET_POSITION_X = 0, NET_POSITION_Y, NET_POSITION_Z,
+    NET_VELOCITY_X, NET_VELOCITY_Y, NET_VELOCITY_Z,
+    NET_HEADING, NET_PITCH, NET_ROLL,
+    NET_HEADING_RATE, NET_PITCH_RATE, NET_ROLL_RATE,
+    NET_THROTTLE, NET_AILERON, NET_ELEVATOR, NET_RUDDER,
+    NET_FUEL,
+    NET_FIELD_COUNT
+};
+
+// Quantization of one field: [min, max] mapped onto 'bits' bits (wrapping for angles);
+// deltas of up to 'deltaBits' bits (signed) are sent in short form
+struct NetFieldRange {
+    float min;
+    float max;
+    int bits;
+    int deltaBits;
+    bool wraps;
+};
+
+const NetFieldRange& getNetFieldRange(int field);
+
+// Quantized aircraft state as sent on the wire
+struct NetEntityState {
+    uint32_t values[NET_FIELD_COUNT];
+};
+
+void quantizeNetState(const AircraftState& state, float fuel, NetEntityState& out);
+// Rebuild state; derived fields (altitude, airspeed) are recomputed, thrust and mass are left as is
+void dequantizeNetState(const NetEntityState& in, AircraftState& state, float& fuel);
+
+// Sender side of the snapshot stream to one peer.
+// Each packet carries as many entities as fit in the byte budget, chosen by accumulated
+// priority. Entities are delta-encoded against the newest state the peer has acknowledged.
+// Removed entities are announced with despawn records, repeated until a packet carrying
+// them is acknowledged.
+class SnapshotEncoder {
+public:
+    static const int kHistorySize = 64;     // Packets remembered for acknowledgement
+
+private:
+    struct Entity {
+        bool active;
+        NetEntityState state;
+        float priority;             // Added to the accumulator every packet
+        float accumulator;
+        bool hasBaseline;
+        uint16_t baselineSequence;
+        NetEntityState baseline;
+        uint16_t removedSequence;   // First packet that could carry the despawn
+    };
+
+    struct SentPacket {
+        uint16_t sequence;
+        bool acknowledged;
+        std::vector<uint16_t> ids;
+        std::vector<NetEntityState> states;
+        std::vector<uint16_t> despawns;
+    };
+
+    std::vector<Entity> entities;           // Indexed by entity id
+    std::vector<uint16_t> despawns;         // Removed entities not yet acknowledged by the peer
+    SentPacket history[kHistorySize];
+    uint16_t nextSequence;
+    size_t packetBudget;
+    std::vector<uint16_t> candidates;       // Scratch for entity selection
+    std::vector<uint16_t> chosen;
+
+public:
+    explicit SnapshotEncoder(size_t packetBudget = 400);
+
+    // Current state and priority of an entity; priority 0 stops sending it
+    void setEntity(uint16_t id, const NetEntityState& state, float priority);
+    // Stop sending the entity and tell the peer to drop it
+    void removeEntity(uint16_t id);
+
+    // Write the next packet (at most min(capacity, budget) bytes) and return its size
+    size_t writePacket(uint8_t* buffer, size_t capacity);
+
+    // The peer received the packet with this sequence number
+    void acknowledge(uint16_t sequence);
+
+    void setPacketBudget(size_t bytes) { packetBudget = bytes; }
+    size_t getPacketBudget() const { return packetBudget; }
+    uint16_t getNextSequence() const { return nextSequence; }
+};
+
+// Receiver side of a snapshot stream
+class SnapshotDecoder {
+private:
+    struct Entity {
+        bool received;
+        bool removed;               // Despawned; only states newer than 'sequence' bring it back
+        uint16_t sequence;          // Packet the current state (or despawn) came from
+        NetEntityState state;
+    };
+
+    struct ReceivedPacket {
+        bool valid;
+        uint16_t sequence;
+        std::vector<uint16_t> ids;
+        std::vector<NetEntityState> states;
+    };
+
+    std::vector<Entity> entities;
+    ReceivedPacket history[SnapshotEncoder::kHistorySize];
+    std::vector<uint16_t> updated;
+    std::vector<uint16_t> removed;
+    std::vector<uint16_t> pendingIds;       // Scratch for decoding before commit
+    std::vector<NetEntityState> pendingStates;
+    std::vector<uint16_t> pendingDespawns;
+    uint16_t lastSequence;
+    bool hasSequence;
+
+    const NetEntityState* findBaseline(uint16_t sequence, uint16_t id) const;
+
+public:
+    SnapshotDecoder();
+
+    // Decode a packet; returns false (and changes nothing) if it is malformed or its baseline is unknown
+    bool readPacket(const uint8_t* data, size_t size, uint16_t& sequence);
+
+    bool getEntity(uint16_t id, NetEntityState& state) const;
+    // Entities whose state changed in the last readPacket call
+    const std::vector<uint16_t>& getUpdatedEntities() const { return updated; }
+    // Entities dropped by despawn records in the last readPacket call
+    const std::vector<uint16_t>& getRemovedEntities() const { return removed; }
+    uint16_t getLastSequence() const { return lastSequence; }
+};
+
+// In-process packet channel with fixed latency and deterministic loss, for testing the codec
+class LoopbackChannel {
+private:
+    struct Packet {
+        int64_t deliveryTick;
+        std::vector<uint8_t> data;
+    };
+
+    // Ring of queued packets starting at 'head'; slots keep their buffers for reuse
+    std::vector<Packet> ring;
+    size_t head;
+    size_t queued;
+    int latencyTicks;
+    float lossRate;
+    uint32_t randomState;
+    int64_t tick;
+    size_t bytesSent;
+
+public:
+    LoopbackChannel(int latencyTicks = 0, float lossRate = 0.0f, uint32_t seed = 1);
+
+    void send(const uint8_t* data, size_t size);
+    // Next packet due at the current tick
+    bool receive(std::vector<uint8_t>& data);
+    void advance() { tick++; }
+
+    size_t getBytesSent() const { return bytesSent; }
+};
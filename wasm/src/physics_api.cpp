@@ -0,0 +1,110 @@
+#include "physics_api.h"
+#include <cstring>
+#include "aircraft_asset.h"
+#include "deterministic_math.h"
+#include "simulation.h"
+
+struct YsfAircraft {
+    FlightDynamics dynamics;
+};
+
+YsfAircraft* ysf_create(void) {
+    return new YsfAircraft();
+}
+
+void ysf_destroy(YsfAircraft* aircraft) {
+    delete aircraft;
+}
+
+int ysf_load_asset(YsfAircraft* aircraft, const uint8_t* data, size_t length) {
+    AircraftProperties props;
+    if (!deserializeAircraftProperties(data, length, props)) {
+        return 0;
+    }
+    aircraft->dynamics.setProperties(props);
+    return 1;
+}
+
+void ysf_set_aircraft_type(YsfAircraft* aircraft, const char* type) {
+    aircraft->dynamics.setAircraftType(type);
+}
+
+void ysf_initialize(YsfAircraft* aircraft, float x, float y, float z, float heading) {
+    aircraft->dynamics.initialize(Vec3(x, y, z), heading);
+}
+
+void ysf_set_throttle(YsfAircraft* aircraft, float throttle) {
+    aircraft->dynamics.setThrottle(throttle);
+}
+
+void ysf_set_controls(YsfAircraft* aircraft, float aileron, float elevator, float rudder) {
+    aircraft->dynamics.setControlSurfaces(aileron, elevator, rudder);
+}
+
+void ysf_set_deterministic(YsfAircraft* aircraft, int enabled) {
+    aircraft->dynamics.setDeterministic(enabled != 0);
+}
+
+void ysf_update(YsfAircraft* aircraft, float deltaTime) {
+    aircraft->dynamics.update(deltaTime);
+}
+
+void ysf_reset(YsfAircraft* aircraft) {
+    aircraft->dynamics.reset();
+}
+
+void ysf_get_state(const YsfAircraft* aircraft, float* out) {
+    const AircraftState& state = aircraft->dynamics.getState();
+    out[YSF_STATE_X] = state.position.x;
+    out[YSF_STATE_Y] = state.position.y;
+    out[YSF_STATE_Z] = state.position.z;
+    out[YSF_STATE_VX] = state.velocity.x;
+    out[YSF_STATE_VY] = state.velocity.y;
+    out[YSF_STATE_VZ] = state.velocity.z;
+    out[YSF_STATE_HEADING] = state.heading;
+    out[YSF_STATE_PITCH] = state.pitch;
+    out[YSF_STATE_ROLL] = state.roll;
+    out[YSF_STATE_HEADING_RATE] = state.headingRate;
+    out[YSF_STATE_PITCH_RATE] = state.pitchRate;
+    out[YSF_STATE_ROLL_RATE] = state.rollRate;
+    out[YSF_STATE_THROTTLE] = state.throttle;
+    out[YSF_STATE_THRUST] = state.thrust;
+    out[YSF_STATE_AILERON] = state.aileron;
+    out[YSF_STATE_ELEVATOR] = state.elevator;
+    out[YSF_STATE_RUDDER] = state.rudder;
+    out[YSF_STATE_MASS] = state.mass;
+    out[YSF_STATE_ALTITUDE] = state.altitude;
+    out[YSF_STATE_AIRSPEED] = state.airspeed;
+    out[YSF_STATE_FUEL] = aircraft->dynamics.getFuel();
+}
+
+void ysf_get_checksum(const YsfAircraft* aircraft, char* out) {
+    // Formatted by hand to keep printf out of the module
+    static const char digits[] = "0123456789abcdef";
+    uint64_t checksum = aircraft->dynamics.checksum(detmath::kHashSeed);
+    for (int i = 15; i >= 0; --i) {
+        out[i] = digits[checksum & 0xf];
+        checksum >>= 4;
+    }
+    out[16] = '\0';
+}
+
+size_t ysf_snapshot_size(void) {
+    return sizeof(FlightSnapshot);
+}
+
+void ysf_save_snapshot(const YsfAircraft* aircraft, void* out) {
+    FlightSnapshot snapshot;
+    aircraft->dynamics.save(snapshot);
+    std::memcpy(out, &snapshot, sizeof(snapshot));
+}
+
+int ysf_restore_snapshot(YsfAircraft* aircraft, const void* data, size_t length) {
+    if (length != sizeof(FlightSnapshot)) {
+        return 0;
+    }
+    FlightSnapshot snapshot;
+    std::memcpy(&snapshot, data, sizeof(snapshot));
+    aircraft->dynamics.restore(snapshot);
+    return 1;
+}
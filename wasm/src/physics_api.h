@@ -0,0 +1,63 @@
+#pragma once
+
+// C interface to FlightDynamics, exported by the slim physics module (ysflight-physics).
+// Handles are opaque; state is read as a float array in YSF_STATE_* order. Strings and
+// buffers are passed as pointers into module memory.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef YSF_API
+#ifdef __EMSCRIPTEN__
+#include <emscripten/em_macros.h>
+#define YSF_API EMSCRIPTEN_KEEPALIVE
+#else
+#define YSF_API
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct YsfAircraft YsfAircraft;
+
+// Layout of ysf_get_state output
+enum {
+    YSF_STATE_X, YSF_STATE_Y, YSF_STATE_Z,
+    YSF_STATE_VX, YSF_STATE_VY, YSF_STATE_VZ,
+    YSF_STATE_HEADING, YSF_STATE_PITCH, YSF_STATE_ROLL,
+    YSF_STATE_HEADING_RATE, YSF_STATE_PITCH_RATE, YSF_STATE_ROLL_RATE,
+    YSF_STATE_THROTTLE, YSF_STATE_THRUST,
+    YSF_STATE_AILERON, YSF_STATE_ELEVATOR, YSF_STATE_RUDDER,
+    YSF_STATE_MASS, YSF_STATE_ALTITUDE, YSF_STATE_AIRSPEED, YSF_STATE_FUEL,
+    YSF_STATE_COUNT
+};
+
+YSF_API YsfAircraft* ysf_create(void);
+YSF_API void ysf_destroy(YsfAircraft* aircraft);
+
+// Aircraft properties from a compiled asset (asset_api.h); returns 0 if it is malformed
+YSF_API int ysf_load_asset(YsfAircraft* aircraft, const uint8_t* data, size_t length);
+YSF_API void ysf_set_aircraft_type(YsfAircraft* aircraft, const char* type);
+
+YSF_API void ysf_initialize(YsfAircraft* aircraft, float x, float y, float z, float heading);
+YSF_API void ysf_set_throttle(YsfAircraft* aircraft, float throttle);
+YSF_API void ysf_set_controls(YsfAircraft* aircraft, float aileron, float elevator, float rudder);
+YSF_API void ysf_set_deterministic(YsfAircraft* aircraft, int enabled);
+YSF_API void ysf_update(YsfAircraft* aircraft, float deltaTime);
+YSF_API void ysf_reset(YsfAircraft* aircraft);
+
+// Writes YSF_STATE_COUNT floats
+YSF_API void ysf_get_state(const YsfAircraft* aircraft, float* out);
+// 16 hex digits and a terminator, as FlightSimulation.getChecksum() returns them
+YSF_API void ysf_get_checksum(const YsfAircraft* aircraft, char* out);
+
+YSF_API size_t ysf_snapshot_size(void);
+YSF_API void ysf_save_snapshot(const YsfAircraft* aircraft, void* out);
+// Returns 0 if length is not ysf_snapshot_size()
+YSF_API int ysf_restore_snapshot(YsfAircraft* aircraft, const void* data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
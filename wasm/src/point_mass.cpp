@@ -0,0 +1,5 @@
+#include "point_mass.h"
+
+void PointMassDynamics::update(float deltaTime) {
+    body.updatePointMass(deltaTime);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <memory>
+#include "simulation.h"
+
+// Point-mass variant of FlightDynamics, stepped with FlightDynamics::updatePointMass.
+// Used to extrapolate aircraft that are not fully simulated locally.
+class PointMassDynamics {
+private:
+    FlightDynamics body;    // State, properties and force model
+
+public:
+    PointMassDynamics() {}
+
+    void initialize(const Vec3& position, float heading) { body.initialize(position, heading); }
+    void setProperties(std::shared_ptr<const AircraftProperties> properties) { body.setProperties(properties); }
+    void setState(const AircraftState& state) { body.setState(state); }
+    void setFuel(float fuel) { body.setFuel(fuel); }
+    void setControls(const ControlInputs& controls) { body.setControls(controls); }
+
+    void update(float deltaTime);
+
+    const AircraftState& getState() const { return body.getState(); }
+    const AircraftProperties& getProperties() const { return body.getProperties(); }
+    const std::shared_ptr<const AircraftProperties>& getSharedProperties() const { return body.getSharedProperties(); }
+    float getFuel() const { return body.getFuel(); }
+
+    // Snapshots are interchangeable with FlightDynamics
+    void save(FlightSnapshot& snapshot) const { body.save(snapshot); }
+    void restore(const FlightSnapshot& snapshot) { body.restore(snapshot); }
+
+    void setDeterministic(bool enabled) { body.setDeterministic(enabled); }
+    bool isDeterministic() const { return body.isDeterministic(); }
+};
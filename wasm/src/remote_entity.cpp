@@ -0,0 +1,161 @@
+#include "remote_entity.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Exponential decay that also shrinks by at least minDelta, reaching zero in bounded time
+float decayMagnitude(float magnitude, float factor, float minDelta) {
+    return std::max(0.0f, std::min(magnitude * factor, magnitude - minDelta));
+}
+
+} // namespace
+
+RemoteEntitySet::RemoteEntitySet() : time(0.0) {
+}
+
+int RemoteEntitySet::addEntity(std::shared_ptr<const AircraftProperties> properties) {
+    PointMassDynamics model;
+    if (properties) {
+        model.setProperties(properties);
+    }
+    model.initialize(Vec3(0, 0, 0), 0);
+    models.push_back(model);
+    updateTimes.push_back(time);
+    received.push_back(0);
+    positionErrors.push_back(Vec3());
+    attitudeErrors.resize(attitudeErrors.size() + 3, 0.0f);
+    renderData.resize(renderData.size() + kRenderStride, 0.0f);
+
+    int index = static_cast<int>(models.size()) - 1;
+    writeRenderData(index);
+    return index;
+}
+
+int RemoteEntitySet::addEntity() {
+    return addEntity(nullptr);
+}
+
+void RemoteEntitySet::extrapolate(int index, float duration) {
+    while (duration > 0) {
+        float step = std::min(duration, smoothing.maxStep);
+        models[index].update(step);
+        duration -= step;
+    }
+}
+
+bool RemoteEntitySet::applyUpdate(int index, const AircraftState& state, float fuel, double stateTime) {
+    if (index < 0 || index >= size()) {
+        return false;
+    }
+    if (received[index] && stateTime < updateTimes[index]) {
+        return false;
+    }
+
+    // Currently displayed state
+    const float* shown = &renderData[static_cast<size_t>(index) * kRenderStride];
+    Vec3 shownPosition(shown[0], shown[1], shown[2]);
+
+    // Restart the extrapolation from the update and catch up to the present
+    PointMassDynamics& model = models[index];
+    model.setState(state);
+    model.setFuel(fuel);
+    float age = static_cast<float>(time - stateTime);
+    extrapolate(index, std::max(0.0f, std::min(smoothing.maxExtrapolation, age)));
+    updateTimes[index] = stateTime;
+
+    // Keep the jump as an offset so the display does not pop
+    const AircraftState& predicted = model.getState();
+    Vec3 positionError = shownPosition - predicted.position;
+    float* attitude = &attitudeErrors[static_cast<size_t>(index) * 3];
+    float headingError = wrapAngle(shown[3] - predicted.heading);
+    float pitchError = shown[4] - predicted.pitch;
+    float rollError = wrapAngle(shown[5] - predicted.roll);
+
+    bool snap = !received[index] ||
+                positionError.length() > smoothing.snapDistance ||
+                std::fabs(headingError) > smoothing.snapAngle ||
+                std::fabs(pitchError) > smoothing.snapAngle ||
+                std::fabs(rollError) > smoothing.snapAngle;
+    if (snap) {
+        positionErrors[index] = Vec3();
+        attitude[0] = attitude[1] = attitude[2] = 0.0f;
+    } else {
+        positionErrors[index] = positionError;
+        attitude[0] = headingError;
+        attitude[1] = pitchError;
+        attitude[2] = rollError;
+    }
+    received[index] = 1;
+
+    writeRenderData(index);
+    return true;
+}
+
+bool RemoteEntitySet::applyUpdate(int index, const NetEntityState& state, double stateTime) {
+    if (index < 0 || index >= size()) {
+        return false;
+    }
+    AircraftState decoded = models[index].getState();
+    float fuel;
+    dequantizeNetState(state, decoded, fuel);
+    return applyUpdate(index, decoded, fuel, stateTime);
+}
+
+void RemoteEntitySet::update(float deltaTime) {
+    time += deltaTime;
+
+    const float factor = std::exp(-deltaTime / smoothing.correctionTime);
+    const float minDistance = smoothing.minCorrectionSpeed * deltaTime;
+    const float minAngle = smoothing.minCorrectionRate * deltaTime;
+
+    const int count = size();
+    for (int i = 0; i < count; ++i) {
+        if (received[i] && time - updateTimes[i] <= smoothing.maxExtrapolation) {
+            extrapolate(i, deltaTime);
+        }
+
+        Vec3& positionError = positionErrors[i];
+        float length = positionError.length();
+        if (length > 0) {
+            positionError = positionError * (decayMagnitude(length, factor, minDistance) / length);
+        }
+
+        float* attitude = &attitudeErrors[static_cast<size_t>(i) * 3];
+        for (int axis = 0; axis < 3; ++axis) {
+            float magnitude = decayMagnitude(std::fabs(attitude[axis]), factor, minAngle);
+            attitude[axis] = std::copysign(magnitude, attitude[axis]);
+        }
+
+        writeRenderData(i);
+    }
+}
+
+void RemoteEntitySet::writeRenderData(int index) {
+    const AircraftState& state = models[index].getState();
+    const Vec3& positionError = positionErrors[index];
+    const float* attitude = &attitudeErrors[static_cast<size_t>(index) * 3];
+    float* out = &renderData[static_cast<size_t>(index) * kRenderStride];
+
+    out[0] = state.position.x + positionError.x;
+    out[1] = state.position.y + positionError.y;
+    out[2] = state.position.z + positionError.z;
+    out[3] = wrapAngle(state.heading + attitude[0]);
+    out[4] = state.pitch + attitude[1];
+    out[5] = wrapAngle(state.roll + attitude[2]);
+}
+
+AircraftState RemoteEntitySet::getDisplayState(int index) const {
+    AircraftState state = models[index].getState();
+    const float* shown = &renderData[static_cast<size_t>(index) * kRenderStride];
+    state.position = Vec3(shown[0], shown[1], shown[2]);
+    state.heading = shown[3];
+    state.pitch = shown[4];
+    state.roll = shown[5];
+    state.altitude = state.position.y;
+    return state;
+}
+
+bool RemoteEntitySet::isStale(int index) const {
+    return !received[index] || time - updateTimes[index] > smoothing.maxExtrapolation;
+}
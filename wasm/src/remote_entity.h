@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "net_codec.h"
+#include "point_mass.h"
+#include "simulation.h"
+
+// Correction blending limits for remote aircraft
+struct RemoteSmoothing {
+    float correctionTime;       // Time constant of the exponential error decay (s)
+    float minCorrectionSpeed;   // Error shrinks by at least this much per second (m/s)
+    float minCorrectionRate;    // Same for attitude (rad/s)
+    float snapDistance;         // Larger position errors are corrected instantly (m)
+    float snapAngle;            // Larger attitude errors are corrected instantly (rad)
+    float maxExtrapolation;     // Stop extrapolating this long after the last update (s)
+    float maxStep;              // Longest single extrapolation step (s)
+
+    RemoteSmoothing()
+        : correctionTime(0.2f), minCorrectionSpeed(2.0f), minCorrectionRate(0.2f),
+          snapDistance(150.0f), snapAngle(1.0f), maxExtrapolation(1.0f), maxStep(1.0f / 30.0f) {}
+};
+
+// Dead reckoning for aircraft whose state arrives over the network at a lower rate than frames.
+// Each entity is extrapolated with PointMassDynamics from its newest update. When an update
+// arrives, the jump between the displayed state and the corrected extrapolation is kept as an
+// error offset that decays to zero, so the displayed motion stays continuous. The offset never
+// exceeds the snap limits and shrinks at least at the minimum correction speed, so every
+// correction finishes within a bounded time.
+// All entities are advanced together by update(); render data is written to one flat buffer.
+class RemoteEntitySet {
+public:
+    static const int kRenderStride = 6;     // x, y, z, heading, pitch, roll
+
+private:
+    std::vector<PointMassDynamics> models;  // Extrapolated state per entity
+    std::vector<double> updateTimes;        // Sender time of the newest update (s)
+    std::vector<uint8_t> received;          // Entity has had at least one update
+    std::vector<Vec3> positionErrors;       // Displayed minus extrapolated position
+    std::vector<float> attitudeErrors;      // Heading, pitch, roll errors, 3 per entity
+    std::vector<float> renderData;          // kRenderStride floats per entity
+    RemoteSmoothing smoothing;
+    double time;                            // Current time on the sender's clock (s)
+
+    void extrapolate(int index, float duration);
+    void writeRenderData(int index);
+
+public:
+    RemoteEntitySet();
+
+    int addEntity(std::shared_ptr<const AircraftProperties> properties);
+    int addEntity();
+    int size() const { return static_cast<int>(models.size()); }
+
+    // State of an entity at the given sender time. Updates older than the entity's newest
+    // one, or for an index out of range, are ignored (returns false).
+    bool applyUpdate(int index, const AircraftState& state, float fuel, double stateTime);
+    bool applyUpdate(int index, const NetEntityState& state, double stateTime);
+
+    // Advance every entity and decay the correction offsets
+    void update(float deltaTime);
+
+    // Resynchronize with the sender's clock
+    void setTime(double newTime) { time = newTime; }
+    double getTime() const { return time; }
+
+    void setSmoothing(const RemoteSmoothing& newSmoothing) { smoothing = newSmoothing; }
+    const RemoteSmoothing& getSmoothing() const { return smoothing; }
+
+    // Extrapolated state without the display offset
+    const PointMassDynamics& getModel(int index) const { return models[index]; }
+    // Displayed state: extrapolated state with the correction offset applied
+    AircraftState getDisplayState(int index) const;
+    float getPositionError(int index) const { return positionErrors[index].length(); }
+    // No update within maxExtrapolation; the entity is frozen at its last extrapolated state
+    bool isStale(int index) const;
+
+    const std::vector<float>& getRenderData() const { return renderData; }
+};
@@ -0,0 +1,241 @@
+#include "replay.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+Vec3 lerp(const Vec3& a, const Vec3& b, float t) {
+    return Vec3(lerp(a.x, b.x, t), lerp(a.y, b.y, t), lerp(a.z, b.z, t));
+}
+
+// Cubic Hermite between two positions with velocity tangents over a span of dt seconds
+Vec3 hermite(const Vec3& p0, const Vec3& v0, const Vec3& p1, const Vec3& v1, float dt, float t) {
+    float t2 = t * t;
+    float t3 = t2 * t;
+    float h00 = 2 * t3 - 3 * t2 + 1;
+    float h10 = (t3 - 2 * t2 + t) * dt;
+    float h01 = -2 * t3 + 3 * t2;
+    float h11 = (t3 - t2) * dt;
+    return p0 * h00 + v0 * h10 + p1 * h01 + v1 * h11;
+}
+
+} // namespace
+
+Quat attitudeFromEuler(float heading, float pitch, float roll) {
+    // Yaw about +Y by -heading, then pitch about +Z, then roll about +X
+    float yaw = -heading * 0.5f;
+    Quat qYaw(0, std::sin(yaw), 0, std::cos(yaw));
+    Quat qPitch(0, 0, std::sin(pitch * 0.5f), std::cos(pitch * 0.5f));
+    Quat qRoll(std::sin(roll * 0.5f), 0, 0, std::cos(roll * 0.5f));
+    return qYaw * qPitch * qRoll;
+}
+
+void attitudeToEuler(const Quat& q, float& heading, float& pitch, float& roll) {
+    // Forward axis (first matrix column) and the Y components of the up and side axes
+    float forwardX = 1 - 2 * (q.y * q.y + q.z * q.z);
+    float forwardY = 2 * (q.x * q.y + q.w * q.z);
+    float forwardZ = 2 * (q.x * q.z - q.w * q.y);
+    float upY = 1 - 2 * (q.x * q.x + q.z * q.z);
+    float sideY = 2 * (q.y * q.z - q.w * q.x);
+
+    heading = std::atan2(forwardZ, forwardX);
+    pitch = std::asin(std::max(-1.0f, std::min(1.0f, forwardY)));
+    roll = std::atan2(-sideY, upY);
+}
+
+// TrackPlayer implementation
+TrackPlayer::TrackPlayer(const RecordedTrack& track_)
+    : track(&track_), decoder(track_), bracketed(false), atEnd(false) {
+}
+
+bool TrackPlayer::advance() {
+    RecordedFrame frame;
+    if (!decoder.next(frame)) {
+        atEnd = true;
+        return false;
+    }
+    frames[0] = frames[1];
+    samples[0] = samples[1];
+    frames[1] = frame;
+    dequantizeFrame(frames[1], track->getMaxThrust(), track->getEmptyMass(), samples[1]);
+    return true;
+}
+
+void TrackPlayer::seek(double time) {
+    bracketed = false;
+    atEnd = false;
+
+    const std::vector<RecordedTrack::Keyframe>& keyframes = track->getKeyframes();
+    if (keyframes.empty()) {
+        return;
+    }
+
+    // Last keyframe at or before the requested time
+    auto after = std::upper_bound(keyframes.begin(), keyframes.end(), time,
+        [](double t, const RecordedTrack::Keyframe& keyframe) { return t < recordedTime(keyframe.time); });
+    size_t index = after == keyframes.begin() ? 0 : static_cast<size_t>(after - keyframes.begin()) - 1;
+
+    decoder.seekKeyframe(index);
+    if (!decoder.next(frames[1])) {
+        return;
+    }
+    dequantizeFrame(frames[1], track->getMaxThrust(), track->getEmptyMass(), samples[1]);
+    frames[0] = frames[1];
+    samples[0] = samples[1];
+    bracketed = true;
+
+    while (samples[1].time <= time && advance()) {
+    }
+}
+
+void TrackPlayer::sample(double time, RecordedSample& out) {
+    if (!bracketed || time < samples[0].time) {
+        seek(time);
+    } else if (time >= samples[1].time && !atEnd) {
+        // Decode forward unless the target lies beyond the next keyframe
+        const std::vector<RecordedTrack::Keyframe>& keyframes = track->getKeyframes();
+        uint32_t interval = track->getKeyframeInterval();
+        size_t nextKeyframe = (decoder.getTick() + interval - 1) / interval;
+        if (nextKeyframe < keyframes.size() && time >= recordedTime(keyframes[nextKeyframe].time)) {
+            seek(time);
+        } else {
+            while (samples[1].time <= time && advance()) {
+            }
+        }
+    }
+
+    if (!bracketed) {
+        out = RecordedSample();
+        out.time = time;
+        return;
+    }
+
+    const RecordedSample& a = samples[0];
+    const RecordedSample& b = samples[1];
+    double span = b.time - a.time;
+    if (span <= 0 || time <= a.time || time >= b.time) {
+        // Clamped to a recorded tick
+        out = (span > 0 && time >= b.time) ? b : a;
+        out.time = time;
+        return;
+    }
+
+    float t = static_cast<float>((time - a.time) / span);
+    AircraftState& state = out.state;
+    state = a.state;
+
+    state.position = hermite(a.state.position, a.state.velocity, b.state.position, b.state.velocity,
+                             static_cast<float>(span), t);
+    state.velocity = lerp(a.state.velocity, b.state.velocity, t);
+
+    Quat attitude = Quat::slerp(attitudeFromEuler(a.state.heading, a.state.pitch, a.state.roll),
+                                attitudeFromEuler(b.state.heading, b.state.pitch, b.state.roll), t);
+    attitudeToEuler(attitude, state.heading, state.pitch, state.roll);
+
+    state.headingRate = lerp(a.state.headingRate, b.state.headingRate, t);
+    state.pitchRate = lerp(a.state.pitchRate, b.state.pitchRate, t);
+    state.rollRate = lerp(a.state.rollRate, b.state.rollRate, t);
+    state.throttle = lerp(a.state.throttle, b.state.throttle, t);
+    state.thrust = lerp(a.state.thrust, b.state.thrust, t);
+    state.aileron = lerp(a.state.aileron, b.state.aileron, t);
+    state.elevator = lerp(a.state.elevator, b.state.elevator, t);
+    state.rudder = lerp(a.state.rudder, b.state.rudder, t);
+    state.mass = lerp(a.state.mass, b.state.mass, t);
+    state.altitude = state.position.y;
+    state.airspeed = state.velocity.length();
+
+    out.fuel = lerp(a.fuel, b.fuel, t);
+    out.time = time;
+}
+
+double TrackPlayer::getStartTime() const {
+    const std::vector<RecordedTrack::Keyframe>& keyframes = track->getKeyframes();
+    return keyframes.empty() ? 0.0 : recordedTime(keyframes.front().time);
+}
+
+double TrackPlayer::getEndTime() const {
+    // Decode the final keyframe interval once
+    const std::vector<RecordedTrack::Keyframe>& keyframes = track->getKeyframes();
+    if (keyframes.empty()) {
+        return 0.0;
+    }
+    TrackDecoder tail(*track);
+    tail.seekKeyframe(keyframes.size() - 1);
+    RecordedFrame frame;
+    int32_t last = keyframes.back().time;
+    while (tail.next(frame)) {
+        last = frame.values[REC_TIME];
+    }
+    return recordedTime(last);
+}
+
+// ReplayEngine implementation
+ReplayEngine::ReplayEngine() : time(0) {
+}
+
+int ReplayEngine::addGhost(std::unique_ptr<RecordedTrack> track) {
+    if (!track) {
+        return -1;
+    }
+    Ghost ghost;
+    ghost.player.reset(new TrackPlayer(*track));
+    ghost.owned = std::move(track);
+    ghosts.push_back(std::move(ghost));
+    refresh();
+    return getGhostCount() - 1;
+}
+
+int ReplayEngine::addGhost(const RecordedTrack& track) {
+    Ghost ghost;
+    ghost.player.reset(new TrackPlayer(track));
+    ghosts.push_back(std::move(ghost));
+    refresh();
+    return getGhostCount() - 1;
+}
+
+void ReplayEngine::clear() {
+    ghosts.clear();
+    samples.clear();
+    time = 0;
+}
+
+void ReplayEngine::seek(double newTime) {
+    time = newTime;
+    for (Ghost& ghost : ghosts) {
+        ghost.player->seek(time);
+    }
+    refresh();
+}
+
+void ReplayEngine::advance(double deltaTime) {
+    time += deltaTime;
+    refresh();
+}
+
+double ReplayEngine::getStartTime() const {
+    double start = 0;
+    for (size_t i = 0; i < ghosts.size(); ++i) {
+        double ghostStart = ghosts[i].player->getStartTime();
+        start = i == 0 ? ghostStart : std::min(start, ghostStart);
+    }
+    return start;
+}
+
+double ReplayEngine::getEndTime() const {
+    double end = 0;
+    for (const Ghost& ghost : ghosts) {
+        end = std::max(end, ghost.player->getEndTime());
+    }
+    return end;
+}
+
+void ReplayEngine::refresh() {
+    samples.resize(ghosts.size());
+    for (size_t i = 0; i < ghosts.size(); ++i) {
+        ghosts[i].player->sample(time, samples[i]);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "flight_recorder.h"
+#include "vector_math.h"
+
+// Attitude quaternions in the AircraftState convention (forward = (cos h, 0, sin h) at zero
+// pitch), for interpolating with Quat::slerp
+Quat attitudeFromEuler(float heading, float pitch, float roll);
+void attitudeToEuler(const Quat& attitude, float& heading, float& pitch, float& roll);
+
+// Plays back one recorded track at arbitrary times.
+// Keeps the two decoded ticks bracketing the last requested time; moving forward decodes
+// incrementally, anything else seeks through the keyframe index.
+class TrackPlayer {
+private:
+    const RecordedTrack* track;
+    TrackDecoder decoder;
+    RecordedFrame frames[2];        // frames[0].time <= requested time < frames[1].time
+    RecordedSample samples[2];
+    bool bracketed;
+    bool atEnd;                     // frames[1] is the last tick of the track
+
+    bool advance();
+
+public:
+    explicit TrackPlayer(const RecordedTrack& track);
+
+    // Position the decoder around the given time (O(log keyframes) plus at most one keyframe interval)
+    void seek(double time);
+
+    // Interpolated state; times outside the recording clamp to the first/last tick
+    void sample(double time, RecordedSample& out);
+
+    double getStartTime() const;
+    double getEndTime() const;
+    const RecordedTrack& getTrack() const { return *track; }
+};
+
+// Several recorded ghost aircraft played back against one clock
+class ReplayEngine {
+private:
+    struct Ghost {
+        std::unique_ptr<RecordedTrack> owned;   // Null when the track is borrowed
+        std::unique_ptr<TrackPlayer> player;
+    };
+
+    std::vector<Ghost> ghosts;
+    std::vector<RecordedSample> samples;
+    double time;
+
+public:
+    ReplayEngine();
+
+    // Take ownership of a (typically deserialized) track; returns the ghost index, or -1 for null
+    int addGhost(std::unique_ptr<RecordedTrack> track);
+    // Play a track owned elsewhere, e.g. by a FlightRecorder; it must outlive the engine
+    int addGhost(const RecordedTrack& track);
+    void clear();
+
+    // Jump to a time, or move the clock by deltaTime; both refresh every ghost sample
+    void seek(double time);
+    void advance(double deltaTime);
+
+    double getTime() const { return time; }
+    double getStartTime() const;
+    double getEndTime() const;
+
+    int getGhostCount() const { return static_cast<int>(ghosts.size()); }
+    const RecordedSample& getSample(int index) const { return samples[index]; }
+    const RecordedTrack& getTrack(int index) const { return ghosts[index].player->getTrack(); }
+
+private:
+    void refresh();
+};
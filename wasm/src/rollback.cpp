@@ -0,0 +1,151 @@
+#include "rollback.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "deterministic_math.h"
+
+namespace {
+
+const int64_t kNoRollback = std::numeric_limits<int64_t>::max();
+
+bool sameInput(const ControlInputs& a, const ControlInputs& b) {
+    return a.throttle == b.throttle && a.aileron == b.aileron &&
+           a.elevator == b.elevator && a.rudder == b.rudder;
+}
+
+ControlInputs currentControls(const FlightDynamics& dynamics) {
+    const AircraftState& state = dynamics.getState();
+    ControlInputs controls;
+    controls.throttle = state.throttle;
+    controls.aileron = state.aileron;
+    controls.elevator = state.elevator;
+    controls.rudder = state.rudder;
+    return controls;
+}
+
+} // namespace
+
+RollbackSimulator::RollbackSimulator(int historyLength_, float tickDuration_)
+    : deterministic(false), historyLength(std::min(std::max(1, historyLength_), kMaxHistoryLength)),
+      tickDuration(std::isfinite(tickDuration_) && tickDuration_ > 0 ? tickDuration_ : 1.0f / 60.0f),
+      currentTick(0), oldestTick(0), rollbackTick(kNoRollback),
+      lastResimulatedTicks(0), rollbackCount(0) {
+    resetHistory();
+}
+
+void RollbackSimulator::resetHistory() {
+    const size_t count = aircraft.size();
+    snapshots.assign(static_cast<size_t>(historyLength) * count, FlightSnapshot());
+    inputs.assign(static_cast<size_t>(historyLength) * 2 * count, ControlInputs());
+    confirmed.assign(inputs.size(), 0);
+    inputTicks.assign(static_cast<size_t>(historyLength) * 2, -1);
+    oldestTick = currentTick;
+    rollbackTick = kNoRollback;
+}
+
+int RollbackSimulator::addAircraft(const Vec3& position, float heading) {
+    aircraft.emplace_back();
+    aircraft.back().setDeterministic(deterministic);
+    aircraft.back().initialize(position, heading);
+    resetHistory();
+    return size() - 1;
+}
+
+int RollbackSimulator::addAircraft(std::shared_ptr<const AircraftProperties> properties,
+                                   const Vec3& position, float heading) {
+    aircraft.emplace_back();
+    aircraft.back().setDeterministic(deterministic);
+    aircraft.back().setProperties(std::move(properties));
+    aircraft.back().initialize(position, heading);
+    resetHistory();
+    return size() - 1;
+}
+
+size_t RollbackSimulator::inputRow(int64_t tick) {
+    size_t row = static_cast<size_t>(tick % (historyLength * 2));
+    if (inputTicks[row] != tick) {
+        // Row last held a tick that has left the window
+        inputTicks[row] = tick;
+        std::fill_n(confirmed.begin() + row * aircraft.size(), aircraft.size(), 0);
+    }
+    return row;
+}
+
+bool RollbackSimulator::setInput(int index, int64_t tick, const ControlInputs& input) {
+    if (index < 0 || index >= size() || tick < oldestTick || tick >= currentTick + historyLength) {
+        return false;
+    }
+
+    // Simulated ticks hold the input that was used, predicted or not; only a change rolls back
+    size_t slot = inputRow(tick) * aircraft.size() + index;
+    if (tick < currentTick && !sameInput(inputs[slot], input)) {
+        rollbackTick = std::min(rollbackTick, tick);
+    }
+    inputs[slot] = input;
+    confirmed[slot] = 1;
+    return true;
+}
+
+void RollbackSimulator::simulateTick(int64_t tick) {
+    const size_t count = aircraft.size();
+    const size_t row = inputRow(tick) * count;
+    FlightSnapshot* tickSnapshots = &snapshots[static_cast<size_t>(tick % historyLength) * count];
+
+    for (size_t i = 0; i < count; ++i) {
+        // Predict missing inputs by holding the controls applied during the previous tick
+        if (!confirmed[row + i]) {
+            inputs[row + i] = currentControls(aircraft[i]);
+        }
+        aircraft[i].save(tickSnapshots[i]);
+        aircraft[i].setControls(inputs[row + i]);
+        aircraft[i].update(tickDuration);
+    }
+}
+
+void RollbackSimulator::resimulate() {
+    const int64_t target = rollbackTick;
+    rollbackTick = kNoRollback;
+    if (target >= currentTick || target < oldestTick) {
+        return;
+    }
+
+    const size_t count = aircraft.size();
+    const FlightSnapshot* tickSnapshots = &snapshots[static_cast<size_t>(target % historyLength) * count];
+    for (size_t i = 0; i < count; ++i) {
+        aircraft[i].restore(tickSnapshots[i]);
+    }
+    for (int64_t tick = target; tick < currentTick; ++tick) {
+        simulateTick(tick);
+    }
+
+    lastResimulatedTicks = static_cast<int>(currentTick - target);
+    rollbackCount++;
+}
+
+void RollbackSimulator::step(int ticks) {
+    lastResimulatedTicks = 0;
+    if (rollbackTick != kNoRollback) {
+        resimulate();
+    }
+
+    for (int i = 0; i < ticks; ++i) {
+        simulateTick(currentTick);
+        currentTick++;
+        oldestTick = std::max(oldestTick, currentTick - historyLength);
+    }
+}
+
+void RollbackSimulator::setDeterministic(bool enabled) {
+    deterministic = enabled;
+    for (FlightDynamics& dynamics : aircraft) {
+        dynamics.setDeterministic(enabled);
+    }
+}
+
+uint64_t RollbackSimulator::getChecksum() const {
+    uint64_t hash = detmath::kHashSeed;
+    for (const FlightDynamics& dynamics : aircraft) {
+        hash = dynamics.checksum(hash);
+    }
+    return hash;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "simulation.h"
+
+// Fixed-tick simulation of player aircraft with rollback for late inputs.
+// Keeps a ring of per-tick snapshots and inputs. Missing inputs are predicted by repeating
+// the aircraft's previous input; when a late input changes a simulated tick, the next step()
+// restores that tick's snapshots and re-simulates to the present before advancing.
+// All storage is sized when aircraft are added, so stepping and re-simulation never allocate.
+class RollbackSimulator {
+private:
+    std::vector<FlightDynamics> aircraft;
+    bool deterministic;
+    int historyLength;          // Ticks that can be rolled back
+    float tickDuration;
+
+    int64_t currentTick;        // Next tick to simulate; aircraft hold the state at its start
+    int64_t oldestTick;         // Earliest tick with stored snapshots
+    int64_t rollbackTick;       // Earliest tick to re-simulate, INT64_MAX when none
+
+    // Snapshot ring: historyLength rows of one snapshot per aircraft (state at tick start)
+    std::vector<FlightSnapshot> snapshots;
+    // Input ring: 2 * historyLength rows covering the history and as many future ticks
+    std::vector<ControlInputs> inputs;
+    std::vector<uint8_t> confirmed;     // Input received (1) or predicted (0)
+    std::vector<int64_t> inputTicks;    // Tick held by each input row
+
+    int lastResimulatedTicks;
+    int64_t rollbackCount;
+
+    size_t inputRow(int64_t tick);
+    void simulateTick(int64_t tick);
+    void resimulate();
+    void resetHistory();
+
+public:
+    static constexpr int kMaxHistoryLength = 4096;
+
+    // historyLength is clamped to [1, kMaxHistoryLength]; a tickDuration that is not finite
+    // and positive falls back to 1/60 s
+    explicit RollbackSimulator(int historyLength = 64, float tickDuration = 1.0f / 60.0f);
+
+    // Adding aircraft resizes the rings and discards the rollback history
+    int addAircraft(const Vec3& position, float heading);
+    int addAircraft(std::shared_ptr<const AircraftProperties> properties, const Vec3& position, float heading);
+    int size() const { return static_cast<int>(aircraft.size()); }
+
+    // Input for one aircraft during the given tick. Returns false if the tick is older
+    // than the history or too far in the future.
+    bool setInput(int index, int64_t tick, const ControlInputs& input);
+
+    // Apply pending rollback, then advance the given number of ticks
+    void step(int ticks = 1);
+
+    int64_t getCurrentTick() const { return currentTick; }
+    int64_t getOldestTick() const { return oldestTick; }
+    float getTickDuration() const { return tickDuration; }
+    const FlightDynamics& getAircraft(int index) const { return aircraft[index]; }
+
+    // Portable math for every aircraft, so peers can compare checksums
+    void setDeterministic(bool enabled);
+    // Hash of every aircraft's current state (the state at the start of getCurrentTick())
+    uint64_t getChecksum() const;
+    
+    // Ticks re-simulated by the last step() and total rollbacks performed
+    int getLastResimulatedTicks() const { return lastResimulatedTicks; }
+    int64_t getRollbackCount() const { return rollbackCount; }
+};
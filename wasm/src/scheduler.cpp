@@ -0,0 +1,164 @@
+#include "scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "memory_arena.h"
+#include "memory_stats.h"
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void recordCall(ScheduledTaskStats& stats, double seconds) {
+    stats.calls++;
+    stats.totalSeconds += seconds;
+    stats.maxSeconds = std::max(stats.maxSeconds, seconds);
+    stats.lastSeconds = seconds;
+}
+
+} // namespace
+
+MultiRateScheduler::MultiRateScheduler(float tickRate_)
+    : tickRate(tickRate_ > 0 ? tickRate_ : 240.0f), tick(0), accumulator(0.0),
+      maxCatchUpTicks(8), droppedTicks(0), lastTickSeconds(0.0), maxTickSeconds(0.0) {
+    // One second of ticks is enough to balance the phases of every practical rate
+    load.assign(std::max(1, static_cast<int>(std::lround(tickRate))), 0.0f);
+}
+
+int MultiRateScheduler::periodFor(float rate) const {
+    return std::max(1, static_cast<int>(std::lround(tickRate / rate)));
+}
+
+void MultiRateScheduler::addLoad(int phase, int period, float amount) {
+    const int horizon = static_cast<int>(load.size());
+    for (int t = phase % horizon; t < horizon; t += period) {
+        load[t] += amount;
+    }
+}
+
+int MultiRateScheduler::choosePhase(int period) const {
+    const int horizon = static_cast<int>(load.size());
+    int best = 0;
+    float bestLoad = 0.0f;
+    for (int phase = 0; phase < std::min(period, horizon); ++phase) {
+        float peak = 0.0f;
+        for (int t = phase; t < horizon; t += period) {
+            peak = std::max(peak, load[t]);
+        }
+        if (phase == 0 || peak < bestLoad) {
+            best = phase;
+            bestLoad = peak;
+        }
+    }
+    return best;
+}
+
+int MultiRateScheduler::addTask(const std::string& name, float rate, TaskFunction run) {
+    if (!acceptsRate(rate)) {
+        return -1;
+    }
+    Task task;
+    task.run = std::move(run);
+    task.enabled = true;
+    task.stats = ScheduledTaskStats();
+    task.stats.name = name;
+    task.stats.period = periodFor(rate);
+    task.stats.rate = tickRate / task.stats.period;
+    task.phase = choosePhase(task.stats.period);
+    addLoad(task.phase, task.stats.period, 1.0f);
+    tasks.push_back(std::move(task));
+    return static_cast<int>(tasks.size()) - 1;
+}
+
+int MultiRateScheduler::addSlicedTask(const std::string& name, float rate, CountFunction itemCount,
+                                      SliceFunction run) {
+    if (!acceptsRate(rate)) {
+        return -1;
+    }
+    Task task;
+    task.runSlice = std::move(run);
+    task.itemCount = std::move(itemCount);
+    task.phase = 0;
+    task.enabled = true;
+    task.stats = ScheduledTaskStats();
+    task.stats.name = name;
+    task.stats.period = periodFor(rate);
+    task.stats.rate = tickRate / task.stats.period;
+
+    // A slice on every tick
+    const int period = task.stats.period;
+    for (int phase = 0; phase < period; ++phase) {
+        addLoad(phase, period, 1.0f / period);
+    }
+    tasks.push_back(std::move(task));
+    return static_cast<int>(tasks.size()) - 1;
+}
+
+void MultiRateScheduler::step() {
+    auto tickStart = std::chrono::steady_clock::now();
+    memory::beginFrame();
+    HotPathScope hotPath;
+
+    for (Task& task : tasks) {
+        if (!task.enabled) {
+            continue;
+        }
+        const int period = task.stats.period;
+        const float deltaTime = static_cast<float>(period) / tickRate;
+        const int slot = static_cast<int>(tick % period);
+
+        if (task.runSlice) {
+            const int count = task.itemCount();
+            int begin = static_cast<int>(static_cast<int64_t>(count) * slot / period);
+            int end = static_cast<int>(static_cast<int64_t>(count) * (slot + 1) / period);
+            if (begin == end) {
+                continue;
+            }
+            auto start = std::chrono::steady_clock::now();
+            task.runSlice(begin, end, deltaTime);
+            recordCall(task.stats, secondsSince(start));
+        } else if (slot == task.phase) {
+            auto start = std::chrono::steady_clock::now();
+            task.run(deltaTime);
+            recordCall(task.stats, secondsSince(start));
+        }
+    }
+    tick++;
+
+    lastTickSeconds = secondsSince(tickStart);
+    maxTickSeconds = std::max(maxTickSeconds, lastTickSeconds);
+}
+
+int MultiRateScheduler::advance(double deltaTime) {
+    if (!std::isfinite(deltaTime) || deltaTime < 0.0) {
+        return 0;
+    }
+    accumulator += deltaTime;
+    // Counted in double so a huge delta cannot overflow the cast; whole ticks beyond the
+    // catch-up limit are dropped, keeping only the fraction of a tick
+    double due = std::floor(accumulator * tickRate);
+    accumulator = std::min(std::max(0.0, accumulator - due / tickRate), 1.0 / tickRate);
+    int ticks = maxCatchUpTicks;
+    if (due <= maxCatchUpTicks) {
+        ticks = static_cast<int>(due);
+    } else {
+        droppedTicks += static_cast<int64_t>(std::min(due - maxCatchUpTicks, 1e15));
+    }
+    for (int i = 0; i < ticks; ++i) {
+        step();
+    }
+    return ticks;
+}
+
+void MultiRateScheduler::resetStats() {
+    for (Task& task : tasks) {
+        task.stats.calls = 0;
+        task.stats.totalSeconds = 0.0;
+        task.stats.maxSeconds = 0.0;
+        task.stats.lastSeconds = 0.0;
+    }
+    lastTickSeconds = 0.0;
+    maxTickSeconds = 0.0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Timing of one scheduled task
+struct ScheduledTaskStats {
+    std::string name;
+    float rate;                 // Effective rate (Hz): base tick rate / period
+    int period;                 // Base ticks between runs of each item
+    uint64_t calls;             // Invocations (slices count separately)
+    double totalSeconds;
+    double maxSeconds;
+    double lastSeconds;
+
+    double getMeanSeconds() const { return calls ? totalSeconds / calls : 0.0; }
+};
+
+// Fixed-tick scheduler for subsystems running at different rates.
+// Each task declares a rate of at most the tick rate and runs every round(tickRate / rate)
+// base ticks with the matching step. Periodic tasks are given the phase with the least load
+// already on it; sliced tasks (entity updates) run 1/period of their items on every tick, so
+// every item still gets one step per period but the cost is spread evenly. Within a tick,
+// tasks run in the order added.
+class MultiRateScheduler {
+public:
+    typedef std::function<void(float deltaTime)> TaskFunction;
+    // Items [begin, end) of the task's current item count
+    typedef std::function<void(int begin, int end, float deltaTime)> SliceFunction;
+    typedef std::function<int()> CountFunction;
+
+private:
+    struct Task {
+        TaskFunction run;
+        SliceFunction runSlice;
+        CountFunction itemCount;
+        int phase;
+        bool enabled;
+        ScheduledTaskStats stats;
+    };
+
+    std::vector<Task> tasks;
+    std::vector<float> load;        // Expected task runs per tick over one load horizon
+    float tickRate;
+    int64_t tick;
+    double accumulator;             // Unsimulated time carried between advance() calls
+    int maxCatchUpTicks;
+    int64_t droppedTicks;
+    double lastTickSeconds;
+    double maxTickSeconds;
+
+    int periodFor(float rate) const;
+    void addLoad(int phase, int period, float amount);
+    int choosePhase(int period) const;
+
+public:
+    // tickRate: base ticks per second, the highest rate any task can run at
+    explicit MultiRateScheduler(float tickRate = 240.0f);
+
+    // Rates in (0, tickRate]; a task cannot run more often than once per base tick
+    bool acceptsRate(float rate) const { return rate > 0 && rate <= tickRate; }
+
+    // Subsystem run once per period; returns the task id, or -1 if the rate is not accepted
+    int addTask(const std::string& name, float rate, TaskFunction run);
+    // Entity update; itemCount is queried every tick, so the set may grow and shrink.
+    // Returns the task id, or -1 if the rate is not accepted.
+    int addSlicedTask(const std::string& name, float rate, CountFunction itemCount, SliceFunction run);
+
+    // Returns false for an unknown task id
+    bool setEnabled(int task, bool enabled) {
+        if (task < 0 || task >= getTaskCount()) {
+            return false;
+        }
+        tasks[task].enabled = enabled;
+        return true;
+    }
+    int getTaskCount() const { return static_cast<int>(tasks.size()); }
+
+    // Run one base tick
+    void step();
+    // Run every whole tick in deltaTime plus any carried remainder; returns the ticks run.
+    // At most maxCatchUpTicks run per call, the rest are dropped. Negative or non-finite
+    // deltas are ignored.
+    int advance(double deltaTime);
+
+    void setMaxCatchUpTicks(int ticks) { maxCatchUpTicks = ticks > 0 ? ticks : 1; }
+    float getTickRate() const { return tickRate; }
+    int64_t getTick() const { return tick; }
+    double getTime() const { return static_cast<double>(tick) / tickRate; }
+    int64_t getDroppedTicks() const { return droppedTicks; }
+
+    // Timing
+    const ScheduledTaskStats& getStats(int task) const { return tasks[task].stats; }
+    double getLastTickSeconds() const { return lastTickSeconds; }
+    double getMaxTickSeconds() const { return maxTickSeconds; }
+    void resetStats();
+};
@@ -0,0 +1,328 @@
+#include "sim_server.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include "memory_arena.h"
+#include "memory_stats.h"
+
+namespace {
+
+const int kBucketsPerOctave = 4;
+const size_t kMaxClientMessage = 16;
+
+int histogramBucket(double seconds) {
+    double micros = seconds * 1e6;
+    if (!(micros >= 1.0)) {
+        return 0;
+    }
+    int bucket = 1 + static_cast<int>(std::floor(std::log2(micros) * kBucketsPerOctave));
+    return std::min(bucket, TickHistogram::kBucketCount - 1);
+}
+
+// Controls travel as 8-bit values: throttle 0..255, surfaces -127..127
+uint32_t quantizeControl(float value, float scale, float offset) {
+    float scaled = std::floor((value + offset) * scale + 0.5f);
+    return static_cast<uint32_t>(std::max(0.0f, std::min(255.0f, scaled)));
+}
+
+float dequantizeControl(uint32_t value, float scale, float offset) {
+    return static_cast<float>(value) / scale - offset;
+}
+
+} // namespace
+
+// TickHistogram implementation
+TickHistogram::TickHistogram() {
+    clear();
+}
+
+void TickHistogram::clear() {
+    std::fill(buckets, buckets + kBucketCount, 0);
+    count = 0;
+    total = 0.0;
+    maximum = 0.0;
+}
+
+void TickHistogram::record(double seconds) {
+    buckets[histogramBucket(seconds)]++;
+    count++;
+    total += seconds;
+    maximum = std::max(maximum, seconds);
+}
+
+void TickHistogram::merge(const TickHistogram& other) {
+    for (int i = 0; i < kBucketCount; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    total += other.total;
+    maximum = std::max(maximum, other.maximum);
+}
+
+double TickHistogram::getPercentile(double fraction) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count)));
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += buckets[i];
+        if (seen >= target && seen > 0) {
+            double upper = 1e-6 * std::exp2(static_cast<double>(i) / kBucketsPerOctave);
+            return std::min(upper, maximum);
+        }
+    }
+    return maximum;
+}
+
+// Client messages
+size_t writeClientMessage(uint8_t* buffer, size_t capacity, bool hasAck, uint16_t ack,
+                          const ControlInputs& controls) {
+    BitWriter writer(buffer, capacity);
+    writer.writeBool(hasAck);
+    if (hasAck) {
+        writer.writeBits(ack, 16);
+    }
+    writer.writeBits(quantizeControl(controls.throttle, 255.0f, 0.0f), 8);
+    writer.writeBits(quantizeControl(controls.aileron, 127.0f, 1.0f), 8);
+    writer.writeBits(quantizeControl(controls.elevator, 127.0f, 1.0f), 8);
+    writer.writeBits(quantizeControl(controls.rudder, 127.0f, 1.0f), 8);
+    return writer.hasOverflowed() ? 0 : writer.getBytesWritten();
+}
+
+bool readClientMessage(const uint8_t* data, size_t size, bool& hasAck, uint16_t& ack,
+                       ControlInputs& controls) {
+    BitReader reader(data, size);
+    hasAck = reader.readBool();
+    ack = hasAck ? static_cast<uint16_t>(reader.readBits(16)) : 0;
+    controls.throttle = dequantizeControl(reader.readBits(8), 255.0f, 0.0f);
+    controls.aileron = dequantizeControl(reader.readBits(8), 127.0f, 1.0f);
+    controls.elevator = dequantizeControl(reader.readBits(8), 127.0f, 1.0f);
+    controls.rudder = dequantizeControl(reader.readBits(8), 127.0f, 1.0f);
+    return !reader.hasError();
+}
+
+// LoopbackClient implementation
+LoopbackClient::LoopbackClient(float phase_)
+    : phase(phase_), hasReceived(false), newestSequence(0), snapshotsReceived(0) {
+}
+
+void LoopbackClient::update(LoopbackChannel& downlink, LoopbackChannel& uplink, double time) {
+    while (downlink.receive(packet)) {
+        uint16_t sequence;
+        if (!decoder.readPacket(packet.data(), packet.size(), sequence)) {
+            continue;
+        }
+        snapshotsReceived++;
+        if (!hasReceived || static_cast<int16_t>(sequence - newestSequence) > 0) {
+            newestSequence = sequence;
+            hasReceived = true;
+        }
+    }
+
+    // Gentle scripted manoeuvring
+    float t = static_cast<float>(time) + phase;
+    ControlInputs controls;
+    controls.throttle = 0.7f + 0.2f * std::sin(t * 0.13f);
+    controls.aileron = 0.3f * std::sin(t * 0.5f);
+    controls.elevator = 0.1f * std::sin(t * 0.31f);
+    controls.rudder = 0.05f * std::sin(t * 0.7f);
+
+    uint8_t message[kMaxClientMessage];
+    size_t size = writeClientMessage(message, sizeof(message), hasReceived, newestSequence, controls);
+    uplink.send(message, size);
+}
+
+// ServerSession implementation
+ServerSession::Connection::Connection(int aircraft_, const SessionConfig& config, uint32_t seed)
+    : aircraft(aircraft_), observer(-1), encoder(config.packetBudget),
+      downlink(config.latencyTicks, config.lossRate, seed * 2 + 1),
+      uplink(config.latencyTicks, config.lossRate, seed * 2 + 2),
+      client(static_cast<float>(aircraft_) * 7.0f) {
+}
+
+ServerSession::ServerSession(int id_, const SessionConfig& config_)
+    : id(id_), config(config_), tick(0), snapshotCount(0), packet(config_.packetBudget) {
+    const int count = std::max(config.aircraftCount, config.clientCount);
+    for (int i = 0; i < count; ++i) {
+        // Spread over a grid of 2 km cells, alternating headings
+        Vec3 position(static_cast<float>(i % 8) * 2000.0f, 2000.0f + static_cast<float>(i % 5) * 300.0f,
+                      static_cast<float>(i / 8) * 2000.0f);
+        float heading = static_cast<float>(i) * 0.7f;
+        int index = fleet.addAircraft(position, heading);
+        interest.addEntity(position);
+
+        // Aircraft without a player hold altitude, heading and speed
+        if (index >= config.clientCount) {
+            AutopilotSystem& autopilot = fleet.getAutopilot();
+            autopilot.setMode(index, AUTOPILOT_ALTITUDE | AUTOPILOT_HEADING | AUTOPILOT_SPEED);
+            autopilot.setTargetAltitude(index, position.y);
+            autopilot.setTargetHeading(index, heading);
+            autopilot.setTargetSpeed(index, 120.0f);
+        }
+    }
+
+    for (int i = 0; i < config.clientCount; ++i) {
+        uint32_t seed = static_cast<uint32_t>(id) * 65536u + static_cast<uint32_t>(i);
+        connections.push_back(std::unique_ptr<Connection>(new Connection(i, config, seed)));
+        connections.back()->observer = interest.addObserver(fleet.getAircraft(i).getState().position,
+                                                            config.interestBands);
+    }
+    states.resize(count);
+}
+
+void ServerSession::receiveInputs() {
+    MemoryTagScope tag(MEM_NETWORK);
+    for (std::unique_ptr<Connection>& connection : connections) {
+        while (connection->uplink.receive(packet)) {
+            bool hasAck;
+            uint16_t ack;
+            ControlInputs controls;
+            if (!readClientMessage(packet.data(), packet.size(), hasAck, ack, controls)) {
+                continue;
+            }
+            if (hasAck) {
+                connection->encoder.acknowledge(ack);
+            }
+            fleet.getAircraft(connection->aircraft).setControls(controls);
+        }
+    }
+}
+
+void ServerSession::updateInterest() {
+    MemoryTagScope tag(MEM_NETWORK);
+    // Observers first, so entities are evaluated against this tick's viewpoints
+    for (std::unique_ptr<Connection>& connection : connections) {
+        interest.moveObserver(connection->observer, fleet.getAircraft(connection->aircraft).getState().position);
+    }
+    const int count = fleet.size();
+    for (int i = 0; i < count; ++i) {
+        interest.moveEntity(i, fleet.getAircraft(i).getState().position);
+    }
+}
+
+void ServerSession::sendSnapshots() {
+    MemoryTagScope tag(MEM_NETWORK);
+    const int count = fleet.size();
+    for (int i = 0; i < count; ++i) {
+        const FlightDynamics& aircraft = fleet.getAircraft(i);
+        quantizeNetState(aircraft.getState(), aircraft.getFuel(), states[i]);
+    }
+
+    packet.resize(config.packetBudget);
+    for (std::unique_ptr<Connection>& connection : connections) {
+        const int observer = connection->observer;
+        for (const InterestEvent& event : interest.getEvents(observer)) {
+            if (event.band < 0) {
+                connection->encoder.removeEntity(static_cast<uint16_t>(event.entity));
+            }
+        }
+        interest.clearEvents(observer);
+
+        // Only aircraft due in their band accumulate priority; nearer bands weigh more
+        for (int i : interest.getRelevant(observer)) {
+            float priority = 0.0f;
+            if (interest.isDue(observer, i, snapshotCount)) {
+                priority = i == connection->aircraft ? 4.0f : 1.0f / (1.0f + interest.getBand(observer, i));
+            }
+            connection->encoder.setEntity(static_cast<uint16_t>(i), states[i], priority);
+        }
+        size_t size = connection->encoder.writePacket(packet.data(), packet.size());
+        connection->downlink.send(packet.data(), size);
+    }
+    snapshotCount++;
+}
+
+void ServerSession::step() {
+    auto start = std::chrono::steady_clock::now();
+    memory::beginFrame();
+    HotPathScope hotPath;
+
+    receiveInputs();
+    if (config.fullPhysicsRadius > 0 && tick % config.snapshotInterval == 0) {
+        focus.clear();
+        for (std::unique_ptr<Connection>& connection : connections) {
+            focus.push_back(fleet.getAircraft(connection->aircraft).getState().position);
+        }
+        fleet.selectPhysicsLod(focus, config.fullPhysicsRadius);
+    }
+    fleet.update(getTickDuration());
+    updateInterest();
+    tick++;
+    if (tick % config.snapshotInterval == 0) {
+        sendSnapshots();
+    }
+
+    histogram.record(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    // Loopback players stand in for the remote end and are not part of the tick time
+    for (std::unique_ptr<Connection>& connection : connections) {
+        connection->client.update(connection->downlink, connection->uplink, fleet.getTime());
+        connection->downlink.advance();
+        connection->uplink.advance();
+    }
+}
+
+// SimServer implementation
+SimServer::SimServer(int threadCount)
+    : pool(threadCount), time(0.0), maxCatchUpTicks(4), droppedTicks(0) {
+}
+
+int SimServer::addSession(const SessionConfig& config) {
+    int index = static_cast<int>(sessions.size());
+    sessions.push_back(std::unique_ptr<ServerSession>(new ServerSession(index, config)));
+
+    // Stagger tick phases so sessions do not all fall due at once
+    double period = 1.0 / config.tickRate;
+    double phase = std::fmod(static_cast<double>(index) * 0.6180339887, 1.0);
+    nextTickTimes.push_back(time + phase * period);
+    dueTicks.push_back(0);
+    return index;
+}
+
+void SimServer::advance(double deltaTime) {
+    time += deltaTime;
+
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        double period = sessions[i]->getTickDuration();
+        int ticks = 0;
+        if (nextTickTimes[i] <= time) {
+            ticks = 1 + static_cast<int>(std::floor((time - nextTickTimes[i]) / period));
+        }
+        if (ticks > maxCatchUpTicks) {
+            droppedTicks += ticks - maxCatchUpTicks;
+        }
+        nextTickTimes[i] += ticks * period;
+        dueTicks[i] = std::min(ticks, maxCatchUpTicks);
+        if (dueTicks[i] == 0) {
+            continue;
+        }
+
+        // One task per session keeps its ticks in order; idle workers steal whole sessions
+        ServerSession* session = sessions[i].get();
+        int count = dueTicks[i];
+        pool.submit([session, count]() {
+            for (int t = 0; t < count; ++t) {
+                session->step();
+            }
+        });
+    }
+    pool.wait();
+}
+
+double SimServer::getNextTickTime() const {
+    double next = std::numeric_limits<double>::infinity();
+    for (double due : nextTickTimes) {
+        next = std::min(next, due);
+    }
+    return next;
+}
+
+TickHistogram SimServer::getCombinedHistogram() const {
+    TickHistogram combined;
+    for (const std::unique_ptr<ServerSession>& session : sessions) {
+        combined.merge(session->getHistogram());
+    }
+    return combined;
+}
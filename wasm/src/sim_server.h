@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "fleet.h"
+#include "interest_grid.h"
+#include "net_codec.h"
+#include "thread_pool.h"
+
+// Log-scale histogram of durations, 4 buckets per power of two from 1 us to about 0.5 s
+class TickHistogram {
+public:
+    static const int kBucketCount = 80;
+
+private:
+    uint64_t buckets[kBucketCount];
+    uint64_t count;
+    double total;
+    double maximum;
+
+public:
+    TickHistogram();
+
+    void clear();
+    void record(double seconds);
+    void merge(const TickHistogram& other);
+
+    uint64_t getCount() const { return count; }
+    double getMean() const { return count ? total / count : 0.0; }
+    double getMax() const { return maximum; }
+    // Upper edge of the bucket holding the given fraction of samples (seconds)
+    double getPercentile(double fraction) const;
+};
+
+// Settings shared by the sessions of a server
+struct SessionConfig {
+    int aircraftCount;          // Aircraft per session, including the players'
+    int clientCount;            // Loopback players, each flying one aircraft
+    float tickRate;             // Physics ticks per second
+    int snapshotInterval;       // Ticks between snapshots to each client
+    size_t packetBudget;        // Snapshot packet size limit (bytes)
+    int latencyTicks;           // One-way loopback latency
+    float lossRate;             // Loopback packet loss in each direction
+    // Interest bands per client; intervals count snapshots. Aircraft beyond the last are not sent.
+    std::vector<InterestBand> interestBands;
+    // Aircraft farther than this from every player fly the point-mass model; 0 keeps all full
+    float fullPhysicsRadius;
+
+    SessionConfig()
+        : aircraftCount(32), clientCount(4), tickRate(60.0f), snapshotInterval(3),
+          packetBudget(400), latencyTicks(3), lossRate(0.0f),
+          interestBands({{3000.0f, 1}, {10000.0f, 4}, {40000.0f, 10}}),
+          fullPhysicsRadius(5000.0f) {}
+};
+
+// Stand-in for a remote player: decodes snapshots, acknowledges them and sends scripted controls
+class LoopbackClient {
+private:
+    SnapshotDecoder decoder;
+    std::vector<uint8_t> packet;
+    float phase;                // Offsets the control script between clients
+    bool hasReceived;
+    uint16_t newestSequence;
+    size_t snapshotsReceived;
+
+public:
+    explicit LoopbackClient(float phase);
+
+    // Read pending snapshots from downlink, then send acknowledgement and controls on uplink
+    void update(LoopbackChannel& downlink, LoopbackChannel& uplink, double time);
+
+    const SnapshotDecoder& getDecoder() const { return decoder; }
+    size_t getSnapshotsReceived() const { return snapshotsReceived; }
+};
+
+// Client-to-server message: newest snapshot sequence and the player's controls
+size_t writeClientMessage(uint8_t* buffer, size_t capacity, bool hasAck, uint16_t ack,
+                          const ControlInputs& controls);
+bool readClientMessage(const uint8_t* data, size_t size, bool& hasAck, uint16_t& ack,
+                       ControlInputs& controls);
+
+// One independent game: a fleet stepped at a fixed tick rate plus its connected clients.
+// A session is only ever stepped by one thread at a time.
+class ServerSession {
+private:
+    struct Connection {
+        int aircraft;                   // Fleet index flown by this client
+        int observer;                   // Interest grid observer following the aircraft
+        SnapshotEncoder encoder;
+        LoopbackChannel downlink;       // Server to client
+        LoopbackChannel uplink;         // Client to server
+        LoopbackClient client;
+
+        Connection(int aircraft, const SessionConfig& config, uint32_t seed);
+    };
+
+    int id;
+    SessionConfig config;
+    AircraftFleet fleet;
+    InterestGrid interest;
+    std::vector<std::unique_ptr<Connection>> connections;
+    int64_t tick;
+    int64_t snapshotCount;
+    TickHistogram histogram;
+    std::vector<uint8_t> packet;
+    std::vector<NetEntityState> states;     // Quantized once per snapshot for every client
+    std::vector<Vec3> focus;                // Player positions for physics LOD selection
+
+    void receiveInputs();
+    void updateInterest();
+    void sendSnapshots();
+
+public:
+    ServerSession(int id, const SessionConfig& config);
+
+    // Advance one tick and record its duration
+    void step();
+
+    int getId() const { return id; }
+    int64_t getTick() const { return tick; }
+    float getTickDuration() const { return 1.0f / config.tickRate; }
+    const AircraftFleet& getFleet() const { return fleet; }
+    const TickHistogram& getHistogram() const { return histogram; }
+    int getClientCount() const { return static_cast<int>(connections.size()); }
+    size_t getBytesSent(int client) const { return connections[client]->downlink.getBytesSent(); }
+    const LoopbackClient& getClient(int client) const { return connections[client]->client; }
+};
+
+// Hosts many sessions and steps the ones that are due on a work-stealing pool
+class SimServer {
+private:
+    std::vector<std::unique_ptr<ServerSession>> sessions;
+    std::vector<double> nextTickTimes;      // Server time each session is next due
+    std::vector<int> dueTicks;              // Ticks to run per session in the current advance()
+    WorkStealingPool pool;
+    double time;
+    int maxCatchUpTicks;
+    int64_t droppedTicks;                   // Skipped because a session fell too far behind
+
+public:
+    explicit SimServer(int threadCount = 0);
+
+    int addSession(const SessionConfig& config);
+    int getSessionCount() const { return static_cast<int>(sessions.size()); }
+    const ServerSession& getSession(int index) const { return *sessions[index]; }
+
+    // Advance server time and step every session that is due, in parallel.
+    // A session runs at most maxCatchUpTicks ticks per call; the rest are dropped.
+    void advance(double deltaTime);
+    // Time of the next due tick across all sessions
+    double getNextTickTime() const;
+
+    void setMaxCatchUpTicks(int ticks) { maxCatchUpTicks = ticks; }
+    double getTime() const { return time; }
+    int64_t getDroppedTicks() const { return droppedTicks; }
+    int getThreadCount() const { return pool.getThreadCount(); }
+
+    // Tick durations of every session combined
+    TickHistogram getCombinedHistogram() const;
+};
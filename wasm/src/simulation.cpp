@@ -1,5 +1,7 @@
 #include "simulation.h"
 #include <algorithm>
+#include <cstring>
+#include "deterministic_math.h"
 
 // AircraftState implementation
 AircraftState::AircraftState() 
@@ -48,10 +50,62 @@ void AircraftProperties::setF16Properties() {
     criticalAOANegative = -0.262f; // ~-15 degrees
     minManeuverableSpeed = 20.0f; // ~40 knots
     maxSpeed = 686.0f; // ~2.0 Mach at sea level
+    outsideRadius = 8.0f;   // m
 }
 
+float AircraftProperties::liftCoefficient(float alpha) const {
+    // Limit angle of attack to critical values
+    alpha = std::max(criticalAOANegative, std::min(criticalAOAPositive, alpha));
+    
+    // Calculate lift coefficient
+    float Cl = Cl0 + ClAlpha * alpha;
+    
+    // Stall modeling
+    if (alpha > criticalAOAPositive * 0.8f) {
+        // Post-stall reduction
+        float stallFactor = 1.0f - (alpha - criticalAOAPositive * 0.8f) / 
+                           (criticalAOAPositive * 0.2f);
+        Cl *= std::max(0.3f, stallFactor);
+    }
+    
+    return std::max(-ClMax, std::min(ClMax, Cl));
+}
+
+float AircraftProperties::dragCoefficient(float Cl, float airspeed) const {
+    return Cd0 + K * Cl * Cl + dragRiseCoefficient(airspeed);
+}
+
+namespace {
+
+// Math routed through the portable implementations in deterministic mode
+float modeSin(bool deterministic, float x) {
+    return deterministic ? detmath::sin(x) : std::sin(x);
+}
+
+float modeCos(bool deterministic, float x) {
+    return deterministic ? detmath::cos(x) : std::cos(x);
+}
+
+float modeExp(bool deterministic, float x) {
+    return deterministic ? detmath::exp(x) : std::exp(x);
+}
+
+float modeAtan2(bool deterministic, float y, float x) {
+    return deterministic ? detmath::atan2(y, x) : std::atan2(y, x);
+}
+
+// Shared default (F-16) properties so new instances do not allocate their own
+const std::shared_ptr<const AircraftProperties>& defaultProperties() {
+    static const std::shared_ptr<const AircraftProperties> defaults =
+        std::make_shared<const AircraftProperties>();
+    return defaults;
+}
+
+} // namespace
+
 // FlightDynamics implementation
-FlightDynamics::FlightDynamics() : fuel(1000.0f) {
+FlightDynamics::FlightDynamics()
+    : props(defaultProperties()), fuel(1000.0f), deterministic(false), separateFuel(false) {
     reset();
 }
 
@@ -59,14 +113,15 @@ void FlightDynamics::initialize(const Vec3& position, float heading) {
     state.position = position;
     state.heading = heading;
     state.altitude = position.y;
-    state.velocity = Vec3(100.0f * std::cos(heading), 0, 100.0f * std::sin(heading));
+    state.velocity = Vec3(100.0f * modeCos(deterministic, heading), 0,
+                          100.0f * modeSin(deterministic, heading));
     state.airspeed = state.velocity.length();
-    fuel = props.maxFuel * 0.5f; // Start with 50% fuel
+    fuel = props->maxFuel * 0.5f; // Start with 50% fuel
 }
 
 void FlightDynamics::setAircraftType(const std::string& type) {
     if (type == "F-16") {
-        props.setF16Properties();
+        props = defaultProperties();
     }
     // Add more aircraft types as needed
 }
@@ -77,22 +132,63 @@ void FlightDynamics::setAircraftProperties(
     float critAOAPos, float critAOANeg,
     float minManeuverSpeed, float maxSpeed
 ) {
-    props.emptyMass = emptyMass;
-    props.maxFuel = maxFuel;
-    props.wingArea = wingArea;
-    props.maxThrust = maxThrust;
-    props.thrustMilitary = thrustMilitary;
-    props.criticalAOAPositive = critAOAPos;
-    props.criticalAOANegative = critAOANeg;
-    props.minManeuverableSpeed = minManeuverSpeed;
-    props.maxSpeed = maxSpeed;
+    // Copy on write: other instances may share the current properties
+    std::shared_ptr<AircraftProperties> edited = std::make_shared<AircraftProperties>(*props);
+    edited->emptyMass = emptyMass;
+    edited->maxFuel = maxFuel;
+    edited->wingArea = wingArea;
+    edited->maxThrust = maxThrust;
+    edited->thrustMilitary = thrustMilitary;
+    edited->criticalAOAPositive = critAOAPos;
+    edited->criticalAOANegative = critAOANeg;
+    edited->minManeuverableSpeed = minManeuverSpeed;
+    edited->maxSpeed = maxSpeed;
+    
+    // Recalculate some derived properties
+    float AR = edited->wingSpan * edited->wingSpan / edited->wingArea;
+    edited->K = 1.0f / (3.14159f * 0.8f * AR); // Oswald efficiency = 0.8
+    props = std::move(edited);
     
     // Update current mass and fuel
     state.mass = emptyMass + fuel;
-    
-    // Recalculate some derived properties
-    float AR = props.wingSpan * props.wingSpan / props.wingArea;
-    props.K = 1.0f / (3.14159f * 0.8f * AR); // Oswald efficiency = 0.8
+}
+
+void FlightDynamics::setProperties(const AircraftProperties& properties) {
+    setProperties(std::make_shared<const AircraftProperties>(properties));
+}
+
+void FlightDynamics::setProperties(std::shared_ptr<const AircraftProperties> properties) {
+    props = std::move(properties);
+    state.mass = props->emptyMass + fuel;
+}
+
+void FlightDynamics::save(FlightSnapshot& snapshot) const {
+    snapshot.state = state;
+    snapshot.fuel = fuel;
+    snapshot.gravity = gravity;
+    snapshot.airDensity = airDensity;
+}
+
+void FlightDynamics::restore(const FlightSnapshot& snapshot) {
+    state = snapshot.state;
+    fuel = snapshot.fuel;
+    gravity = snapshot.gravity;
+    airDensity = snapshot.airDensity;
+}
+
+uint64_t FlightDynamics::checksum(uint64_t seed) const {
+    FlightSnapshot snapshot;
+    save(snapshot);
+    
+    uint32_t words[sizeof(FlightSnapshot) / sizeof(uint32_t)];
+    static_assert(sizeof(words) == sizeof(FlightSnapshot), "FlightSnapshot must be a whole number of words");
+    std::memcpy(words, &snapshot, sizeof(words));
+    return detmath::hashWords(words, static_cast<int>(sizeof(words) / sizeof(uint32_t)), seed);
+}
+
+void FlightDynamics::setFuel(float newFuel) {
+    fuel = std::max(0.0f, std::min(props->maxFuel, newFuel));
+    state.mass = props->emptyMass + fuel;
 }
 
 void FlightDynamics::setThrottle(float throttle) {
@@ -105,28 +201,23 @@ void FlightDynamics::setControlSurfaces(float aileron, float elevator, float rud
     state.rudder = std::max(-1.0f, std::min(1.0f, rudder));
 }
 
+void FlightDynamics::setControls(const ControlInputs& controls) {
+    setThrottle(controls.throttle);
+    setControlSurfaces(controls.aileron, controls.elevator, controls.rudder);
+}
+
 void FlightDynamics::update(float deltaTime) {
-    // Update mass (fuel consumption)
-    state.mass = props.emptyMass + fuel;
-    
-    // Calculate thrust
-    state.thrust = state.throttle * props.maxThrust;
-    
-    // Fuel consumption
-    if (state.thrust > 0 && fuel > 0) {
-        float fuelFlow = state.thrust * props.thrustSFC * deltaTime;
-        fuel = std::max(0.0f, fuel - fuelFlow);
+    // Calculate thrust; mass and fuel follow here unless updated separately
+    state.thrust = state.throttle * props->maxThrust;
+    if (!separateFuel) {
+        updateFuel(deltaTime);
     }
     
     // Get air density at current altitude
     float rho = getAirDensity(state.altitude);
     
     // Calculate forces
-    Vec3 thrustForce(
-        state.thrust * std::cos(state.pitch) * std::cos(state.heading),
-        state.thrust * std::sin(state.pitch),
-        state.thrust * std::cos(state.pitch) * std::sin(state.heading)
-    );
+    Vec3 thrustForce = calculateThrustForce();
     
     Vec3 weight(0, -state.mass * gravity, 0);
     Vec3 aeroForces = calculateAerodynamicForces();
@@ -137,21 +228,101 @@ void FlightDynamics::update(float deltaTime) {
     Vec3 acceleration = totalForce * (1.0f / state.mass);
     
     // Update velocity and position
-    state.velocity = state.velocity + acceleration * deltaTime;
-    state.position = state.position + state.velocity * deltaTime;
+    state.velocity += acceleration * deltaTime;
+    state.position += state.velocity * deltaTime;
     
     // Update altitude and airspeed
     state.altitude = state.position.y;
     state.airspeed = state.velocity.length();
     
     // Calculate moments and angular rates (simplified)
-    Vec3 moments = calculateMoments();
+    integrateRates(calculateMoments(), deltaTime);
+    integrateAngles(deltaTime);
+}
+
+void FlightDynamics::updateFuel(float deltaTime) {
+    // Mass from the fuel at the start of the step, then burn at the current thrust
+    state.mass = props->emptyMass + fuel;
+    if (state.thrust > 0 && fuel > 0) {
+        float fuelFlow = state.thrust * props->thrustSFC * deltaTime;
+        fuel = std::max(0.0f, fuel - fuelFlow);
+    }
+}
+
+void FlightDynamics::updatePointMass(float deltaTime) {
+    updatePointMassDynamics(deltaTime);
+    advanceKinematics(deltaTime);
+}
+
+void FlightDynamics::updatePointMassDynamics(float deltaTime) {
+    // Engine and fuel as in update()
+    state.thrust = state.throttle * props->maxThrust;
+    if (!separateFuel) {
+        updateFuel(deltaTime);
+    }
     
+    float speed = state.velocity.length();
+    if (speed < 1.0f) {
+        // Path axes are undefined when nearly stationary; apply the full model's forces
+        Vec3 weight(0, -state.mass * gravity, 0);
+        Vec3 totalForce = calculateThrustForce() + weight + calculateAerodynamicForces();
+        state.velocity += totalForce * (deltaTime / state.mass);
+        state.airspeed = state.velocity.length();
+        integrateRates(calculateMoments(), deltaTime);
+        return;
+    }
+    
+    float q = 0.5f * getAirDensity(state.altitude) * speed * speed;
+    float S = props->wingArea;
+    
+    // Flight path angle from the velocity
+    float horizontalSpeed = std::sqrt(state.velocity.x * state.velocity.x +
+                                      state.velocity.z * state.velocity.z);
+    float cosPath = horizontalSpeed / speed;
+    float sinPath = state.velocity.y / speed;
+    
+    // Lift carries the weight normal to the path; drag comes from the same polar as update()
+    float Cl = q > 0 ? state.mass * gravity * cosPath / (q * S) : 0.0f;
+    Cl = std::max(-props->ClMax, std::min(props->ClMax, Cl));
+    float drag = q * S * props->dragCoefficient(Cl, speed);
+    float newSpeed = speed + ((state.thrust - drag) / state.mass - gravity * sinPath) * deltaTime;
+    newSpeed = std::max(0.0f, newSpeed);
+    
+    // The path turns and climbs with the attitude rates (small-angle rotations)
+    float horizontalX, horizontalZ;
+    if (horizontalSpeed > 1e-3f) {
+        horizontalX = state.velocity.x / horizontalSpeed;
+        horizontalZ = state.velocity.z / horizontalSpeed;
+    } else {
+        horizontalX = modeCos(deterministic, state.heading);
+        horizontalZ = modeSin(deterministic, state.heading);
+    }
+    float turn = state.headingRate * deltaTime;
+    float climb = state.pitchRate * deltaTime;
+    float turnedX = horizontalX - horizontalZ * turn;
+    float turnedZ = horizontalZ + horizontalX * turn;
+    float climbedCos = cosPath - sinPath * climb;
+    float climbedSin = sinPath + cosPath * climb;
+    Vec3 direction = Vec3(turnedX * climbedCos, climbedSin, turnedZ * climbedCos).normalized();
+    
+    state.velocity = direction * newSpeed;
+    state.airspeed = newSpeed;
+    
+    integrateRates(calculateMoments(q), deltaTime);
+}
+
+void FlightDynamics::advanceKinematics(float deltaTime) {
+    state.position += state.velocity * deltaTime;
+    state.altitude = state.position.y;
+    integrateAngles(deltaTime);
+}
+
+void FlightDynamics::integrateRates(const Vec3& moments, float deltaTime) {
     // Update angular velocities with proper inertia approximation
     // Using simplified moment of inertia values
-    const float Ixx = state.mass * props.wingSpan * props.wingSpan * 0.1f;  // Roll inertia
-    const float Iyy = state.mass * props.wingSpan * props.wingSpan * 0.2f;  // Pitch inertia
-    const float Izz = state.mass * props.wingSpan * props.wingSpan * 0.3f;  // Yaw inertia
+    const float Ixx = state.mass * props->wingSpan * props->wingSpan * 0.1f;  // Roll inertia
+    const float Iyy = state.mass * props->wingSpan * props->wingSpan * 0.2f;  // Pitch inertia
+    const float Izz = state.mass * props->wingSpan * props->wingSpan * 0.3f;  // Yaw inertia
     
     // Angular accelerations
     float rollAccel = moments.x / Ixx;
@@ -171,27 +342,27 @@ void FlightDynamics::update(float deltaTime) {
     state.rollRate = std::max(-maxRollRate, std::min(maxRollRate, state.rollRate));
     state.pitchRate = std::max(-maxPitchRate, std::min(maxPitchRate, state.pitchRate));
     state.headingRate = std::max(-maxYawRate, std::min(maxYawRate, state.headingRate));
-    
+}
+
+void FlightDynamics::integrateAngles(float deltaTime) {
     // Update orientation using proper Euler angle integration
     state.roll += state.rollRate * deltaTime;
     state.pitch += state.pitchRate * deltaTime;
     state.heading += state.headingRate * deltaTime;
     
     // Normalize angles
-    while (state.roll > M_PI) state.roll -= 2.0f * M_PI;
-    while (state.roll < -M_PI) state.roll += 2.0f * M_PI;
+    state.roll = wrapAngle(state.roll);
     
     // Limit pitch to prevent gimbal lock
     state.pitch = std::max(static_cast<float>(-M_PI * 0.45f), 
                           std::min(static_cast<float>(M_PI * 0.45f), state.pitch));
     
-    while (state.heading > M_PI) state.heading -= 2.0f * M_PI;
-    while (state.heading < -M_PI) state.heading += 2.0f * M_PI;
+    state.heading = wrapAngle(state.heading);
 }
 
 float FlightDynamics::getAirDensity(float altitude) const {
     // Simple exponential atmosphere model
-    return airDensity * std::exp(-altitude / 8000.0f);
+    return airDensity * modeExp(deterministic, -altitude / 8000.0f);
 }
 
 float FlightDynamics::getDynamicPressure() const {
@@ -199,9 +370,19 @@ float FlightDynamics::getDynamicPressure() const {
     return 0.5f * rho * state.airspeed * state.airspeed;
 }
 
+Vec3 FlightDynamics::calculateThrustForce() const {
+    // Thrust acts along the nose direction
+    float cosPitch = modeCos(deterministic, state.pitch);
+    return Vec3(
+        state.thrust * cosPitch * modeCos(deterministic, state.heading),
+        state.thrust * modeSin(deterministic, state.pitch),
+        state.thrust * cosPitch * modeSin(deterministic, state.heading)
+    );
+}
+
 Vec3 FlightDynamics::calculateAerodynamicForces() const {
     float q = getDynamicPressure();
-    float S = props.wingArea;
+    float S = props->wingArea;
     
     // Calculate angle of attack (alpha) properly
     // This is the angle between the velocity vector and the aircraft's x-axis
@@ -217,41 +398,18 @@ Vec3 FlightDynamics::calculateAerodynamicForces() const {
         float horizontalSpeed = std::sqrt(state.velocity.x * state.velocity.x + 
                                          state.velocity.z * state.velocity.z);
         if (horizontalSpeed > 0.1f) {
-            alpha = std::atan2(-state.velocity.y, horizontalSpeed) + state.pitch;
+            alpha = modeAtan2(deterministic, -state.velocity.y, horizontalSpeed) + state.pitch;
         }
     }
     
-    // Limit angle of attack to critical values
-    alpha = std::max(props.criticalAOANegative, std::min(props.criticalAOAPositive, alpha));
-    
-    // Calculate lift coefficient
-    float Cl = props.Cl0 + props.ClAlpha * alpha;
-    
-    // Stall modeling
-    if (alpha > props.criticalAOAPositive * 0.8f) {
-        // Post-stall reduction
-        float stallFactor = 1.0f - (alpha - props.criticalAOAPositive * 0.8f) / 
-                           (props.criticalAOAPositive * 0.2f);
-        Cl *= std::max(0.3f, stallFactor);
-    }
-    
-    Cl = std::max(-props.ClMax, std::min(props.ClMax, Cl));
+    float Cl = props->liftCoefficient(alpha);
     float lift = q * S * Cl;
-    
-    // Calculate drag coefficient
-    float Cd = props.Cd0 + props.K * Cl * Cl;
-    
-    // Add speed-dependent drag
-    if (state.airspeed > props.maxSpeed * 0.8f) {
-        float speedFactor = (state.airspeed - props.maxSpeed * 0.8f) / 
-                           (props.maxSpeed * 0.2f);
-        Cd += speedFactor * 0.1f; // Additional drag near max speed
-    }
+    float Cd = props->dragCoefficient(Cl, state.airspeed);
     
     float drag = q * S * Cd;
     
     // Side force from rudder
-    float sideForce = q * S * state.rudder * props.rudderEffect * 0.2f;
+    float sideForce = q * S * state.rudder * props->rudderEffect * 0.2f;
     
     // Transform forces to world coordinates
     // Lift acts perpendicular to velocity vector
@@ -263,12 +421,14 @@ Vec3 FlightDynamics::calculateAerodynamicForces() const {
     if (velocityMagnitude > 0.1f) {
         // Velocity direction
         Vec3 velocityDir = state.velocity.normalized();
+        float cosHeading = modeCos(deterministic, state.heading);
+        float sinHeading = modeSin(deterministic, state.heading);
         
         // Calculate lift direction (perpendicular to velocity, in the pitch plane)
         Vec3 liftDir(
-            -velocityDir.y * std::cos(state.heading),
-            velocityDir.x * std::cos(state.heading) + velocityDir.z * std::sin(state.heading),
-            -velocityDir.y * std::sin(state.heading)
+            -velocityDir.y * cosHeading,
+            velocityDir.x * cosHeading + velocityDir.z * sinHeading,
+            -velocityDir.y * sinHeading
         );
         liftDir = liftDir.normalized();
         
@@ -277,9 +437,9 @@ Vec3 FlightDynamics::calculateAerodynamicForces() const {
         
         // Side force (simplified)
         sideVector = Vec3(
-            -sideForce * std::sin(state.heading),
+            -sideForce * sinHeading,
             0,
-            sideForce * std::cos(state.heading)
+            sideForce * cosHeading
         );
     }
     
@@ -287,37 +447,39 @@ Vec3 FlightDynamics::calculateAerodynamicForces() const {
 }
 
 Vec3 FlightDynamics::calculateMoments() const {
-    float q = getDynamicPressure();
-    
+    return calculateMoments(getDynamicPressure());
+}
+
+Vec3 FlightDynamics::calculateMoments(float q) const {
     // More realistic moment calculations
-    float S = props.wingArea;
-    float b = props.wingSpan;
+    float S = props->wingArea;
+    float b = props->wingSpan;
     float c = S / b; // Mean aerodynamic chord
     
     // Roll moment from ailerons
-    float rollMoment = q * S * b * state.aileron * props.aileronEffect;
+    float rollMoment = q * S * b * state.aileron * props->aileronEffect;
     
     // Add roll damping
     rollMoment -= q * S * b * b * state.rollRate * 0.1f;
     
     // Add adverse yaw from ailerons
-    float adverseYaw = -state.aileron * props.aileronEffect * 0.2f;
+    float adverseYaw = -state.aileron * props->aileronEffect * 0.2f;
     
     // Pitch moment from elevator
-    float pitchMoment = q * S * c * state.elevator * props.elevatorEffect;
+    float pitchMoment = q * S * c * state.elevator * props->elevatorEffect;
     
     // Add pitch damping
     pitchMoment -= q * S * c * c * state.pitchRate * 0.2f;
     
     // Add speed stability (nose-down tendency at high speed)
-    if (state.airspeed > props.maxSpeed * 0.7f) {
-        float speedFactor = (state.airspeed - props.maxSpeed * 0.7f) / 
-                           (props.maxSpeed * 0.3f);
+    if (state.airspeed > props->maxSpeed * 0.7f) {
+        float speedFactor = (state.airspeed - props->maxSpeed * 0.7f) / 
+                           (props->maxSpeed * 0.3f);
         pitchMoment -= q * S * c * speedFactor * 0.1f;
     }
     
     // Yaw moment from rudder
-    float yawMoment = q * S * b * state.rudder * props.rudderEffect;
+    float yawMoment = q * S * b * state.rudder * props->rudderEffect;
     
     // Add yaw damping
     yawMoment -= q * S * b * b * state.headingRate * 0.15f;
@@ -335,5 +497,5 @@ Vec3 FlightDynamics::calculateMoments() const {
 
 void FlightDynamics::reset() {
     state = AircraftState();
-    fuel = props.maxFuel * 0.5f;
+    fuel = props->maxFuel * 0.5f;
 }
\ No newline at end of file
@@ -1,36 +1,24 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
+#include "vector_math.h"
 
-// Basic 3D vector class
-struct Vec3 {
-    float x, y, z;
-    
-    Vec3() : x(0), y(0), z(0) {}
-    Vec3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
-    
-    Vec3 operator+(const Vec3& other) const {
-        return Vec3(x + other.x, y + other.y, z + other.z);
-    }
-    
-    Vec3 operator*(float scalar) const {
-        return Vec3(x * scalar, y * scalar, z * scalar);
+// Angle wrapped into [-pi, pi] in constant time; fmod is exact, so the result is the same
+// on every target. Non-finite input comes back as NaN.
+inline float wrapAngle(float angle) {
+    double wrapped = std::fmod(static_cast<double>(angle), 2.0 * M_PI);
+    if (wrapped > M_PI) {
+        wrapped -= 2.0 * M_PI;
+    } else if (wrapped < -M_PI) {
+        wrapped += 2.0 * M_PI;
     }
-    
-    float length() const {
-        return std::sqrt(x * x + y * y + z * z);
-    }
-    
-    Vec3 normalized() const {
-        float len = length();
-        if (len > 0) {
-            return Vec3(x / len, y / len, z / len);
-        }
-        return *this;
-    }
-};
+    return static_cast<float>(wrapped);
+}
 
 // Basic aircraft state
 struct AircraftState {
@@ -67,6 +55,16 @@ struct AircraftState {
     AircraftState();
 };
 
+// Pilot control inputs (throttle 0.0 to 1.0, surfaces -1.0 to 1.0)
+struct ControlInputs {
+    float throttle;
+    float aileron;
+    float elevator;
+    float rudder;
+    
+    ControlInputs() : throttle(0), aileron(0), elevator(0), rudder(0) {}
+};
+
 // Aircraft properties
 struct AircraftProperties {
     std::string name;
@@ -99,22 +97,51 @@ struct AircraftProperties {
     float criticalAOANegative; // Critical angle of attack negative (rad)
     float minManeuverableSpeed; // Minimum maneuverable speed (m/s)
     float maxSpeed;            // Maximum speed (m/s)
+    float outsideRadius;       // Bounding sphere radius (m), HTRADIUS
     
     AircraftProperties();
     void setF16Properties(); // Default F-16 properties
+    
+    // Aerodynamic coefficient model shared by the dynamics and offline analysis
+    float liftCoefficient(float alpha) const;
+    float dragCoefficient(float Cl, float airspeed) const;
+    // Part of dragCoefficient added above 80% of max speed; branch-free for vectorized callers
+    float dragRiseCoefficient(float airspeed) const {
+        float speedFactor = (airspeed - maxSpeed * 0.8f) / (maxSpeed * 0.2f);
+        return speedFactor > 0.0f ? speedFactor * 0.1f : 0.0f;
+    }
+};
+
+// Complete dynamic state of a FlightDynamics instance.
+// Plain data: copy it with memcpy or store it in any caller-owned buffer.
+struct FlightSnapshot {
+    AircraftState state;
+    float fuel;
+    float gravity;
+    float airDensity;
 };
 
-// Simple flight dynamics model
+static_assert(std::is_trivially_copyable<FlightSnapshot>::value, "FlightSnapshot must stay plain data");
+
+// Simple flight dynamics model.
+// Properties are immutable and shared between copies, so copying an instance (cloning)
+// costs only the dynamic state; setters that change properties copy them first.
 class FlightDynamics {
 private:
     AircraftState state;
-    AircraftProperties props;
+    std::shared_ptr<const AircraftProperties> props;
     float fuel;             // Current fuel (kg)
+    bool deterministic;     // Portable math for bit-exact results across builds
+    bool separateFuel;      // Mass and fuel left to updateFuel() instead of every step
     
     // Environment
     float gravity = 9.81f;  // m/s^2
     float airDensity = 1.225f; // kg/m^3 at sea level
     
+    // Angular rates from the moments, then attitude from the rates (shared by both update paths)
+    void integrateRates(const Vec3& moments, float deltaTime);
+    void integrateAngles(float deltaTime);
+    
 public:
     FlightDynamics();
     
@@ -125,6 +152,7 @@ public:
     // Control inputs
     void setThrottle(float throttle);
     void setControlSurfaces(float aileron, float elevator, float rudder);
+    void setControls(const ControlInputs& controls);
     
     // Set aircraft properties from loaded data
     void setAircraftProperties(
@@ -133,20 +161,54 @@ public:
         float critAOAPos, float critAOANeg,
         float minManeuverSpeed, float maxSpeed
     );
+    void setProperties(const AircraftProperties& properties);
+    void setProperties(std::shared_ptr<const AircraftProperties> properties);
+    
+    // Overwrite dynamic state (trim solver, spawning)
+    void setState(const AircraftState& newState) { state = newState; }
+    void setFuel(float newFuel);
     
     // Update simulation
     void update(float deltaTime);
+    // Cheaper 3-DOF step for distant aircraft: speed from thrust, drag and gravity along the
+    // flight path (lift balances weight), path direction turned by the attitude rates.
+    // Works on the same state as update(), so the two can be switched between at any tick.
+    void updatePointMass(float deltaTime);
+    // updatePointMass in two halves, so velocity and rates can be stepped at a lower rate
+    // than position and attitude
+    void updatePointMassDynamics(float deltaTime);
+    void advanceKinematics(float deltaTime);
+    // Mass and fuel burn at the current thrust. Part of every step unless separate fuel
+    // updates are enabled, in which case the caller runs it at its own (lower) rate.
+    void updateFuel(float deltaTime);
+    void setSeparateFuelUpdate(bool enabled) { separateFuel = enabled; }
+    bool hasSeparateFuelUpdate() const { return separateFuel; }
     
     // Get state
     const AircraftState& getState() const { return state; }
-    const AircraftProperties& getProperties() const { return props; }
+    const AircraftProperties& getProperties() const { return *props; }
+    const std::shared_ptr<const AircraftProperties>& getSharedProperties() const { return props; }
     float getFuel() const { return fuel; }
+    float getGravity() const { return gravity; }
+    
+    // Save/restore the dynamic state (properties are not included)
+    void save(FlightSnapshot& snapshot) const;
+    void restore(const FlightSnapshot& snapshot);
+    
+    // Deterministic mode replaces libm sin/cos/exp/atan2 with the detmath implementations
+    void setDeterministic(bool enabled) { deterministic = enabled; }
+    bool isDeterministic() const { return deterministic; }
+    
+    // Hash of the full dynamic state, chained onto seed
+    uint64_t checksum(uint64_t seed) const;
     
     // Helper methods
     float getAirDensity(float altitude) const;
     float getDynamicPressure() const;
+    Vec3 calculateThrustForce() const;
     Vec3 calculateAerodynamicForces() const;
     Vec3 calculateMoments() const;
+    Vec3 calculateMoments(float dynamicPressure) const;
     
     // Reset
     void reset();
@@ -1,5 +1,20 @@
 #include <emscripten/bind.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "dat_loader.h"
+#include "deterministic_math.h"
+#include "fleet.h"
+#include "flight_recorder.h"
+#include "heap_buffer.h"
+#include "instance_buffer.h"
+#include "memory_stats.h"
+#include "remote_entity.h"
+#include "replay.h"
+#include "rollback.h"
 #include "simulation.h"
+#include "visibility.h"
 
 using namespace emscripten;
 
@@ -43,10 +58,66 @@ EMSCRIPTEN_BINDINGS(aircraft_properties_bindings) {
         .field("maxThrust", &AircraftProperties::maxThrust);
 }
 
+// Convert aircraft state to a plain JavaScript object
+static val aircraftStateToJs(const AircraftState& state, float fuel) {
+    val jsState = val::object();
+    
+    // Position
+    val position = val::object();
+    position.set("x", state.position.x);
+    position.set("y", state.position.y);
+    position.set("z", state.position.z);
+    jsState.set("position", position);
+    
+    // Velocity
+    val velocity = val::object();
+    velocity.set("x", state.velocity.x);
+    velocity.set("y", state.velocity.y);
+    velocity.set("z", state.velocity.z);
+    jsState.set("velocity", velocity);
+    
+    // Orientation
+    jsState.set("heading", state.heading);
+    jsState.set("pitch", state.pitch);
+    jsState.set("roll", state.roll);
+    
+    // Angular rates
+    jsState.set("headingRate", state.headingRate);
+    jsState.set("pitchRate", state.pitchRate);
+    jsState.set("rollRate", state.rollRate);
+    
+    // Controls
+    jsState.set("throttle", state.throttle);
+    jsState.set("thrust", state.thrust);
+    jsState.set("aileron", state.aileron);
+    jsState.set("elevator", state.elevator);
+    jsState.set("rudder", state.rudder);
+    
+    // Status
+    jsState.set("altitude", state.altitude);
+    jsState.set("airspeed", state.airspeed);
+    jsState.set("mass", state.mass);
+    jsState.set("fuel", fuel);
+    
+    return jsState;
+}
+
+static val aircraftStateToJs(const FlightDynamics& dynamics) {
+    return aircraftStateToJs(dynamics.getState(), dynamics.getFuel());
+}
+
+// 64-bit checksums cross to JavaScript as 16-digit hex strings
+static std::string checksumToHex(uint64_t checksum) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(checksum));
+    return text;
+}
+
 // Wrapper class for JavaScript-friendly interface
 class SimulationWrapper {
 private:
     FlightDynamics dynamics;
+    FlightSnapshot snapshot;
     
 public:
     SimulationWrapper() {}
@@ -82,51 +153,13 @@ public:
     }
     
     void update(float deltaTime) {
+        HotPathScope hotPath;
+        MemoryTagScope tag(MEM_PHYSICS);
         dynamics.update(deltaTime);
     }
     
     val getState() {
-        const AircraftState& state = dynamics.getState();
-        val jsState = val::object();
-        
-        // Position
-        val position = val::object();
-        position.set("x", state.position.x);
-        position.set("y", state.position.y);
-        position.set("z", state.position.z);
-        jsState.set("position", position);
-        
-        // Velocity
-        val velocity = val::object();
-        velocity.set("x", state.velocity.x);
-        velocity.set("y", state.velocity.y);
-        velocity.set("z", state.velocity.z);
-        jsState.set("velocity", velocity);
-        
-        // Orientation
-        jsState.set("heading", state.heading);
-        jsState.set("pitch", state.pitch);
-        jsState.set("roll", state.roll);
-        
-        // Angular rates
-        jsState.set("headingRate", state.headingRate);
-        jsState.set("pitchRate", state.pitchRate);
-        jsState.set("rollRate", state.rollRate);
-        
-        // Controls
-        jsState.set("throttle", state.throttle);
-        jsState.set("thrust", state.thrust);
-        jsState.set("aileron", state.aileron);
-        jsState.set("elevator", state.elevator);
-        jsState.set("rudder", state.rudder);
-        
-        // Status
-        jsState.set("altitude", state.altitude);
-        jsState.set("airspeed", state.airspeed);
-        jsState.set("mass", state.mass);
-        jsState.set("fuel", dynamics.getFuel());
-        
-        return jsState;
+        return aircraftStateToJs(dynamics);
     }
     
     val getProperties() {
@@ -139,6 +172,7 @@ public:
         jsProps.set("wingArea", props.wingArea);
         jsProps.set("wingSpan", props.wingSpan);
         jsProps.set("maxThrust", props.maxThrust);
+        jsProps.set("outsideRadius", props.outsideRadius);
         
         return jsProps;
     }
@@ -146,6 +180,40 @@ public:
     void reset() {
         dynamics.reset();
     }
+    
+    void setDeterministic(bool enabled) {
+        dynamics.setDeterministic(enabled);
+    }
+    
+    std::string getChecksum() const {
+        return checksumToHex(dynamics.checksum(detmath::kHashSeed));
+    }
+    
+    // Independent copy sharing the aircraft properties
+    SimulationWrapper clone() const {
+        return *this;
+    }
+    
+    // View into WASM memory, valid until the next saveSnapshot call; copy to keep it
+    val saveSnapshot() {
+        dynamics.save(snapshot);
+        return val(typed_memory_view(sizeof(FlightSnapshot), reinterpret_cast<const uint8_t*>(&snapshot)));
+    }
+    
+    bool restoreSnapshot(val bytes) {
+        if (bytes["length"].as<size_t>() != sizeof(FlightSnapshot)) {
+            return false;
+        }
+        // One set() straight into the snapshot
+        FlightSnapshot restored;
+        val(typed_memory_view(sizeof(restored), reinterpret_cast<uint8_t*>(&restored))).call<void>("set", bytes);
+        dynamics.restore(restored);
+        return true;
+    }
+    
+    const FlightDynamics& getDynamics() const {
+        return dynamics;
+    }
 };
 
 // Binding for SimulationWrapper
@@ -160,5 +228,918 @@ EMSCRIPTEN_BINDINGS(simulation_bindings) {
         .function("update", &SimulationWrapper::update)
         .function("getState", &SimulationWrapper::getState)
         .function("getProperties", &SimulationWrapper::getProperties)
-        .function("reset", &SimulationWrapper::reset);
-}
\ No newline at end of file
+        .function("reset", &SimulationWrapper::reset)
+        .function("setDeterministic", &SimulationWrapper::setDeterministic)
+        .function("getChecksum", &SimulationWrapper::getChecksum)
+        .function("clone", &SimulationWrapper::clone)
+        .function("saveSnapshot", &SimulationWrapper::saveSnapshot)
+        .function("restoreSnapshot", &SimulationWrapper::restoreSnapshot);
+}
+
+// Trim tables for aircraft types registered from DAT text
+class TrimCacheWrapper {
+private:
+    TrimCache cache;
+    // Shared with every fleet aircraft spawned from this cache
+    std::vector<std::shared_ptr<const AircraftProperties>> aircraft;
+    
+public:
+    TrimCacheWrapper() {}
+    
+    // Returns the aircraft name (IDENTIFY), or an empty string if the DAT is invalid
+    std::string addAircraftDat(const std::string& datText) {
+        AircraftProperties props;
+        if (!parseAircraftDat(datText, props)) {
+            return std::string();
+        }
+        std::shared_ptr<const AircraftProperties> shared = std::make_shared<const AircraftProperties>(props);
+        for (std::shared_ptr<const AircraftProperties>& existing : aircraft) {
+            if (existing->name == props.name) {
+                existing = shared;
+                return props.name;
+            }
+        }
+        aircraft.push_back(shared);
+        return props.name;
+    }
+    
+    // Grid axes as strictly ascending JavaScript arrays (m, m/s); returns false otherwise
+    bool compute(val altitudes, val speeds) {
+        std::vector<AircraftProperties> types;
+        for (const std::shared_ptr<const AircraftProperties>& props : aircraft) {
+            types.push_back(*props);
+        }
+        return cache.compute(types,
+                             convertJSArrayToNumberVector<float>(altitudes),
+                             convertJSArrayToNumberVector<float>(speeds));
+    }
+    
+    val lookup(const std::string& name, float altitude, float speed) const {
+        const TrimTable* table = cache.find(name);
+        if (!table) {
+            return val::null();
+        }
+        TrimResult trim = table->lookup(altitude, speed);
+        val result = val::object();
+        result.set("throttle", trim.throttle);
+        result.set("elevator", trim.elevator);
+        result.set("alpha", trim.alpha);
+        result.set("residual", trim.residual);
+        result.set("converged", trim.converged);
+        return result;
+    }
+    
+    std::shared_ptr<const AircraftProperties> findAircraft(const std::string& name) const {
+        for (const std::shared_ptr<const AircraftProperties>& props : aircraft) {
+            if (props->name == name) {
+                return props;
+            }
+        }
+        return nullptr;
+    }
+    
+    const TrimCache& getCache() const { return cache; }
+};
+
+// Wrapper class for a batch of simulated aircraft
+class FleetWrapper {
+private:
+    AircraftFleet fleet;
+    std::vector<Vec3> focus;    // Reused by selectPhysicsLod
+    
+    // Indices come straight from JS; calls with a bad one are ignored
+    bool hasAircraft(int index) const {
+        return index >= 0 && index < fleet.size();
+    }
+    
+public:
+    FleetWrapper() {}
+    
+    int addAircraft(float x, float y, float z, float heading) {
+        return fleet.addAircraft(Vec3(x, y, z), heading);
+    }
+    
+    // Returns -1 if the type has no trim table
+    int addTrimmedAircraft(const TrimCacheWrapper& trimCache, const std::string& name,
+                           float x, float y, float z, float heading, float speed) {
+        std::shared_ptr<const AircraftProperties> props = trimCache.findAircraft(name);
+        const TrimTable* table = trimCache.getCache().find(name);
+        if (!props || !table) {
+            return -1;
+        }
+        return fleet.addTrimmedAircraft(props, Vec3(x, y, z), heading, speed, table->lookup(y, speed));
+    }
+    
+    void clear() {
+        fleet.clear();
+    }
+    
+    int getCount() const {
+        return fleet.size();
+    }
+    
+    void setAircraftType(int index, const std::string& type) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAircraft(index).setAircraftType(type);
+    }
+    
+    void setAircraftProperties(
+        int index,
+        float emptyMass, float maxFuel, float wingArea,
+        float maxThrust, float thrustMilitary,
+        float critAOAPos, float critAOANeg,
+        float minManeuverSpeed, float maxSpeed
+    ) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAircraft(index).setAircraftProperties(
+            emptyMass, maxFuel, wingArea,
+            maxThrust, thrustMilitary,
+            critAOAPos, critAOANeg,
+            minManeuverSpeed, maxSpeed
+        );
+    }
+    
+    void setControls(int index, float throttle, float aileron, float elevator, float rudder) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        ControlInputs controls;
+        controls.throttle = throttle;
+        controls.aileron = aileron;
+        controls.elevator = elevator;
+        controls.rudder = rudder;
+        fleet.getAircraft(index).setControls(controls);
+    }
+    
+    // Autopilot
+    void setAutopilotMode(int index, unsigned int mode) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAutopilot().setMode(index, mode);
+    }
+    
+    void setTargetAltitude(int index, float altitude) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAutopilot().setTargetAltitude(index, altitude);
+    }
+    
+    void setTargetHeading(int index, float heading) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAutopilot().setTargetHeading(index, heading);
+    }
+    
+    void setTargetSpeed(int index, float speed) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAutopilot().setTargetSpeed(index, speed);
+    }
+    
+    void setThrottleTrim(int index, float throttle) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAutopilot().setThrottleTrim(index, throttle);
+    }
+    
+    void addWaypoint(int index, float x, float y, float z, float speed) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAutopilot().addWaypoint(index, Waypoint(Vec3(x, y, z), speed));
+    }
+    
+    void clearWaypoints(int index) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAutopilot().clearWaypoints(index);
+    }
+    
+    void setRouteLooping(int index, bool loop) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.getAutopilot().setRouteLooping(index, loop);
+    }
+    
+    int getCurrentWaypoint(int index) const {
+        if (!hasAircraft(index)) {
+            return -1;
+        }
+        return fleet.getAutopilot().getCurrentWaypoint(index);
+    }
+    
+    void update(float deltaTime) {
+        HotPathScope hotPath;
+        fleet.update(deltaTime);
+    }
+    
+    val getState(int index) {
+        if (!hasAircraft(index)) {
+            return val::null();
+        }
+        return aircraftStateToJs(fleet.getAircraft(index));
+    }
+    
+    // Physics level of detail
+    void setPhysicsLod(int index, unsigned int lod) {
+        if (!hasAircraft(index)) {
+            return;
+        }
+        fleet.setPhysicsLod(index, lod == PHYSICS_FULL ? PHYSICS_FULL : PHYSICS_POINT_MASS);
+    }
+    
+    unsigned int getPhysicsLod(int index) const {
+        if (!hasAircraft(index)) {
+            return PHYSICS_FULL;
+        }
+        return fleet.getPhysicsLod(index);
+    }
+    
+    int getPointMassCount() const {
+        return fleet.getPointMassCount();
+    }
+    
+    // Focus points as a flat [x, y, z, x, y, z, ...] array
+    void selectPhysicsLod(val focusPoints, float fullRadius) {
+        ScratchPool::Lease flat = ScratchPool::shared().copy(focusPoints);
+        const float* points = flat->data();
+        focus.clear();
+        for (int i = 0; i + 2 < flat->getLength(); i += 3) {
+            focus.push_back(Vec3(points[i], points[i + 1], points[i + 2]));
+        }
+        fleet.selectPhysicsLod(focus, fullRadius);
+    }
+    
+    void setPointMassInterval(int ticks) {
+        fleet.setPointMassInterval(ticks);
+    }
+    
+    void setDeterministic(bool enabled) {
+        fleet.setDeterministic(enabled);
+    }
+    
+    // Rolling checksum over every tick since the fleet was created or cleared
+    std::string getChecksum() const {
+        return checksumToHex(fleet.getChecksum());
+    }
+    
+    const AircraftFleet& getFleet() const {
+        return fleet;
+    }
+    
+    AircraftFleet& getFleet() {
+        return fleet;
+    }
+};
+
+// Wrapper class for the flight data recorder
+class FlightRecorderWrapper {
+private:
+    FlightRecorder recorder;
+    std::vector<uint8_t> serialized;
+    
+public:
+    // Arguments are clamped: at least one tick per keyframe, and a budget in [1, 2048] MB
+    // so the byte count fits the 32-bit size_t
+    FlightRecorderWrapper(int keyframeInterval, int memoryBudgetMB)
+        : recorder(static_cast<uint32_t>(std::max(keyframeInterval, 1)),
+                   static_cast<size_t>(std::min(std::max(memoryBudgetMB, 1), 2048)) * 1024 * 1024) {}
+    
+    // Call once per fleet physics tick
+    void recordFleet(const FleetWrapper& fleet) {
+        recorder.recordFleet(fleet.getFleet());
+    }
+    
+    // False for a track index past getTrackCount() or once the recorder is full
+    bool recordSimulation(int trackIndex, const SimulationWrapper& simulation, double time) {
+        return recorder.recordAircraft(trackIndex, time, simulation.getDynamics());
+    }
+    
+    void clear() {
+        recorder.clear();
+    }
+    
+    int getTrackCount() const {
+        return recorder.getTrackCount();
+    }
+    
+    // 0 for an invalid track index
+    int getTickCount(int track) const {
+        if (track < 0 || track >= recorder.getTrackCount()) {
+            return 0;
+        }
+        return static_cast<int>(recorder.getTrack(track).getTickCount());
+    }
+    
+    bool isFull() const {
+        return recorder.isFull();
+    }
+    
+    double getAllocatedBytes() const {
+        return static_cast<double>(recorder.getAllocatedBytes());
+    }
+    
+    double getEncodedBytes() const {
+        return static_cast<double>(recorder.getEncodedBytes());
+    }
+    
+    // View into WASM memory, valid until the next serializeTrack call; copy before saving.
+    // null for an invalid track index
+    val serializeTrack(int track) {
+        if (track < 0 || track >= recorder.getTrackCount()) {
+            return val::null();
+        }
+        recorder.getTrack(track).serialize(serialized);
+        return val(typed_memory_view(serialized.size(), serialized.data()));
+    }
+    
+    const FlightRecorder& getRecorder() const {
+        return recorder;
+    }
+};
+
+// Wrapper class for ghost playback of recorded tracks
+class ReplayWrapper {
+private:
+    ReplayEngine engine;
+    std::vector<uint8_t> loaded;    // Serialized track being loaded
+    
+public:
+    ReplayWrapper() {}
+    
+    // Load a serialized track (Uint8Array); returns the ghost index or -1 if malformed
+    int loadTrack(val bytes) {
+        copyBytes(bytes, loaded);
+        std::unique_ptr<RecordedTrack> track = RecordedTrack::deserialize(loaded.data(), loaded.size());
+        if (!track) {
+            return -1;
+        }
+        return engine.addGhost(std::move(track));
+    }
+    
+    // Snapshot of a track still being recorded
+    int addRecordedTrack(const FlightRecorderWrapper& recorder, int track) {
+        if (track < 0 || track >= recorder.getTrackCount()) {
+            return -1;
+        }
+        return engine.addGhost(recorder.getRecorder().getTrack(track).clone());
+    }
+    
+    void clear() {
+        engine.clear();
+    }
+    
+    void seek(double time) {
+        engine.seek(time);
+    }
+    
+    void advance(double deltaTime) {
+        engine.advance(deltaTime);
+    }
+    
+    double getTime() const {
+        return engine.getTime();
+    }
+    
+    double getStartTime() const {
+        return engine.getStartTime();
+    }
+    
+    double getEndTime() const {
+        return engine.getEndTime();
+    }
+    
+    int getGhostCount() const {
+        return engine.getGhostCount();
+    }
+    
+    // Empty for an invalid index
+    std::string getAircraftName(int index) const {
+        if (index < 0 || index >= engine.getGhostCount()) {
+            return std::string();
+        }
+        return engine.getTrack(index).getAircraftName();
+    }
+    
+    val getState(int index) {
+        if (index < 0 || index >= engine.getGhostCount()) {
+            return val::null();
+        }
+        const RecordedSample& sample = engine.getSample(index);
+        return aircraftStateToJs(sample.state, sample.fuel);
+    }
+};
+
+// Wrapper class for rollback simulation of player aircraft
+class RollbackWrapper {
+private:
+    RollbackSimulator simulator;
+    
+public:
+    RollbackWrapper(int historyLength, float tickDuration)
+        : simulator(historyLength, tickDuration) {}
+    
+    int addAircraft(float x, float y, float z, float heading) {
+        return simulator.addAircraft(Vec3(x, y, z), heading);
+    }
+    
+    // Ticks are passed as doubles (exact up to 2^53); false for a tick that is negative,
+    // fractional or beyond that
+    bool setInput(int index, double tick, float throttle, float aileron, float elevator, float rudder) {
+        if (!(tick >= 0 && tick <= 9007199254740992.0) || std::floor(tick) != tick) {
+            return false;
+        }
+        ControlInputs input;
+        input.throttle = throttle;
+        input.aileron = aileron;
+        input.elevator = elevator;
+        input.rudder = rudder;
+        return simulator.setInput(index, static_cast<int64_t>(tick), input);
+    }
+    
+    // Rollback and all ticks run inside this one call
+    void step(int ticks) {
+        simulator.step(ticks);
+    }
+    
+    int getCount() const {
+        return simulator.size();
+    }
+    
+    double getCurrentTick() const {
+        return static_cast<double>(simulator.getCurrentTick());
+    }
+    
+    double getOldestTick() const {
+        return static_cast<double>(simulator.getOldestTick());
+    }
+    
+    int getLastResimulatedTicks() const {
+        return simulator.getLastResimulatedTicks();
+    }
+    
+    double getRollbackCount() const {
+        return static_cast<double>(simulator.getRollbackCount());
+    }
+    
+    val getState(int index) {
+        if (index < 0 || index >= simulator.size()) {
+            return val::null();
+        }
+        return aircraftStateToJs(simulator.getAircraft(index));
+    }
+    
+    void setDeterministic(bool enabled) {
+        simulator.setDeterministic(enabled);
+    }
+    
+    std::string getChecksum() const {
+        return checksumToHex(simulator.getChecksum());
+    }
+};
+
+// Wrapper class for dead-reckoned network aircraft
+class RemoteAircraftWrapper {
+private:
+    RemoteEntitySet entities;
+    
+    bool hasAircraft(int index) const {
+        return index >= 0 && index < entities.size();
+    }
+    
+public:
+    RemoteAircraftWrapper() {}
+    
+    int addAircraft() {
+        return entities.addEntity();
+    }
+    
+    // Returns -1 if the type is not registered in the cache
+    int addAircraftType(const TrimCacheWrapper& trimCache, const std::string& name) {
+        std::shared_ptr<const AircraftProperties> props = trimCache.findAircraft(name);
+        if (!props) {
+            return -1;
+        }
+        return entities.addEntity(props);
+    }
+    
+    // State as returned by getState() on the sender, stamped with the sender's time
+    bool applyUpdate(int index, const AircraftState& state, float fuel, double time) {
+        return entities.applyUpdate(index, state, fuel, time);
+    }
+    
+    void update(float deltaTime) {
+        entities.update(deltaTime);
+    }
+    
+    void setTime(double time) {
+        entities.setTime(time);
+    }
+    
+    double getTime() const {
+        return entities.getTime();
+    }
+    
+    int getCount() const {
+        return entities.size();
+    }
+    
+    // Invalid indices read as stale, without error and with a null state
+    bool isStale(int index) const {
+        return !hasAircraft(index) || entities.isStale(index);
+    }
+    
+    float getPositionError(int index) const {
+        return hasAircraft(index) ? entities.getPositionError(index) : 0.0f;
+    }
+    
+    val getState(int index) const {
+        if (!hasAircraft(index)) {
+            return val::null();
+        }
+        return aircraftStateToJs(entities.getDisplayState(index), entities.getModel(index).getFuel());
+    }
+    
+    // x, y, z, heading, pitch, roll per aircraft; the view is invalidated by addAircraft
+    val getRenderData() const {
+        const std::vector<float>& data = entities.getRenderData();
+        return val(typed_memory_view(data.size(), data.data()));
+    }
+    
+    const RemoteEntitySet& getEntities() const {
+        return entities;
+    }
+};
+
+// Wrapper class for the multi-rate scheduler
+class SchedulerWrapper {
+private:
+    MultiRateScheduler scheduler;
+    
+public:
+    explicit SchedulerWrapper(float tickRate) : scheduler(tickRate) {}
+    
+    // The fleet must stay alive while this scheduler is used
+    bool scheduleFleet(FleetWrapper& fleet, int playerCount, float playerRate, float aiRate,
+                       float autopilotRate, float fuelRate) {
+        FleetRates rates;
+        rates.player = playerRate;
+        rates.ai = aiRate;
+        rates.autopilot = autopilotRate;
+        rates.fuel = fuelRate;
+        return ::scheduleFleet(scheduler, fleet.getFleet(), playerCount, rates);
+    }
+    
+    void step() {
+        scheduler.step();
+    }
+    
+    // Frame time in, ticks run out
+    int advance(double deltaTime) {
+        return scheduler.advance(deltaTime);
+    }
+    
+    double getTime() const {
+        return scheduler.getTime();
+    }
+    
+    double getTick() const {
+        return static_cast<double>(scheduler.getTick());
+    }
+    
+    double getDroppedTicks() const {
+        return static_cast<double>(scheduler.getDroppedTicks());
+    }
+    
+    // False for an unknown task id
+    bool setTaskEnabled(int task, bool enabled) {
+        return scheduler.setEnabled(task, enabled);
+    }
+    
+    // Per-task timing in milliseconds
+    val getStats() const {
+        val tasks = val::array();
+        for (int i = 0; i < scheduler.getTaskCount(); ++i) {
+            const ScheduledTaskStats& stats = scheduler.getStats(i);
+            val task = val::object();
+            task.set("name", stats.name);
+            task.set("rate", stats.rate);
+            task.set("period", stats.period);
+            task.set("calls", static_cast<double>(stats.calls));
+            task.set("meanMs", stats.getMeanSeconds() * 1000.0);
+            task.set("maxMs", stats.maxSeconds * 1000.0);
+            task.set("lastMs", stats.lastSeconds * 1000.0);
+            tasks.call<void>("push", task);
+        }
+        return tasks;
+    }
+    
+    double getLastTickMs() const {
+        return scheduler.getLastTickSeconds() * 1000.0;
+    }
+    
+    double getMaxTickMs() const {
+        return scheduler.getMaxTickSeconds() * 1000.0;
+    }
+    
+    void resetStats() {
+        scheduler.resetStats();
+    }
+};
+
+// Wrapper class for instanced-rendering matrices
+class InstanceBufferWrapper {
+private:
+    InstanceMatrixBuffer buffer;
+    
+public:
+    InstanceBufferWrapper() {}
+    
+    void setModel(int index, int model) {
+        buffer.setModel(index, model);
+    }
+    
+    void setKeepPrevious(bool enabled) {
+        buffer.setKeepPrevious(enabled);
+    }
+    
+    void resetPrevious() {
+        buffer.resetPrevious();
+    }
+    
+    void buildFromFleet(const FleetWrapper& fleet) {
+        buffer.build(fleet.getFleet());
+    }
+    
+    void buildFromRemote(const RemoteAircraftWrapper& remote) {
+        buffer.build(remote.getEntities());
+    }
+    
+    int getInstanceCount() const {
+        return buffer.getInstanceCount();
+    }
+    
+    int getModelCount() const {
+        return buffer.getModelCount();
+    }
+    
+    int getGroupOffset(int model) const {
+        return buffer.getGroupOffset(model);
+    }
+    
+    int getGroupCount(int model) const {
+        return buffer.getGroupCount(model);
+    }
+    
+    // Views are invalidated by the next build with more instances and by memory growth
+    val getMatrices() const {
+        const std::vector<float>& data = buffer.getMatrices();
+        return val(typed_memory_view(data.size(), data.data()));
+    }
+    
+    val getPreviousMatrices() const {
+        const std::vector<float>& data = buffer.getPreviousMatrices();
+        return val(typed_memory_view(data.size(), data.data()));
+    }
+    
+    val getSlotEntities() const {
+        const std::vector<int>& data = buffer.getSlotEntities();
+        return val(typed_memory_view(data.size(), data.data()));
+    }
+};
+
+// Wrapper class for frustum and distance culling
+class VisibilityWrapper {
+private:
+    VisibilityCuller culler;
+    
+public:
+    VisibilityWrapper() {}
+    
+    // 24 numbers: six planes as nx, ny, nz, constant (THREE.Frustum order)
+    void setFrustum(val planeData) {
+        ScratchPool::Lease data = ScratchPool::shared().copy(planeData);
+        if (data->getLength() >= 24) {
+            culler.setFrustum(data->data());
+        }
+    }
+    
+    void setCamera(float x, float y, float z) {
+        culler.setCamera(Vec3(x, y, z));
+    }
+    
+    void setLodRatios(val ratios) {
+        culler.setLodRatios(convertJSArrayToNumberVector<float>(ratios));
+    }
+    
+    void setMaxDistance(float distance) {
+        culler.setMaxDistance(distance);
+    }
+    
+    // x, y, z, radius per entity
+    void setSpheres(int visibilityClass, val spheres) {
+        if (visibilityClass < 0 || visibilityClass >= VISIBILITY_CLASS_COUNT) {
+            return;
+        }
+        ScratchPool::Lease data = ScratchPool::shared().copy(spheres);
+        culler.setSpheres(visibilityClass, data->data(), data->getLength() / 4, 4);
+    }
+    
+    void setAircraftFromFleet(const FleetWrapper& fleet) {
+        culler.setAircraft(fleet.getFleet());
+    }
+    
+    void setAircraftFromRemote(const RemoteAircraftWrapper& remote) {
+        culler.setAircraft(remote.getEntities());
+    }
+    
+    void cull() {
+        culler.cull();
+    }
+    
+    // 0 for an invalid visibility class
+    int getVisibleCount(int visibilityClass) const {
+        if (visibilityClass < 0 || visibilityClass >= VISIBILITY_CLASS_COUNT) {
+            return 0;
+        }
+        return static_cast<int>(culler.getVisible(visibilityClass).size());
+    }
+    
+    // Views are invalidated by the next set call and by memory growth; null for an
+    // invalid visibility class
+    val getVisible(int visibilityClass) const {
+        if (visibilityClass < 0 || visibilityClass >= VISIBILITY_CLASS_COUNT) {
+            return val::null();
+        }
+        const std::vector<int>& data = culler.getVisible(visibilityClass);
+        return val(typed_memory_view(data.size(), data.data()));
+    }
+    
+    val getLods(int visibilityClass) const {
+        if (visibilityClass < 0 || visibilityClass >= VISIBILITY_CLASS_COUNT) {
+            return val::null();
+        }
+        const std::vector<uint8_t>& data = culler.getLods(visibilityClass);
+        return val(typed_memory_view(data.size(), data.data()));
+    }
+};
+
+// Binding for FleetWrapper
+EMSCRIPTEN_BINDINGS(fleet_bindings) {
+    constant("AUTOPILOT_OFF", static_cast<unsigned int>(AUTOPILOT_OFF));
+    constant("AUTOPILOT_ALTITUDE", static_cast<unsigned int>(AUTOPILOT_ALTITUDE));
+    constant("AUTOPILOT_HEADING", static_cast<unsigned int>(AUTOPILOT_HEADING));
+    constant("AUTOPILOT_SPEED", static_cast<unsigned int>(AUTOPILOT_SPEED));
+    constant("AUTOPILOT_WAYPOINT", static_cast<unsigned int>(AUTOPILOT_WAYPOINT));
+    constant("PHYSICS_FULL", static_cast<unsigned int>(PHYSICS_FULL));
+    constant("PHYSICS_POINT_MASS", static_cast<unsigned int>(PHYSICS_POINT_MASS));
+    constant("VISIBILITY_AIRCRAFT", static_cast<int>(VISIBILITY_AIRCRAFT));
+    constant("VISIBILITY_EMITTERS", static_cast<int>(VISIBILITY_EMITTERS));
+    constant("VISIBILITY_PROJECTILES", static_cast<int>(VISIBILITY_PROJECTILES));
+    constant("VISIBILITY_CULLED", static_cast<int>(VisibilityCuller::kCulled));
+    
+    class_<TrimCacheWrapper>("TrimCache")
+        .constructor<>()
+        .function("addAircraftDat", &TrimCacheWrapper::addAircraftDat)
+        .function("compute", &TrimCacheWrapper::compute)
+        .function("lookup", &TrimCacheWrapper::lookup);
+    
+    class_<FleetWrapper>("Fleet")
+        .constructor<>()
+        .function("addAircraft", &FleetWrapper::addAircraft)
+        .function("addTrimmedAircraft", &FleetWrapper::addTrimmedAircraft)
+        .function("clear", &FleetWrapper::clear)
+        .function("getCount", &FleetWrapper::getCount)
+        .function("setAircraftType", &FleetWrapper::setAircraftType)
+        .function("setAircraftProperties", &FleetWrapper::setAircraftProperties)
+        .function("setControls", &FleetWrapper::setControls)
+        .function("setAutopilotMode", &FleetWrapper::setAutopilotMode)
+        .function("setTargetAltitude", &FleetWrapper::setTargetAltitude)
+        .function("setTargetHeading", &FleetWrapper::setTargetHeading)
+        .function("setTargetSpeed", &FleetWrapper::setTargetSpeed)
+        .function("setThrottleTrim", &FleetWrapper::setThrottleTrim)
+        .function("addWaypoint", &FleetWrapper::addWaypoint)
+        .function("clearWaypoints", &FleetWrapper::clearWaypoints)
+        .function("setRouteLooping", &FleetWrapper::setRouteLooping)
+        .function("getCurrentWaypoint", &FleetWrapper::getCurrentWaypoint)
+        .function("update", &FleetWrapper::update)
+        .function("getState", &FleetWrapper::getState)
+        .function("setPhysicsLod", &FleetWrapper::setPhysicsLod)
+        .function("getPhysicsLod", &FleetWrapper::getPhysicsLod)
+        .function("getPointMassCount", &FleetWrapper::getPointMassCount)
+        .function("selectPhysicsLod", &FleetWrapper::selectPhysicsLod)
+        .function("setPointMassInterval", &FleetWrapper::setPointMassInterval)
+        .function("setDeterministic", &FleetWrapper::setDeterministic)
+        .function("getChecksum", &FleetWrapper::getChecksum);
+    
+    class_<RollbackWrapper>("RollbackSimulation")
+        .constructor<int, float>()
+        .function("addAircraft", &RollbackWrapper::addAircraft)
+        .function("setInput", &RollbackWrapper::setInput)
+        .function("step", &RollbackWrapper::step)
+        .function("getCount", &RollbackWrapper::getCount)
+        .function("getCurrentTick", &RollbackWrapper::getCurrentTick)
+        .function("getOldestTick", &RollbackWrapper::getOldestTick)
+        .function("getLastResimulatedTicks", &RollbackWrapper::getLastResimulatedTicks)
+        .function("getRollbackCount", &RollbackWrapper::getRollbackCount)
+        .function("getState", &RollbackWrapper::getState)
+        .function("setDeterministic", &RollbackWrapper::setDeterministic)
+        .function("getChecksum", &RollbackWrapper::getChecksum);
+    
+    class_<RemoteAircraftWrapper>("RemoteAircraft")
+        .constructor<>()
+        .function("addAircraft", &RemoteAircraftWrapper::addAircraft)
+        .function("addAircraftType", &RemoteAircraftWrapper::addAircraftType)
+        .function("applyUpdate", &RemoteAircraftWrapper::applyUpdate)
+        .function("update", &RemoteAircraftWrapper::update)
+        .function("setTime", &RemoteAircraftWrapper::setTime)
+        .function("getTime", &RemoteAircraftWrapper::getTime)
+        .function("getCount", &RemoteAircraftWrapper::getCount)
+        .function("isStale", &RemoteAircraftWrapper::isStale)
+        .function("getPositionError", &RemoteAircraftWrapper::getPositionError)
+        .function("getState", &RemoteAircraftWrapper::getState)
+        .function("getRenderData", &RemoteAircraftWrapper::getRenderData);
+    
+    class_<SchedulerWrapper>("Scheduler")
+        .constructor<float>()
+        .function("scheduleFleet", &SchedulerWrapper::scheduleFleet)
+        .function("step", &SchedulerWrapper::step)
+        .function("advance", &SchedulerWrapper::advance)
+        .function("getTime", &SchedulerWrapper::getTime)
+        .function("getTick", &SchedulerWrapper::getTick)
+        .function("getDroppedTicks", &SchedulerWrapper::getDroppedTicks)
+        .function("setTaskEnabled", &SchedulerWrapper::setTaskEnabled)
+        .function("getStats", &SchedulerWrapper::getStats)
+        .function("getLastTickMs", &SchedulerWrapper::getLastTickMs)
+        .function("getMaxTickMs", &SchedulerWrapper::getMaxTickMs)
+        .function("resetStats", &SchedulerWrapper::resetStats);
+    
+    class_<InstanceBufferWrapper>("InstanceBuffer")
+        .constructor<>()
+        .function("setModel", &InstanceBufferWrapper::setModel)
+        .function("setKeepPrevious", &InstanceBufferWrapper::setKeepPrevious)
+        .function("resetPrevious", &InstanceBufferWrapper::resetPrevious)
+        .function("buildFromFleet", &InstanceBufferWrapper::buildFromFleet)
+        .function("buildFromRemote", &InstanceBufferWrapper::buildFromRemote)
+        .function("getInstanceCount", &InstanceBufferWrapper::getInstanceCount)
+        .function("getModelCount", &InstanceBufferWrapper::getModelCount)
+        .function("getGroupOffset", &InstanceBufferWrapper::getGroupOffset)
+        .function("getGroupCount", &InstanceBufferWrapper::getGroupCount)
+        .function("getMatrices", &InstanceBufferWrapper::getMatrices)
+        .function("getPreviousMatrices", &InstanceBufferWrapper::getPreviousMatrices)
+        .function("getSlotEntities", &InstanceBufferWrapper::getSlotEntities);
+    
+    class_<VisibilityWrapper>("Visibility")
+        .constructor<>()
+        .function("setFrustum", &VisibilityWrapper::setFrustum)
+        .function("setCamera", &VisibilityWrapper::setCamera)
+        .function("setLodRatios", &VisibilityWrapper::setLodRatios)
+        .function("setMaxDistance", &VisibilityWrapper::setMaxDistance)
+        .function("setSpheres", &VisibilityWrapper::setSpheres)
+        .function("setAircraftFromFleet", &VisibilityWrapper::setAircraftFromFleet)
+        .function("setAircraftFromRemote", &VisibilityWrapper::setAircraftFromRemote)
+        .function("cull", &VisibilityWrapper::cull)
+        .function("getVisibleCount", &VisibilityWrapper::getVisibleCount)
+        .function("getVisible", &VisibilityWrapper::getVisible)
+        .function("getLods", &VisibilityWrapper::getLods);
+}
+
+// Binding for FlightRecorderWrapper
+EMSCRIPTEN_BINDINGS(recorder_bindings) {
+    class_<FlightRecorderWrapper>("FlightRecorder")
+        .constructor<int, int>()
+        .function("recordFleet", &FlightRecorderWrapper::recordFleet)
+        .function("recordSimulation", &FlightRecorderWrapper::recordSimulation)
+        .function("clear", &FlightRecorderWrapper::clear)
+        .function("getTrackCount", &FlightRecorderWrapper::getTrackCount)
+        .function("getTickCount", &FlightRecorderWrapper::getTickCount)
+        .function("isFull", &FlightRecorderWrapper::isFull)
+        .function("getAllocatedBytes", &FlightRecorderWrapper::getAllocatedBytes)
+        .function("getEncodedBytes", &FlightRecorderWrapper::getEncodedBytes)
+        .function("serializeTrack", &FlightRecorderWrapper::serializeTrack);
+    
+    class_<ReplayWrapper>("Replay")
+        .constructor<>()
+        .function("loadTrack", &ReplayWrapper::loadTrack)
+        .function("addRecordedTrack", &ReplayWrapper::addRecordedTrack)
+        .function("clear", &ReplayWrapper::clear)
+        .function("seek", &ReplayWrapper::seek)
+        .function("advance", &ReplayWrapper::advance)
+        .function("getTime", &ReplayWrapper::getTime)
+        .function("getStartTime", &ReplayWrapper::getStartTime)
+        .function("getEndTime", &ReplayWrapper::getEndTime)
+        .function("getGhostCount", &ReplayWrapper::getGhostCount)
+        .function("getAircraftName", &ReplayWrapper::getAircraftName)
+        .function("getState", &ReplayWrapper::getState);
+}
@@ -1,6 +1,8 @@
 #include <emscripten/bind.h>
+#include <algorithm>
+#include <cmath>
 #include <string>
-#include <vector>
+#include "heap_buffer.h"
 
 using namespace emscripten;
 
@@ -9,6 +11,7 @@ class TestModule {
 private:
     std::string name;
     int counter;
+    HeapBuffer result;
     
 public:
     TestModule(const std::string& moduleName) 
@@ -27,18 +30,26 @@ public:
         return counter;
     }
     
-    // Test vector operations
-    std::vector<float> addVectors(const std::vector<float>& a, 
-                                  const std::vector<float>& b) {
-        std::vector<float> result;
-        size_t size = std::min(a.size(), b.size());
-        
-        result.reserve(size);
-        for (size_t i = 0; i < size; ++i) {
-            result.push_back(a[i] + b[i]);
+    // Element-wise a + b over JS arrays or typed arrays. Inputs go through pooled scratch
+    // buffers; the result is a view of this module's buffer, valid until the next call.
+    val addVectors(val a, val b) {
+        ScratchPool& pool = ScratchPool::shared();
+        ScratchPool::Lease left = pool.copy(a);
+        ScratchPool::Lease right = pool.copy(b);
+        addVectorsInto(*left, *right, result);
+        return result.view();
+    }
+    
+    // Zero-copy form over caller-owned heap buffers; out is resized to the shorter input
+    void addVectorsInto(const HeapBuffer& a, const HeapBuffer& b, HeapBuffer& out) {
+        const int size = std::min(a.getLength(), b.getLength());
+        out.resize(size);
+        const float* left = a.data();
+        const float* right = b.data();
+        float* sum = out.data();
+        for (int i = 0; i < size; ++i) {
+            sum[i] = left[i] + right[i];
         }
-        
-        return result;
     }
     
     // Test physics calculation
@@ -53,13 +64,12 @@ public:
 
 // Bindings for TestModule
 EMSCRIPTEN_BINDINGS(test_module) {
-    register_vector<float>("VectorFloat");
-    
     class_<TestModule>("TestModule")
         .constructor<const std::string&>()
         .function("getName", &TestModule::getName)
         .function("incrementCounter", &TestModule::incrementCounter)
         .function("getCounter", &TestModule::getCounter)
         .function("addVectors", &TestModule::addVectors)
+        .function("addVectorsInto", &TestModule::addVectorsInto)
         .function("calculateDistance", &TestModule::calculateDistance);
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Identifies the pool and queue of the current worker thread
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local int currentQueue = -1;
+
+} // namespace
+
+int WorkStealingPool::hardwareThreads() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return 1;
+#else
+    return std::max(1u, std::thread::hardware_concurrency());
+#endif
+}
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : pendingTasks(0), queuedTasks(0), submitCounter(0), stopping(false) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    threadCount = -1; // No threads in this build
+#endif
+    if (threadCount == 0) {
+        threadCount = hardwareThreads();
+    }
+    threadCount = std::max(0, threadCount);
+
+    for (int i = 0; i <= threadCount; ++i) {
+        queues.emplace_back(new WorkerQueue());
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    // Workers push onto their own deque; other threads spread over all deques
+    int queueIndex;
+    if (currentPool == this && currentQueue >= 0) {
+        queueIndex = currentQueue;
+    } else {
+        queueIndex = static_cast<int>(submitCounter++ % queues.size());
+    }
+
+    pendingTasks++;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedTasks++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+        queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    workAvailable.notify_one();
+}
+
+bool WorkStealingPool::popLocal(int queueIndex, std::function<void()>& task) {
+    WorkerQueue& queue = *queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queuedTasks--;
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, std::function<void()>& task) {
+    const int count = static_cast<int>(queues.size());
+    for (int offset = 1; offset < count; ++offset) {
+        WorkerQueue& victim = *queues[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queuedTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::finishTask() {
+    if (--pendingTasks == 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        allDone.notify_all();
+    }
+}
+
+bool WorkStealingPool::runOne(int queueIndex) {
+    std::function<void()> task;
+    if (!popLocal(queueIndex, task) && !steal(queueIndex, task)) {
+        return false;
+    }
+    task();
+    finishTask();
+    return true;
+}
+
+void WorkStealingPool::workerLoop(int workerIndex) {
+    currentPool = this;
+    currentQueue = workerIndex;
+
+    while (true) {
+        if (runOne(workerIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        workAvailable.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        if (stopping && queuedTasks == 0) {
+            break;
+        }
+    }
+
+    currentPool = nullptr;
+    currentQueue = -1;
+}
+
+void WorkStealingPool::wait() {
+    // Non-worker callers help from the shared external queue
+    const int queueIndex = (currentPool == this && currentQueue >= 0)
+        ? currentQueue : static_cast<int>(queues.size()) - 1;
+
+    while (pendingTasks > 0) {
+        if (runOne(queueIndex)) {
+            continue;
+        }
+        // Remaining tasks are running elsewhere (or about to be queued by them)
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        allDone.wait_for(lock, std::chrono::milliseconds(1),
+                         [this] { return pendingTasks == 0 || queuedTasks > 0; });
+    }
+}
+
+void WorkStealingPool::parallelFor(size_t count, const std::function<void(size_t)>& body,
+                                   size_t grainSize) {
+    grainSize = std::max<size_t>(1, grainSize);
+    for (size_t begin = 0; begin < count; begin += grainSize) {
+        size_t end = std::min(count, begin + grainSize);
+        submit([&body, begin, end]() {
+            for (size_t i = begin; i < end; ++i) {
+                body(i);
+            }
+        });
+    }
+    wait();
+}
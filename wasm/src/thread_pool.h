@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool.
+// Each worker owns a deque: it pops its own newest task and steals the oldest from others.
+// With zero worker threads (e.g. WASM without pthreads) tasks run on the thread calling wait().
+class WorkStealingPool {
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // One queue per worker plus a shared queue for external submissions
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> pendingTasks;   // Submitted and not yet finished
+    std::atomic<size_t> queuedTasks;    // Sitting in a deque
+    std::atomic<size_t> submitCounter;
+    std::atomic<bool> stopping;
+
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+
+    bool popLocal(int queueIndex, std::function<void()>& task);
+    bool steal(int thief, std::function<void()>& task);
+    bool runOne(int queueIndex);
+    void workerLoop(int workerIndex);
+    void finishTask();
+
+public:
+    // threadCount 0 uses all hardware threads; negative runs everything on the caller
+    explicit WorkStealingPool(int threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished; the caller helps execute tasks
+    void wait();
+
+    // Run body(i) for i in [0, count) in chunks of grainSize and wait for completion
+    void parallelFor(size_t count, const std::function<void(size_t)>& body, size_t grainSize = 1);
+
+    int getThreadCount() const { return static_cast<int>(threads.size()); }
+
+    // Hardware threads available to this build (1 when threads are unsupported)
+    static int hardwareThreads();
+};
@@ -0,0 +1,360 @@
+#include "trim.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "deterministic_math.h"
+#include "memory_arena.h"
+#include "memory_stats.h"
+#include "thread_pool.h"
+
+namespace {
+
+const int kTrimVariables = 3; // throttle, elevator, alpha
+
+// FNV-1a over the values that affect the force model
+uint64_t hashProperties(const AircraftProperties& props) {
+    const float values[] = {
+        props.emptyMass, props.maxFuel, props.wingArea, props.wingSpan,
+        props.maxThrust, props.Cl0, props.ClAlpha, props.Cd0, props.K, props.ClMax,
+        props.elevatorEffect, props.criticalAOAPositive, props.criticalAOANegative, props.maxSpeed
+    };
+    uint64_t hash = 1469598103934665603ull;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values);
+    for (size_t i = 0; i < sizeof(values); ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void clampTrimVariables(const AircraftProperties& props, float x[kTrimVariables]) {
+    x[0] = std::max(0.0f, std::min(1.0f, x[0]));
+    x[1] = std::max(-1.0f, std::min(1.0f, x[1]));
+    x[2] = std::max(props.criticalAOANegative, std::min(props.criticalAOAPositive, x[2]));
+}
+
+// Net force (in weights) and pitch moment (in its elevator authority scale) for level flight along +x
+void trimResiduals(FlightDynamics& dynamics, const AircraftState& base,
+                   const float x[kTrimVariables], float r[kTrimVariables]) {
+    const AircraftProperties& props = dynamics.getProperties();
+    AircraftState state = base;
+    state.throttle = x[0];
+    state.thrust = x[0] * props.maxThrust;
+    state.elevator = x[1];
+    state.pitch = x[2];
+    dynamics.setState(state);
+
+    Vec3 force = dynamics.calculateThrustForce() + dynamics.calculateAerodynamicForces();
+    float weight = state.mass * 9.81f;
+    Vec3 moments = dynamics.calculateMoments();
+
+    // Matches the moment scaling in calculateMoments
+    float chord = props.wingArea / props.wingSpan;
+    float momentScale = dynamics.getDynamicPressure() * props.wingArea * chord * 0.001f;
+
+    r[0] = force.x / weight;
+    r[1] = (force.y - weight) / weight;
+    r[2] = momentScale > 0 ? moments.y / momentScale : 0.0f;
+}
+
+float squaredNorm(const float r[kTrimVariables]) {
+    return r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+}
+
+// Solve a 3x3 system with partial pivoting; false if singular
+bool solve3x3(float A[3][3], float b[3], float x[3]) {
+    for (int col = 0; col < 3; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < 3; ++row) {
+            if (std::fabs(A[row][col]) > std::fabs(A[pivot][col])) pivot = row;
+        }
+        if (std::fabs(A[pivot][col]) < 1e-12f) {
+            return false;
+        }
+        if (pivot != col) {
+            std::swap(A[pivot], A[col]);
+            std::swap(b[pivot], b[col]);
+        }
+        for (int row = col + 1; row < 3; ++row) {
+            float factor = A[row][col] / A[col][col];
+            for (int k = col; k < 3; ++k) A[row][k] -= factor * A[col][k];
+            b[row] -= factor * b[col];
+        }
+    }
+    for (int row = 2; row >= 0; --row) {
+        float sum = b[row];
+        for (int k = row + 1; k < 3; ++k) sum -= A[row][k] * x[k];
+        x[row] = sum / A[row][row];
+    }
+    return true;
+}
+
+// Finite and strictly increasing; an empty axis is allowed and yields an empty table
+bool isAscendingAxis(const std::vector<float>& axis) {
+    for (size_t i = 0; i < axis.size(); ++i) {
+        if (!std::isfinite(axis[i]) || (i > 0 && !(axis[i] > axis[i - 1]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TrimResult solveTrim(const AircraftProperties& props, float altitude, float speed,
+                     const TrimSettings& settings) {
+    // Deterministic math keeps trim tables identical on every client
+    FlightDynamics dynamics;
+    dynamics.setDeterministic(true);
+    dynamics.setProperties(props);
+    dynamics.setFuel(props.maxFuel * settings.fuelFraction);
+
+    AircraftState base = dynamics.getState();
+    base.position = Vec3(0, altitude, 0);
+    base.altitude = altitude;
+    base.velocity = Vec3(speed, 0, 0);
+    base.airspeed = speed;
+    base.heading = 0;
+    base.roll = 0;
+    base.headingRate = base.pitchRate = base.rollRate = 0;
+    base.aileron = base.rudder = 0;
+    dynamics.setState(base);
+
+    // Initial guess: linear lift for 1 g, thrust to cover parasitic drag
+    float qS = std::max(1.0f, dynamics.getDynamicPressure() * props.wingArea);
+    float weight = base.mass * 9.81f;
+    float x[kTrimVariables] = {
+        props.maxThrust > 0 ? props.Cd0 * qS / props.maxThrust : 0.0f,
+        0.0f,
+        props.ClAlpha > 0 ? (weight / qS - props.Cl0) / props.ClAlpha : 0.0f
+    };
+    clampTrimVariables(props, x);
+
+    float r[kTrimVariables];
+    trimResiduals(dynamics, base, x, r);
+    float cost = squaredNorm(r);
+    float lambda = 1e-3f;
+    const float step = 1e-4f;
+
+    for (int iteration = 0; iteration < settings.maxIterations; ++iteration) {
+        if (std::sqrt(cost) < settings.tolerance) {
+            break;
+        }
+
+        // Forward-difference Jacobian
+        float J[kTrimVariables][kTrimVariables];
+        for (int j = 0; j < kTrimVariables; ++j) {
+            float xp[kTrimVariables] = {x[0], x[1], x[2]};
+            xp[j] += step;
+            float rp[kTrimVariables];
+            trimResiduals(dynamics, base, xp, rp);
+            for (int i = 0; i < kTrimVariables; ++i) {
+                J[i][j] = (rp[i] - r[i]) / step;
+            }
+        }
+
+        // Normal equations: J^T J and J^T r
+        float JtJ[kTrimVariables][kTrimVariables];
+        float Jtr[kTrimVariables];
+        for (int a = 0; a < kTrimVariables; ++a) {
+            Jtr[a] = 0;
+            for (int i = 0; i < kTrimVariables; ++i) Jtr[a] += J[i][a] * r[i];
+            for (int b = 0; b < kTrimVariables; ++b) {
+                JtJ[a][b] = 0;
+                for (int i = 0; i < kTrimVariables; ++i) JtJ[a][b] += J[i][a] * J[i][b];
+            }
+        }
+
+        // Marquardt-damped steps until the cost drops
+        bool improved = false;
+        for (int attempt = 0; attempt < 10 && !improved; ++attempt) {
+            float A[3][3];
+            float b[3];
+            for (int a = 0; a < kTrimVariables; ++a) {
+                for (int c = 0; c < kTrimVariables; ++c) A[a][c] = JtJ[a][c];
+                A[a][a] += lambda * (JtJ[a][a] + 1e-9f);
+                b[a] = -Jtr[a];
+            }
+
+            float delta[kTrimVariables];
+            if (!solve3x3(A, b, delta)) {
+                lambda *= 10.0f;
+                continue;
+            }
+
+            float candidate[kTrimVariables] = {x[0] + delta[0], x[1] + delta[1], x[2] + delta[2]};
+            clampTrimVariables(props, candidate);
+            float rc[kTrimVariables];
+            trimResiduals(dynamics, base, candidate, rc);
+            float candidateCost = squaredNorm(rc);
+
+            if (candidateCost < cost) {
+                std::memcpy(x, candidate, sizeof(x));
+                std::memcpy(r, rc, sizeof(r));
+                cost = candidateCost;
+                lambda = std::max(1e-7f, lambda / 3.0f);
+                improved = true;
+            } else {
+                lambda *= 4.0f;
+            }
+        }
+
+        // Stuck against a limit (e.g. beyond max thrust or critical AoA)
+        if (!improved) {
+            break;
+        }
+    }
+
+    TrimResult result;
+    result.throttle = x[0];
+    result.elevator = x[1];
+    result.alpha = x[2];
+    result.residual = std::sqrt(cost);
+    result.converged = result.residual < settings.tolerance;
+    return result;
+}
+
+void applyTrim(FlightDynamics& dynamics, const Vec3& position, float heading, float speed,
+               const TrimResult& trim) {
+    dynamics.initialize(position, heading);
+
+    // Same math path as the aircraft's own updates
+    const bool deterministic = dynamics.isDeterministic();
+    const float cosHeading = deterministic ? detmath::cos(heading) : std::cos(heading);
+    const float sinHeading = deterministic ? detmath::sin(heading) : std::sin(heading);
+
+    AircraftState state = dynamics.getState();
+    state.velocity = Vec3(speed * cosHeading, 0, speed * sinHeading);
+    state.airspeed = speed;
+    state.pitch = trim.alpha;
+    state.roll = 0;
+    state.headingRate = state.pitchRate = state.rollRate = 0;
+    state.throttle = trim.throttle;
+    state.thrust = trim.throttle * dynamics.getProperties().maxThrust;
+    state.elevator = trim.elevator;
+    state.aileron = state.rudder = 0;
+    dynamics.setState(state);
+}
+
+TrimResult TrimTable::lookup(float altitude, float speed) const {
+    if (points.empty()) {
+        return TrimResult();
+    }
+
+    // Locate the cell and interpolation weights along one axis
+    auto locate = [](const std::vector<float>& axis, float value, int& index, float& t) {
+        if (axis.size() < 2 || value <= axis.front()) {
+            index = 0;
+            t = 0.0f;
+            return;
+        }
+        if (value >= axis.back()) {
+            index = static_cast<int>(axis.size()) - 2;
+            t = 1.0f;
+            return;
+        }
+        index = static_cast<int>(std::upper_bound(axis.begin(), axis.end(), value) - axis.begin()) - 1;
+        t = (value - axis[index]) / (axis[index + 1] - axis[index]);
+    };
+
+    int ai, si;
+    float at, st;
+    locate(altitudes, altitude, ai, at);
+    locate(speeds, speed, si, st);
+    int ai1 = std::min(ai + 1, static_cast<int>(altitudes.size()) - 1);
+    int si1 = std::min(si + 1, static_cast<int>(speeds.size()) - 1);
+
+    const TrimResult& p00 = this->at(ai, si);
+    const TrimResult& p01 = this->at(ai, si1);
+    const TrimResult& p10 = this->at(ai1, si);
+    const TrimResult& p11 = this->at(ai1, si1);
+
+    auto blend = [&](float TrimResult::*field) {
+        float low = p00.*field + (p01.*field - p00.*field) * st;
+        float high = p10.*field + (p11.*field - p10.*field) * st;
+        return low + (high - low) * at;
+    };
+
+    TrimResult result;
+    result.throttle = blend(&TrimResult::throttle);
+    result.elevator = blend(&TrimResult::elevator);
+    result.alpha = blend(&TrimResult::alpha);
+    result.residual = std::max(std::max(p00.residual, p01.residual), std::max(p10.residual, p11.residual));
+    result.converged = p00.converged && p01.converged && p10.converged && p11.converged;
+    return result;
+}
+
+bool TrimTable::getSpeedEnvelope(int altitudeIndex, float& minSpeed, float& maxSpeed) const {
+    bool found = false;
+    for (size_t i = 0; i < speeds.size(); ++i) {
+        if (!at(altitudeIndex, static_cast<int>(i)).converged) {
+            continue;
+        }
+        if (!found) {
+            minSpeed = speeds[i];
+            found = true;
+        }
+        maxSpeed = speeds[i];
+    }
+    return found;
+}
+
+bool TrimCache::compute(const std::vector<AircraftProperties>& aircraft,
+                        const std::vector<float>& altitudes, const std::vector<float>& speeds,
+                        int threadCount, const TrimSettings& settings) {
+    MemoryTagScope tag(MEM_ASSETS);
+    // TrimTable::lookup searches and divides by the axis spacing
+    if (!isAscendingAxis(altitudes) || !isAscendingAxis(speeds)) {
+        return false;
+    }
+
+    // Collect the tables that need solving
+    MemoryArena& arena = memory::loadArena();
+    ArenaScope scratch(arena);
+    ArenaVector<TrimTable*> pending{ArenaAllocator<TrimTable*>(arena)};
+    ArenaVector<const AircraftProperties*> pendingProps{ArenaAllocator<const AircraftProperties*>(arena)};
+    for (const AircraftProperties& props : aircraft) {
+        uint64_t key = hashProperties(props);
+        TrimTable& table = tables[props.name];
+        if (table.propertiesKey == key && table.altitudes == altitudes && table.speeds == speeds &&
+            !table.points.empty()) {
+            continue;
+        }
+        table.aircraftName = props.name;
+        table.propertiesKey = key;
+        table.altitudes = altitudes;
+        table.speeds = speeds;
+        table.points.assign(altitudes.size() * speeds.size(), TrimResult());
+
+        // A repeated name replaces the earlier entry
+        auto existing = std::find(pending.begin(), pending.end(), &table);
+        if (existing != pending.end()) {
+            pendingProps[existing - pending.begin()] = &props;
+            continue;
+        }
+        pending.push_back(&table);
+        pendingProps.push_back(&props);
+    }
+
+    const size_t pointsPerTable = altitudes.size() * speeds.size();
+    const size_t totalPoints = pending.size() * pointsPerTable;
+    if (totalPoints == 0) {
+        return true;
+    }
+
+    // Grid points are independent; balance them over the pool
+    WorkStealingPool pool(threadCount);
+    pool.parallelFor(totalPoints, [&](size_t item) {
+        size_t tableIndex = item / pointsPerTable;
+        size_t point = item % pointsPerTable;
+        size_t altitudeIndex = point / speeds.size();
+        size_t speedIndex = point % speeds.size();
+        pending[tableIndex]->points[point] = solveTrim(
+            *pendingProps[tableIndex], altitudes[altitudeIndex], speeds[speedIndex], settings);
+    }, speeds.size());
+    return true;
+}
+
+const TrimTable* TrimCache::find(const std::string& name) const {
+    auto it = tables.find(name);
+    return it != tables.end() ? &it->second : nullptr;
+}
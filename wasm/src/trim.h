@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "simulation.h"
+
+// Steady, wings-level, unaccelerated flight condition
+struct TrimResult {
+    float throttle;     // 0.0 to 1.0
+    float elevator;     // -1.0 to 1.0
+    float alpha;        // Angle of attack = pitch in level flight (rad)
+    float residual;     // Remaining normalized force/moment error
+    bool converged;
+
+    TrimResult() : throttle(0), elevator(0), alpha(0), residual(0), converged(false) {}
+};
+
+struct TrimSettings {
+    int maxIterations;
+    float tolerance;        // On the residual norm
+    float fuelFraction;     // Fuel load used for the weight
+
+    TrimSettings() : maxIterations(50), tolerance(1e-4f), fuelFraction(0.5f) {}
+};
+
+// Levenberg-Marquardt solve of throttle, elevator and AoA against the FlightDynamics force/moment model
+TrimResult solveTrim(const AircraftProperties& props, float altitude, float speed,
+                     const TrimSettings& settings = TrimSettings());
+
+// Place an aircraft in trimmed level flight
+void applyTrim(FlightDynamics& dynamics, const Vec3& position, float heading, float speed,
+               const TrimResult& trim);
+
+// Trim solutions of one aircraft type over an altitude x speed grid
+class TrimTable {
+private:
+    std::string aircraftName;
+    uint64_t propertiesKey;
+    std::vector<float> altitudes;   // Ascending (m)
+    std::vector<float> speeds;      // Ascending (m/s)
+    std::vector<TrimResult> points; // Row-major [altitude][speed]
+
+    friend class TrimCache;
+
+public:
+    TrimTable() : propertiesKey(0) {}
+
+    const std::string& getName() const { return aircraftName; }
+    const std::vector<float>& getAltitudes() const { return altitudes; }
+    const std::vector<float>& getSpeeds() const { return speeds; }
+    const TrimResult& at(int altitudeIndex, int speedIndex) const {
+        return points[altitudeIndex * speeds.size() + speedIndex];
+    }
+
+    // Bilinear interpolation between grid points (clamped to the grid)
+    TrimResult lookup(float altitude, float speed) const;
+
+    // Lowest and highest speeds with a converged trim at the given altitude row
+    bool getSpeedEnvelope(int altitudeIndex, float& minSpeed, float& maxSpeed) const;
+};
+
+// Trim tables for every aircraft type, keyed by aircraft name
+class TrimCache {
+private:
+    std::unordered_map<std::string, TrimTable> tables;
+
+public:
+    // Solve all grids in parallel. Types whose properties and grid are unchanged are skipped.
+    // threadCount 0 uses all hardware threads. Returns false, leaving the cache unchanged,
+    // unless both axes are finite and strictly ascending.
+    bool compute(const std::vector<AircraftProperties>& aircraft,
+                 const std::vector<float>& altitudes, const std::vector<float>& speeds,
+                 int threadCount = 0, const TrimSettings& settings = TrimSettings());
+
+    const TrimTable* find(const std::string& name) const;
+    int size() const { return static_cast<int>(tables.size()); }
+    void clear() { tables.clear(); }
+};
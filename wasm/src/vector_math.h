@@ -0,0 +1,690 @@
+#pragma once
+
+// Vector math shared by the simulation core and the bindings.
+// Vec3 is plain 12-byte storage for state (positions, velocities); Vec4, Quat, Mat3 and Mat4
+// are 16-byte aligned. Batch functions in vmath work on packed float arrays four elements at
+// a time with wasm_simd128 (-msimd128), SSE natively, or a scalar fallback (VMATH_SCALAR or
+// other targets). Every path performs the same IEEE operations in the same order without
+// fused multiply-adds, so results are bit-identical across them.
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#if !defined(VMATH_SCALAR) && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define VMATH_WASM_SIMD 1
+#elif !defined(VMATH_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define VMATH_SSE 1
+#endif
+
+namespace vmath {
+
+// Four float lanes
+#if defined(VMATH_WASM_SIMD)
+typedef v128_t Lanes;
+inline Lanes load(const float* p) { return wasm_v128_load(p); }
+inline void store(float* p, Lanes v) { wasm_v128_store(p, v); }
+inline Lanes splat(float s) { return wasm_f32x4_splat(s); }
+inline Lanes make(float x, float y, float z, float w) { return wasm_f32x4_make(x, y, z, w); }
+inline Lanes add(Lanes a, Lanes b) { return wasm_f32x4_add(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return wasm_f32x4_sub(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return wasm_f32x4_mul(a, b); }
+inline Lanes div(Lanes a, Lanes b) { return wasm_f32x4_div(a, b); }
+inline Lanes sqrt(Lanes a) { return wasm_f32x4_sqrt(a); }
+inline Lanes neg(Lanes a) { return wasm_f32x4_neg(a); }
+inline Lanes greaterThan(Lanes a, Lanes b) { return wasm_f32x4_gt(a, b); }
+inline Lanes lessThan(Lanes a, Lanes b) { return wasm_f32x4_lt(a, b); }
+// Lanes of a where mask is set, else b
+inline Lanes select(Lanes mask, Lanes a, Lanes b) { return wasm_v128_bitselect(a, b, mask); }
+// Four packed xyz triples (12 floats) to one lane per component, and back
+inline void loadXYZ(const float* p, Lanes& x, Lanes& y, Lanes& z) {
+    Lanes a = load(p), b = load(p + 4), c = load(p + 8);   // x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+    x = wasm_i32x4_shuffle(wasm_i32x4_shuffle(a, b, 0, 3, 6, 6), c, 0, 1, 2, 5);
+    y = wasm_i32x4_shuffle(wasm_i32x4_shuffle(a, b, 1, 4, 7, 7), c, 0, 1, 2, 6);
+    z = wasm_i32x4_shuffle(wasm_i32x4_shuffle(a, b, 2, 5, 5, 5), c, 0, 1, 4, 7);
+}
+inline void storeXYZ(float* p, Lanes x, Lanes y, Lanes z) {
+    store(p, wasm_i32x4_shuffle(wasm_i32x4_shuffle(x, y, 0, 4, 1, 1), z, 0, 1, 4, 2));
+    store(p + 4, wasm_i32x4_shuffle(wasm_i32x4_shuffle(y, z, 1, 5, 1, 1), wasm_i32x4_shuffle(x, y, 2, 6, 2, 2), 0, 1, 4, 5));
+    store(p + 8, wasm_i32x4_shuffle(wasm_i32x4_shuffle(z, x, 2, 7, 2, 2), wasm_i32x4_shuffle(y, z, 3, 7, 3, 3), 0, 1, 4, 5));
+}
+// 4x4 transpose: four packed xyzw to one lane per component, or back
+inline void transpose(Lanes& r0, Lanes& r1, Lanes& r2, Lanes& r3) {
+    Lanes t0 = wasm_i32x4_shuffle(r0, r1, 0, 4, 1, 5), t1 = wasm_i32x4_shuffle(r2, r3, 0, 4, 1, 5);
+    Lanes t2 = wasm_i32x4_shuffle(r0, r1, 2, 6, 3, 7), t3 = wasm_i32x4_shuffle(r2, r3, 2, 6, 3, 7);
+    r0 = wasm_i32x4_shuffle(t0, t1, 0, 1, 4, 5);
+    r1 = wasm_i32x4_shuffle(t0, t1, 2, 3, 6, 7);
+    r2 = wasm_i32x4_shuffle(t2, t3, 0, 1, 4, 5);
+    r3 = wasm_i32x4_shuffle(t2, t3, 2, 3, 6, 7);
+}
+#elif defined(VMATH_SSE)
+typedef __m128 Lanes;
+inline Lanes load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, Lanes v) { _mm_storeu_ps(p, v); }
+inline Lanes splat(float s) { return _mm_set1_ps(s); }
+inline Lanes make(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+inline Lanes div(Lanes a, Lanes b) { return _mm_div_ps(a, b); }
+inline Lanes sqrt(Lanes a) { return _mm_sqrt_ps(a); }
+inline Lanes neg(Lanes a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+inline Lanes greaterThan(Lanes a, Lanes b) { return _mm_cmpgt_ps(a, b); }
+inline Lanes lessThan(Lanes a, Lanes b) { return _mm_cmplt_ps(a, b); }
+inline Lanes select(Lanes mask, Lanes a, Lanes b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+inline void loadXYZ(const float* p, Lanes& x, Lanes& y, Lanes& z) {
+    Lanes a = load(p), b = load(p + 4), c = load(p + 8);
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+                       _MM_SHUFFLE(2, 0, 2, 0));
+}
+inline void storeXYZ(float* p, Lanes x, Lanes y, Lanes z) {
+    store(p, _mm_shuffle_ps(_mm_unpacklo_ps(x, y), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0)));
+    store(p + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+                                _MM_SHUFFLE(2, 0, 2, 0)));
+    store(p + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+                                _MM_SHUFFLE(2, 0, 2, 0)));
+}
+inline void transpose(Lanes& r0, Lanes& r1, Lanes& r2, Lanes& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+#else
+// Comparison results are all-ones or all-zero bit patterns in v, as in the SIMD backends
+struct Lanes {
+    float v[4];
+};
+inline Lanes make(float x, float y, float z, float w) {
+    Lanes r = {{x, y, z, w}};
+    return r;
+}
+inline Lanes load(const float* p) { return make(p[0], p[1], p[2], p[3]); }
+inline void store(float* p, Lanes a) { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+inline Lanes splat(float s) { return make(s, s, s, s); }
+inline Lanes add(Lanes a, Lanes b) { return make(a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]); }
+inline Lanes sub(Lanes a, Lanes b) { return make(a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]); }
+inline Lanes mul(Lanes a, Lanes b) { return make(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]); }
+inline Lanes div(Lanes a, Lanes b) { return make(a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]); }
+inline Lanes sqrt(Lanes a) {
+    return make(std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]));
+}
+inline Lanes neg(Lanes a) { return make(-a.v[0], -a.v[1], -a.v[2], -a.v[3]); }
+inline Lanes greaterThan(Lanes a, Lanes b) {
+    Lanes r;
+    for (int i = 0; i < 4; ++i) {
+        const unsigned int bits = a.v[i] > b.v[i] ? ~0u : 0u;
+        std::memcpy(&r.v[i], &bits, sizeof(bits));
+    }
+    return r;
+}
+inline Lanes lessThan(Lanes a, Lanes b) { return greaterThan(b, a); }
+inline Lanes select(Lanes mask, Lanes a, Lanes b) {
+    Lanes r;
+    for (int i = 0; i < 4; ++i) {
+        unsigned int bits;
+        std::memcpy(&bits, &mask.v[i], sizeof(bits));
+        r.v[i] = bits ? a.v[i] : b.v[i];
+    }
+    return r;
+}
+inline void loadXYZ(const float* p, Lanes& x, Lanes& y, Lanes& z) {
+    x = make(p[0], p[3], p[6], p[9]);
+    y = make(p[1], p[4], p[7], p[10]);
+    z = make(p[2], p[5], p[8], p[11]);
+}
+inline void storeXYZ(float* p, Lanes x, Lanes y, Lanes z) {
+    for (int i = 0; i < 4; ++i) {
+        p[i * 3] = x.v[i];
+        p[i * 3 + 1] = y.v[i];
+        p[i * 3 + 2] = z.v[i];
+    }
+}
+inline void transpose(Lanes& r0, Lanes& r1, Lanes& r2, Lanes& r3) {
+    Lanes t0 = make(r0.v[0], r1.v[0], r2.v[0], r3.v[0]), t1 = make(r0.v[1], r1.v[1], r2.v[1], r3.v[1]);
+    Lanes t2 = make(r0.v[2], r1.v[2], r2.v[2], r3.v[2]), t3 = make(r0.v[3], r1.v[3], r2.v[3], r3.v[3]);
+    r0 = t0;
+    r1 = t1;
+    r2 = t2;
+    r3 = t3;
+}
+#endif
+
+// Lane implementation of this build, reported by getSystemInfo
+#if defined(VMATH_WASM_SIMD)
+constexpr const char* kBackend = "wasm_simd128";
+#elif defined(VMATH_SSE)
+constexpr const char* kBackend = "sse2";
+#else
+constexpr const char* kBackend = "scalar";
+#endif
+
+// Multiply-add as two rounded operations, never fused
+inline Lanes mulAdd(Lanes a, Lanes b, Lanes c) { return add(mul(a, b), c); }
+
+} // namespace vmath
+
+// 3D vector; packed so it can live in plain state structs
+struct Vec3 {
+    float x, y, z;
+
+    Vec3() : x(0), y(0), z(0) {}
+    Vec3(float x_, float y_, float z_) : x(x_), y(y_), z(z_) {}
+
+    Vec3 operator+(const Vec3& other) const { return Vec3(x + other.x, y + other.y, z + other.z); }
+    Vec3 operator-(const Vec3& other) const { return Vec3(x - other.x, y - other.y, z - other.z); }
+    Vec3 operator-() const { return Vec3(-x, -y, -z); }
+    Vec3 operator*(float scalar) const { return Vec3(x * scalar, y * scalar, z * scalar); }
+    Vec3& operator+=(const Vec3& other) { x += other.x; y += other.y; z += other.z; return *this; }
+    Vec3& operator-=(const Vec3& other) { x -= other.x; y -= other.y; z -= other.z; return *this; }
+
+    float dot(const Vec3& other) const { return x * other.x + y * other.y + z * other.z; }
+    Vec3 cross(const Vec3& other) const {
+        return Vec3(y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x);
+    }
+    float lengthSquared() const { return x * x + y * y + z * z; }
+    float length() const { return std::sqrt(x * x + y * y + z * z); }
+
+    Vec3 normalized() const {
+        float len = length();
+        if (len > 0) {
+            return Vec3(x / len, y / len, z / len);
+        }
+        return *this;
+    }
+};
+
+// 4D vector backed by SIMD lanes
+struct alignas(16) Vec4 {
+    float x, y, z, w;
+
+    Vec4() : x(0), y(0), z(0), w(0) {}
+    Vec4(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+    Vec4(const Vec3& v, float w_) : x(v.x), y(v.y), z(v.z), w(w_) {}
+    explicit Vec4(vmath::Lanes lanes) { vmath::store(&x, lanes); }
+
+    vmath::Lanes lanes() const { return vmath::load(&x); }
+    Vec3 xyz() const { return Vec3(x, y, z); }
+
+    Vec4 operator+(const Vec4& other) const { return Vec4(vmath::add(lanes(), other.lanes())); }
+    Vec4 operator-(const Vec4& other) const { return Vec4(vmath::sub(lanes(), other.lanes())); }
+    Vec4 operator*(float scalar) const { return Vec4(vmath::mul(lanes(), vmath::splat(scalar))); }
+    Vec4 operator*(const Vec4& other) const { return Vec4(vmath::mul(lanes(), other.lanes())); }
+
+    float dot(const Vec4& other) const { return x * other.x + y * other.y + z * other.z + w * other.w; }
+};
+
+// Rotation quaternion, stored x, y, z, w as in Three.js
+struct alignas(16) Quat {
+    float x, y, z, w;
+
+    Quat() : x(0), y(0), z(0), w(1) {}
+    Quat(float x_, float y_, float z_, float w_) : x(x_), y(y_), z(z_), w(w_) {}
+
+    static Quat fromAxisAngle(const Vec3& axis, float angle) {
+        Vec3 n = axis.normalized();
+        float s = std::sin(angle * 0.5f);
+        return Quat(n.x * s, n.y * s, n.z * s, std::cos(angle * 0.5f));
+    }
+
+    // Same rotation as a Three.js Euler (pitch, heading, roll) in 'YXZ' order
+    static Quat fromEulerYXZ(float heading, float pitch, float roll) {
+        float c1 = std::cos(pitch * 0.5f), s1 = std::sin(pitch * 0.5f);
+        float c2 = std::cos(heading * 0.5f), s2 = std::sin(heading * 0.5f);
+        float c3 = std::cos(roll * 0.5f), s3 = std::sin(roll * 0.5f);
+        return Quat(s1 * c2 * c3 + c1 * s2 * s3,
+                    c1 * s2 * c3 - s1 * c2 * s3,
+                    c1 * c2 * s3 - s1 * s2 * c3,
+                    c1 * c2 * c3 + s1 * s2 * s3);
+    }
+
+    // Hamilton product: applies other first, then this
+    Quat operator*(const Quat& o) const {
+        return Quat(w * o.x + x * o.w + y * o.z - z * o.y,
+                    w * o.y - x * o.z + y * o.w + z * o.x,
+                    w * o.z + x * o.y - y * o.x + z * o.w,
+                    w * o.w - x * o.x - y * o.y - z * o.z);
+    }
+
+    Quat conjugate() const { return Quat(-x, -y, -z, w); }
+    float dot(const Quat& o) const { return x * o.x + y * o.y + z * o.z + w * o.w; }
+
+    Quat normalized() const {
+        float len = std::sqrt(x * x + y * y + z * z + w * w);
+        if (len > 0) {
+            return Quat(x / len, y / len, z / len, w / len);
+        }
+        return Quat();
+    }
+
+    // v + 2w(u x v) + 2u x (u x v), with u the vector part
+    Vec3 rotate(const Vec3& v) const {
+        Vec3 u(x, y, z);
+        Vec3 t = u.cross(v) * 2.0f;
+        return v + t * w + u.cross(t);
+    }
+
+    // Shortest-path spherical interpolation; falls back to normalized lerp when nearly parallel
+    static Quat slerp(const Quat& a, const Quat& b, float t) {
+        float cosTheta = a.dot(b);
+        float sign = cosTheta < 0 ? -1.0f : 1.0f;
+        cosTheta *= sign;
+        float wa = 1.0f - t, wb = t;
+        if (cosTheta < 0.9995f) {
+            float theta = std::acos(cosTheta);
+            float inverseSin = 1.0f / std::sin(theta);
+            wa = std::sin((1.0f - t) * theta) * inverseSin;
+            wb = std::sin(t * theta) * inverseSin;
+        }
+        wb *= sign;
+        Quat r(a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb);
+        if (cosTheta < 0.9995f) {
+            return r;
+        }
+        float len = std::sqrt(r.x * r.x + r.y * r.y + r.z * r.z + r.w * r.w);
+        return Quat(r.x / len, r.y / len, r.z / len, r.w / len);
+    }
+};
+
+// 3x3 matrix, column-major; columns padded to four floats for SIMD loads
+struct alignas(16) Mat3 {
+    float m[12];
+
+    Mat3() { setIdentity(); }
+
+    void setIdentity() {
+        for (int i = 0; i < 12; ++i) m[i] = 0.0f;
+        m[0] = m[5] = m[10] = 1.0f;
+    }
+
+    float& at(int row, int column) { return m[column * 4 + row]; }
+    float at(int row, int column) const { return m[column * 4 + row]; }
+
+    static Mat3 fromQuat(const Quat& q) {
+        const float x2 = q.x + q.x, y2 = q.y + q.y, z2 = q.z + q.z;
+        const float xx = q.x * x2, xy = q.x * y2, xz = q.x * z2;
+        const float yy = q.y * y2, yz = q.y * z2, zz = q.z * z2;
+        const float wx = q.w * x2, wy = q.w * y2, wz = q.w * z2;
+        Mat3 r;
+        r.m[0] = 1 - (yy + zz); r.m[1] = xy + wz;       r.m[2] = xz - wy;
+        r.m[4] = xy - wz;       r.m[5] = 1 - (xx + zz); r.m[6] = yz + wx;
+        r.m[8] = xz + wy;       r.m[9] = yz - wx;       r.m[10] = 1 - (xx + yy);
+        return r;
+    }
+
+    // Ry(heading) * Rx(pitch) * Rz(roll), the rotation of a Three.js 'YXZ' Euler
+    static Mat3 fromEulerYXZ(float heading, float pitch, float roll) {
+        const float a = std::cos(pitch), b = std::sin(pitch);
+        const float c = std::cos(heading), d = std::sin(heading);
+        const float e = std::cos(roll), f = std::sin(roll);
+        const float ce = c * e, cf = c * f, de = d * e, df = d * f;
+        Mat3 r;
+        r.m[0] = ce + df * b; r.m[1] = a * f; r.m[2] = cf * b - de;
+        r.m[4] = de * b - cf; r.m[5] = a * e; r.m[6] = df + ce * b;
+        r.m[8] = a * d;       r.m[9] = -b;    r.m[10] = a * c;
+        return r;
+    }
+
+    Vec3 operator*(const Vec3& v) const {
+        using namespace vmath;
+        Vec4 r(mulAdd(load(m + 8), splat(v.z), mulAdd(load(m + 4), splat(v.y), mul(load(m), splat(v.x)))));
+        return r.xyz();
+    }
+
+    Mat3 operator*(const Mat3& o) const {
+        using namespace vmath;
+        Mat3 r;
+        for (int c = 0; c < 3; ++c) {
+            const float* col = o.m + c * 4;
+            store(r.m + c * 4, mulAdd(load(m + 8), splat(col[2]),
+                                      mulAdd(load(m + 4), splat(col[1]), mul(load(m), splat(col[0])))));
+        }
+        return r;
+    }
+
+    Mat3 transposed() const {
+        Mat3 r;
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 3; ++column) {
+                r.at(column, row) = at(row, column);
+            }
+        }
+        return r;
+    }
+};
+
+// 4x4 matrix, column-major as WebGL and Three.js expect
+struct alignas(16) Mat4 {
+    float m[16];
+
+    Mat4() { setIdentity(); }
+
+    void setIdentity() {
+        for (int i = 0; i < 16; ++i) m[i] = 0.0f;
+        m[0] = m[5] = m[10] = m[15] = 1.0f;
+    }
+
+    float& at(int row, int column) { return m[column * 4 + row]; }
+    float at(int row, int column) const { return m[column * 4 + row]; }
+
+    static Mat4 fromRotationTranslation(const Mat3& rotation, const Vec3& translation) {
+        Mat4 r;
+        for (int c = 0; c < 3; ++c) {
+            r.m[c * 4] = rotation.m[c * 4];
+            r.m[c * 4 + 1] = rotation.m[c * 4 + 1];
+            r.m[c * 4 + 2] = rotation.m[c * 4 + 2];
+            r.m[c * 4 + 3] = 0.0f;
+        }
+        r.m[12] = translation.x;
+        r.m[13] = translation.y;
+        r.m[14] = translation.z;
+        r.m[15] = 1.0f;
+        return r;
+    }
+
+    Mat4 operator*(const Mat4& o) const {
+        using namespace vmath;
+        Mat4 r;
+        for (int c = 0; c < 4; ++c) {
+            const float* col = o.m + c * 4;
+            Lanes sum = mul(load(m), splat(col[0]));
+            sum = mulAdd(load(m + 4), splat(col[1]), sum);
+            sum = mulAdd(load(m + 8), splat(col[2]), sum);
+            sum = mulAdd(load(m + 12), splat(col[3]), sum);
+            store(r.m + c * 4, sum);
+        }
+        return r;
+    }
+
+    Vec4 operator*(const Vec4& v) const {
+        using namespace vmath;
+        Lanes sum = mul(load(m), splat(v.x));
+        sum = mulAdd(load(m + 4), splat(v.y), sum);
+        sum = mulAdd(load(m + 8), splat(v.z), sum);
+        sum = mulAdd(load(m + 12), splat(v.w), sum);
+        return Vec4(sum);
+    }
+
+    Vec3 transformPoint(const Vec3& p) const { return (*this * Vec4(p, 1.0f)).xyz(); }
+    Vec3 transformDirection(const Vec3& d) const { return (*this * Vec4(d, 0.0f)).xyz(); }
+};
+
+// Batch operations on packed arrays: vectors are 3 floats, quaternions 4 (x, y, z, w),
+// matching Float32Array layouts on the JS side. Each step loads four whole elements straight
+// from the array and shuffles them into one lane per component; only the remainder is copied
+// through a zero-padded block. Where the lanes buy nothing over what the compiler vectorizes
+// by itself (component-wise add, quaternion product) the functions are plain loops instead.
+// Output may alias input.
+namespace vmath {
+
+namespace detail {
+
+// Gather up to four elements of 'width' floats into one Lanes per component (partial blocks)
+template <int Width>
+inline void gather(const float* data, size_t count, Lanes (&out)[Width]) {
+    alignas(16) float component[Width][4] = {};
+    for (size_t i = 0; i < count; ++i) {
+        for (int k = 0; k < Width; ++k) {
+            component[k][i] = data[i * Width + k];
+        }
+    }
+    for (int k = 0; k < Width; ++k) {
+        out[k] = load(component[k]);
+    }
+}
+
+template <int Width>
+inline void scatter(const Lanes (&in)[Width], size_t count, float* data) {
+    alignas(16) float component[Width][4];
+    for (int k = 0; k < Width; ++k) {
+        store(component[k], in[k]);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        for (int k = 0; k < Width; ++k) {
+            data[i * Width + k] = component[k][i];
+        }
+    }
+}
+
+// Four whole elements, loaded and stored directly. The generic versions only instantiate for
+// the placeholder second input of one-input kernels, which is never read.
+template <int Width>
+inline void loadBlock(const float* data, Lanes (&out)[Width]) {
+    gather<Width>(data, 4, out);
+}
+
+template <>
+inline void loadBlock<3>(const float* data, Lanes (&out)[3]) {
+    loadXYZ(data, out[0], out[1], out[2]);
+}
+
+template <>
+inline void loadBlock<4>(const float* data, Lanes (&out)[4]) {
+    for (int k = 0; k < 4; ++k) {
+        out[k] = load(data + k * 4);
+    }
+    transpose(out[0], out[1], out[2], out[3]);
+}
+
+template <int Width>
+inline void storeBlock(const Lanes (&in)[Width], float* data) {
+    scatter<Width>(in, 4, data);
+}
+
+template <>
+inline void storeBlock<3>(const Lanes (&in)[3], float* data) {
+    storeXYZ(data, in[0], in[1], in[2]);
+}
+
+// Widths that are multiples of four (quaternions, 4x4 matrices) transpose four lanes at a time
+template <int Width>
+inline void storeTransposed(const Lanes (&in)[Width], float* data) {
+    for (int k = 0; k < Width; k += 4) {
+        Lanes r0 = in[k], r1 = in[k + 1], r2 = in[k + 2], r3 = in[k + 3];
+        transpose(r0, r1, r2, r3);
+        store(data + k, r0);
+        store(data + Width + k, r1);
+        store(data + 2 * Width + k, r2);
+        store(data + 3 * Width + k, r3);
+    }
+}
+
+template <>
+inline void storeBlock<4>(const Lanes (&in)[4], float* data) {
+    storeTransposed<4>(in, data);
+}
+
+template <>
+inline void storeBlock<16>(const Lanes (&in)[16], float* data) {
+    storeTransposed<16>(in, data);
+}
+
+// Run kernel(a, b, out) over blocks of four; WidthB is 0 when there is no second input
+template <int WidthA, int WidthB, int WidthOut, typename Kernel>
+inline void forEachBlock(const float* a, const float* b, float* out, size_t count, Kernel kernel) {
+    const int kWidthB = WidthB > 0 ? WidthB : 1;
+    const size_t whole = count & ~static_cast<size_t>(3);
+    for (size_t begin = 0; begin < whole; begin += 4) {
+        Lanes la[WidthA], lb[kWidthB], result[WidthOut];
+        loadBlock<WidthA>(a + begin * WidthA, la);
+        if (WidthB > 0) {
+            loadBlock<kWidthB>(b + begin * kWidthB, lb);
+        }
+        kernel(la, lb, result);
+        storeBlock<WidthOut>(result, out + begin * WidthOut);
+    }
+    if (whole < count) {
+        const size_t n = count - whole;
+        Lanes la[WidthA], lb[kWidthB], result[WidthOut];
+        gather<WidthA>(a + whole * WidthA, n, la);
+        if (WidthB > 0) {
+            gather<kWidthB>(b + whole * kWidthB, n, lb);
+        }
+        kernel(la, lb, result);
+        scatter<WidthOut>(result, n, out + whole * WidthOut);
+    }
+}
+
+inline void cross(const Lanes* a, const Lanes* b, Lanes* out) {
+    out[0] = sub(mul(a[1], b[2]), mul(a[2], b[1]));
+    out[1] = sub(mul(a[2], b[0]), mul(a[0], b[2]));
+    out[2] = sub(mul(a[0], b[1]), mul(a[1], b[0]));
+}
+
+// Up to four consecutive floats, unused lanes zeroed
+inline Lanes loadPartial(const float* data, size_t count) {
+    alignas(16) float lanes[4] = {};
+    for (size_t i = 0; i < count; ++i) {
+        lanes[i] = data[i];
+    }
+    return load(lanes);
+}
+
+} // namespace detail
+
+// Component-wise, so a plain loop over the floats that the compiler vectorizes itself
+inline void addVectors(const float* a, const float* b, float* out, size_t count) {
+    for (size_t i = 0; i < count * 3; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+inline void crossVectors(const float* a, const float* b, float* out, size_t count) {
+    detail::forEachBlock<3, 3, 3>(a, b, out, count, [](const Lanes* va, const Lanes* vb, Lanes* r) {
+        detail::cross(va, vb, r);
+    });
+}
+
+// Zero-length vectors are left unchanged, as Vec3::normalized does
+inline void normalizeVectors(const float* vectors, float* out, size_t count) {
+    detail::forEachBlock<3, 0, 3>(vectors, nullptr, out, count, [](const Lanes* v, const Lanes*, Lanes* r) {
+        Lanes len = sqrt(add(add(mul(v[0], v[0]), mul(v[1], v[1])), mul(v[2], v[2])));
+        Lanes nonZero = greaterThan(len, splat(0.0f));
+        Lanes divisor = select(nonZero, len, splat(1.0f));
+        r[0] = select(nonZero, div(v[0], divisor), v[0]);
+        r[1] = select(nonZero, div(v[1], divisor), v[1]);
+        r[2] = select(nonZero, div(v[2], divisor), v[2]);
+    });
+}
+
+// Points as positions (w = 1), so the translation applies
+inline void transformPoints(const Mat4& matrix, const float* points, float* out, size_t count) {
+    const float* m = matrix.m;
+    detail::forEachBlock<3, 0, 3>(points, nullptr, out, count, [m](const Lanes* p, const Lanes*, Lanes* r) {
+        for (int row = 0; row < 3; ++row) {
+            Lanes sum = mul(splat(m[row]), p[0]);
+            sum = mulAdd(splat(m[4 + row]), p[1], sum);
+            sum = mulAdd(splat(m[8 + row]), p[2], sum);
+            r[row] = add(sum, splat(m[12 + row]));
+        }
+    });
+}
+
+// Hamilton product a[i] * b[i]. A plain loop over Quat::operator*: the compiler vectorizes
+// one product per iteration better than transposing every block in and out of lanes.
+inline void multiplyQuaternions(const float* a, const float* b, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const float* p = a + i * 4;
+        const float* q = b + i * 4;
+        Quat r = Quat(p[0], p[1], p[2], p[3]) * Quat(q[0], q[1], q[2], q[3]);
+        out[i * 4] = r.x;
+        out[i * 4 + 1] = r.y;
+        out[i * 4 + 2] = r.z;
+        out[i * 4 + 3] = r.w;
+    }
+}
+
+// Rotate vectors[i] by quaternions[i], as Quat::rotate
+inline void rotateVectors(const float* quaternions, const float* vectors, float* out, size_t count) {
+    detail::forEachBlock<4, 3, 3>(quaternions, vectors, out, count, [](const Lanes* q, const Lanes* v, Lanes* r) {
+        const Lanes two = splat(2.0f);
+        Lanes t[3], ut[3];
+        detail::cross(q, v, t);
+        t[0] = mul(t[0], two);
+        t[1] = mul(t[1], two);
+        t[2] = mul(t[2], two);
+        detail::cross(q, t, ut);
+        for (int k = 0; k < 3; ++k) {
+            r[k] = add(add(v[k], mul(t[k], q[3])), ut[k]);
+        }
+    });
+}
+
+// Quat::slerp(a[i], b[i], t) for every pair; the trigonometry stays scalar per lane
+inline void slerpQuaternions(const float* a, const float* b, float t, float* out, size_t count) {
+    detail::forEachBlock<4, 4, 4>(a, b, out, count, [t](const Lanes* qa, const Lanes* qb, Lanes* r) {
+        Lanes cosTheta = add(add(add(mul(qa[0], qb[0]), mul(qa[1], qb[1])), mul(qa[2], qb[2])), mul(qa[3], qb[3]));
+        Lanes negative = lessThan(cosTheta, splat(0.0f));
+        Lanes sign = select(negative, splat(-1.0f), splat(1.0f));
+        cosTheta = mul(cosTheta, sign);
+
+        alignas(16) float cosines[4], weightA[4], weightB[4];
+        store(cosines, cosTheta);
+        for (int i = 0; i < 4; ++i) {
+            weightA[i] = 1.0f - t;
+            weightB[i] = t;
+            if (cosines[i] < 0.9995f) {
+                float theta = std::acos(cosines[i]);
+                float inverseSin = 1.0f / std::sin(theta);
+                weightA[i] = std::sin((1.0f - t) * theta) * inverseSin;
+                weightB[i] = std::sin(t * theta) * inverseSin;
+            }
+        }
+        Lanes wa = load(weightA), wb = mul(load(weightB), sign);
+        for (int k = 0; k < 4; ++k) {
+            r[k] = add(mul(qa[k], wa), mul(qb[k], wb));
+        }
+
+        // Nearly parallel pairs took the linear path and need renormalizing
+        Lanes len = sqrt(add(add(add(mul(r[0], r[0]), mul(r[1], r[1])), mul(r[2], r[2])), mul(r[3], r[3])));
+        Lanes spherical = lessThan(cosTheta, splat(0.9995f));
+        Lanes divisor = select(spherical, splat(1.0f), len);
+        for (int k = 0; k < 4; ++k) {
+            r[k] = select(spherical, r[k], div(r[k], divisor));
+        }
+    });
+}
+
+// Mat4::fromRotationTranslation(Mat3::fromEulerYXZ(heading[i], pitch[i], roll[i]), position)
+// for every entity, from separate (structure-of-arrays) pose components; writes 16 floats per
+// matrix. Sines and cosines stay scalar per lane, the products and layout are lane-wise.
+inline void eulerYXZMatrices(const float* x, const float* y, const float* z, const float* heading,
+                             const float* pitch, const float* roll, float* out, size_t count) {
+    for (size_t begin = 0; begin < count; begin += 4) {
+        const size_t n = count - begin < 4 ? count - begin : 4;
+        alignas(16) float cosPitch[4], sinPitch[4], cosHeading[4], sinHeading[4], cosRoll[4], sinRoll[4];
+        for (int i = 0; i < 4; ++i) {
+            const size_t k = begin + i;
+            const float p = i < static_cast<int>(n) ? pitch[k] : 0.0f;
+            const float h = i < static_cast<int>(n) ? heading[k] : 0.0f;
+            const float r = i < static_cast<int>(n) ? roll[k] : 0.0f;
+            cosPitch[i] = std::cos(p);
+            sinPitch[i] = std::sin(p);
+            cosHeading[i] = std::cos(h);
+            sinHeading[i] = std::sin(h);
+            cosRoll[i] = std::cos(r);
+            sinRoll[i] = std::sin(r);
+        }
+        const Lanes a = load(cosPitch), b = load(sinPitch);
+        const Lanes c = load(cosHeading), d = load(sinHeading);
+        const Lanes e = load(cosRoll), f = load(sinRoll);
+        const Lanes ce = mul(c, e), cf = mul(c, f), de = mul(d, e), df = mul(d, f);
+        const Lanes zero = splat(0.0f);
+
+        Lanes m[16];
+        m[0] = add(ce, mul(df, b)); m[1] = mul(a, f); m[2] = sub(mul(cf, b), de); m[3] = zero;
+        m[4] = sub(mul(de, b), cf); m[5] = mul(a, e); m[6] = add(df, mul(ce, b)); m[7] = zero;
+        m[8] = mul(a, d);           m[9] = neg(b);    m[10] = mul(a, c);          m[11] = zero;
+        m[12] = n == 4 ? load(x + begin) : detail::loadPartial(x + begin, n);
+        m[13] = n == 4 ? load(y + begin) : detail::loadPartial(y + begin, n);
+        m[14] = n == 4 ? load(z + begin) : detail::loadPartial(z + begin, n);
+        m[15] = splat(1.0f);
+        if (n == 4) {
+            detail::storeBlock<16>(m, out + begin * 16);
+        } else {
+            detail::scatter<16>(m, n, out + begin * 16);
+        }
+    }
+}
+
+} // namespace vmath
@@ -0,0 +1,129 @@
+#include "visibility.h"
+#include <algorithm>
+#include <limits>
+
+VisibilityCuller::VisibilityCuller() : camera(0, 0, 0), lodRatioCount(0), maxDistance(0.0f) {
+    // Until a frustum is set every plane passes everything
+    for (int p = 0; p < 6; ++p) {
+        planes[p][0] = planes[p][1] = planes[p][2] = 0.0f;
+        planes[p][3] = 1.0f;
+    }
+    setLodRatios({150.0f, 600.0f, 2500.0f});
+}
+
+void VisibilityCuller::setFrustum(const float* planeData) {
+    for (int p = 0; p < 6; ++p) {
+        for (int k = 0; k < 4; ++k) {
+            planes[p][k] = planeData[p * 4 + k];
+        }
+    }
+}
+
+void VisibilityCuller::setLodRatios(const std::vector<float>& ratios) {
+    lodRatioCount = std::min(static_cast<int>(ratios.size()), kMaxLodRatios);
+    for (int k = 0; k < kMaxLodRatios; ++k) {
+        lodRatios[k] = k < lodRatioCount ? ratios[k] : std::numeric_limits<float>::infinity();
+    }
+}
+
+void VisibilityCuller::resize(SphereSet& set, int count) {
+    set.x.resize(count);
+    set.y.resize(count);
+    set.z.resize(count);
+    set.radius.resize(count);
+    set.lods.resize(count);
+}
+
+void VisibilityCuller::setSpheres(int visibilityClass, const float* spheres, int count, int stride) {
+    SphereSet& set = sets[visibilityClass];
+    resize(set, count);
+    for (int i = 0; i < count; ++i) {
+        const float* sphere = spheres + static_cast<size_t>(i) * stride;
+        set.x[i] = sphere[0];
+        set.y[i] = sphere[1];
+        set.z[i] = sphere[2];
+        set.radius[i] = sphere[3];
+    }
+}
+
+void VisibilityCuller::setAircraft(const AircraftFleet& fleet) {
+    SphereSet& set = sets[VISIBILITY_AIRCRAFT];
+    const int count = fleet.size();
+    resize(set, count);
+    for (int i = 0; i < count; ++i) {
+        const FlightDynamics& aircraft = fleet.getAircraft(i);
+        const Vec3& position = aircraft.getState().position;
+        set.x[i] = position.x;
+        set.y[i] = position.y;
+        set.z[i] = position.z;
+        set.radius[i] = aircraft.getProperties().outsideRadius;
+    }
+}
+
+void VisibilityCuller::setAircraft(const RemoteEntitySet& entities) {
+    SphereSet& set = sets[VISIBILITY_AIRCRAFT];
+    const int count = entities.size();
+    const std::vector<float>& poses = entities.getRenderData();
+    resize(set, count);
+    for (int i = 0; i < count; ++i) {
+        const float* pose = &poses[static_cast<size_t>(i) * RemoteEntitySet::kRenderStride];
+        set.x[i] = pose[0];
+        set.y[i] = pose[1];
+        set.z[i] = pose[2];
+        set.radius[i] = entities.getModel(i).getProperties().outsideRadius;
+    }
+}
+
+void VisibilityCuller::cull(SphereSet& set) {
+    const int count = static_cast<int>(set.lods.size());
+    const float* __restrict xs = set.x.data();
+    const float* __restrict ys = set.y.data();
+    const float* __restrict zs = set.z.data();
+    const float* __restrict radii = set.radius.data();
+    uint8_t* __restrict lods = set.lods.data();
+
+    // Locals keep the loop free of aliasing with the outputs
+    float plane[6][4];
+    std::copy(&planes[0][0], &planes[0][0] + 24, &plane[0][0]);
+    float ratios[kMaxLodRatios];
+    std::copy(lodRatios, lodRatios + kMaxLodRatios, ratios);
+    const float cx = camera.x, cy = camera.y, cz = camera.z;
+    const float limit = maxDistance > 0 ? maxDistance : std::numeric_limits<float>::infinity();
+
+    for (int i = 0; i < count; ++i) {
+        const float x = xs[i], y = ys[i], z = zs[i], r = radii[i];
+
+        // Behind any plane by more than the radius means outside; the nearest plane decides
+        float nearest = plane[0][0] * x + plane[0][1] * y + plane[0][2] * z + plane[0][3];
+        nearest = std::min(nearest, plane[1][0] * x + plane[1][1] * y + plane[1][2] * z + plane[1][3]);
+        nearest = std::min(nearest, plane[2][0] * x + plane[2][1] * y + plane[2][2] * z + plane[2][3]);
+        nearest = std::min(nearest, plane[3][0] * x + plane[3][1] * y + plane[3][2] * z + plane[3][3]);
+        nearest = std::min(nearest, plane[4][0] * x + plane[4][1] * y + plane[4][2] * z + plane[4][3]);
+        nearest = std::min(nearest, plane[5][0] * x + plane[5][1] * y + plane[5][2] * z + plane[5][3]);
+
+        const float dx = x - cx, dy = y - cy, dz = z - cz;
+        const float distanceSquared = dx * dx + dy * dy + dz * dz;
+        const float r0 = ratios[0] * r, r1 = ratios[1] * r, r2 = ratios[2] * r, r3 = ratios[3] * r;
+        int lod = (distanceSquared >= r0 * r0) + (distanceSquared >= r1 * r1) +
+                  (distanceSquared >= r2 * r2) + (distanceSquared >= r3 * r3);
+        const float reach = limit + r;
+        const bool outside = (nearest < -r) | (distanceSquared > reach * reach);
+        lods[i] = static_cast<uint8_t>(outside ? kCulled : lod);
+    }
+
+    // Branch-free compaction: always write, advance only past visible entries
+    set.visible.resize(count);
+    int* visible = set.visible.data();
+    int visibleCount = 0;
+    for (int i = 0; i < count; ++i) {
+        visible[visibleCount] = i;
+        visibleCount += lods[i] != kCulled ? 1 : 0;
+    }
+    set.visible.resize(visibleCount);
+}
+
+void VisibilityCuller::cull() {
+    for (SphereSet& set : sets) {
+        cull(set);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "fleet.h"
+#include "remote_entity.h"
+
+// Kinds of entity culled separately, each with its own visible list
+enum VisibilityClass {
+    VISIBILITY_AIRCRAFT = 0,
+    VISIBILITY_EMITTERS = 1,
+    VISIBILITY_PROJECTILES = 2,
+    VISIBILITY_CLASS_COUNT = 3
+};
+
+// Frustum and distance culling of bounding spheres, with a level of detail per entity.
+// Spheres are kept as separate x/y/z/radius arrays and tested with branch-free arithmetic so
+// the loop vectorizes; visible entity indices are then compacted into one list per class.
+// LOD follows distance over radius, a stand-in for projected size: an entity gets LOD k when
+// distance / radius is at least the k-th ratio.
+class VisibilityCuller {
+public:
+    static constexpr uint8_t kCulled = 255;
+    static constexpr int kMaxLodRatios = 4;
+
+private:
+    struct SphereSet {
+        std::vector<float> x, y, z, radius;
+        std::vector<uint8_t> lods;          // Per entity, kCulled when not drawn
+        std::vector<int> visible;           // Indices of drawn entities in ascending order
+    };
+
+    SphereSet sets[VISIBILITY_CLASS_COUNT];
+    float planes[6][4];                     // nx, ny, nz, d; inside where n.p + d >= 0
+    Vec3 camera;
+    float lodRatios[kMaxLodRatios];         // Unused entries are infinite
+    int lodRatioCount;
+    float maxDistance;
+
+    void resize(SphereSet& set, int count);
+    void cull(SphereSet& set);
+
+public:
+    VisibilityCuller();
+
+    // Six planes with inward unit normals, e.g. THREE.Frustum planes as (normal, constant)
+    void setFrustum(const float* planeData);
+    void setCamera(const Vec3& position) { camera = position; }
+    // Ascending distance / radius ratios, at most kMaxLodRatios
+    void setLodRatios(const std::vector<float>& ratios);
+    // Beyond this distance (plus the radius) nothing is drawn; 0 disables distance culling
+    void setMaxDistance(float distance) { maxDistance = distance; }
+
+    // Spheres as 'stride' floats each starting with x, y, z, radius
+    void setSpheres(int visibilityClass, const float* spheres, int count, int stride);
+    // Aircraft positions with their HTRADIUS
+    void setAircraft(const AircraftFleet& fleet);
+    void setAircraft(const RemoteEntitySet& entities);
+
+    // Test every class against the current frustum and camera
+    void cull();
+
+    int getCount(int visibilityClass) const { return static_cast<int>(sets[visibilityClass].lods.size()); }
+    const std::vector<int>& getVisible(int visibilityClass) const { return sets[visibilityClass].visible; }
+    const std::vector<uint8_t>& getLods(int visibilityClass) const { return sets[visibilityClass].lods; }
+};
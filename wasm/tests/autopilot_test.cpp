@@ -0,0 +1,76 @@
+// Autopilot: the PID loop stops winding up when saturated, every hold mode settles on its
+// target, and waypoint following advances along a route.
+
+#include <cmath>
+#include "fleet.h"
+#include "test_check.h"
+
+namespace {
+
+const float kTickTime = 1.0f / 60.0f;
+
+void testPID() {
+    PIDGains gains(1.0f, 1.0f, 0.0f, -1.0f, 1.0f);
+    PIDState pid;
+    for (int i = 0; i < 600; ++i) {
+        CHECK(stepPID(gains, pid, 10.0f, kTickTime) == 1.0f);
+    }
+    // Saturated the whole time, so the integral did not grow and a reversal acts at once
+    CHECK(pid.integral < 0.1f);
+    CHECK(stepPID(gains, pid, -0.5f, kTickTime) < 0.0f);
+}
+
+void testHolds() {
+    AircraftFleet fleet;
+    AutopilotSystem& autopilot = fleet.getAutopilot();
+    const int count = 4;
+    for (int i = 0; i < count; ++i) {
+        fleet.addAircraft(Vec3(i * 500.0f, 1000.0f, 0.0f), 0.0f);
+        autopilot.setMode(i, AUTOPILOT_ALTITUDE | AUTOPILOT_HEADING | AUTOPILOT_SPEED);
+        autopilot.setTargetAltitude(i, 700.0f + 300.0f * i);
+        autopilot.setTargetHeading(i, 0.5f * (i - 1.5f));
+        autopilot.setTargetSpeed(i, 180.0f + 10.0f * i);
+    }
+    for (int tick = 0; tick < 150 * 60; ++tick) {
+        fleet.update(kTickTime);
+    }
+    for (int i = 0; i < count; ++i) {
+        const AircraftState& state = fleet.getAircraft(i).getState();
+        CHECK(std::fabs(state.position.y - (700.0f + 300.0f * i)) < 5.0f);
+        CHECK(std::fabs(state.heading - 0.5f * (i - 1.5f)) < 0.01f);
+        CHECK(std::fabs(state.airspeed - (180.0f + 10.0f * i)) < 1.0f);
+        CHECK(std::fabs(state.velocity.y) < 1.0f);
+    }
+}
+
+void testWaypoints() {
+    AircraftFleet fleet;
+    AutopilotSystem& autopilot = fleet.getAutopilot();
+    fleet.addAircraft(Vec3(0.0f, 1000.0f, 0.0f), 0.0f);
+    autopilot.setMode(0, AUTOPILOT_WAYPOINT);
+    autopilot.addWaypoint(0, Waypoint(Vec3(10000.0f, 1300.0f, 0.0f), 180.0f));
+    autopilot.addWaypoint(0, Waypoint(Vec3(20000.0f, 1100.0f, 500.0f), 220.0f));
+    autopilot.addWaypoint(0, Waypoint(Vec3(40000.0f, 1100.0f, 500.0f), 220.0f));
+
+    int previous = 0;
+    for (int tick = 0; tick < 150 * 60; ++tick) {
+        fleet.update(kTickTime);
+        int current = autopilot.getCurrentWaypoint(0);
+        CHECK(current >= previous);
+        previous = current;
+    }
+    // Open route: the last point is held once reached
+    CHECK(autopilot.getCurrentWaypoint(0) == 2);
+    const AircraftState& state = fleet.getAircraft(0).getState();
+    CHECK(std::fabs(state.position.y - 1100.0f) < 10.0f);
+    CHECK(std::fabs(state.airspeed - 220.0f) < 2.0f);
+}
+
+} // namespace
+
+int main() {
+    testPID();
+    testHolds();
+    testWaypoints();
+    return test::result("autopilot_test");
+}
@@ -0,0 +1,152 @@
+// Flight recorder: serialized tracks load back bit-exact and play back the recorded flight;
+// corrupted or truncated blobs are rejected or, if they still parse, play back safely.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "flight_recorder.h"
+#include "replay.h"
+#include "test_check.h"
+
+namespace {
+
+const int kTicks = 2000;
+const double kTickTime = 1.0 / 60.0;
+
+bool sameFrames(const RecordedTrack& a, const RecordedTrack& b) {
+    TrackDecoder decoderA(a), decoderB(b);
+    RecordedFrame frameA, frameB;
+    uint32_t count = 0;
+    while (decoderA.next(frameA)) {
+        if (!decoderB.next(frameB) || std::memcmp(frameA.values, frameB.values, sizeof(frameA.values)) != 0) {
+            return false;
+        }
+        count++;
+    }
+    return !decoderB.next(frameB) && count == a.getTickCount();
+}
+
+} // namespace
+
+int main() {
+    FlightDynamics dynamics;
+    dynamics.initialize(Vec3(0, 1000, 0), 0.2f);
+    dynamics.setThrottle(0.7f);
+    FlightRecorder recorder(30);
+    std::vector<Vec3> positions;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        dynamics.setControlSurfaces(tick % 50 < 25 ? 0.2f : -0.2f, -0.1f, 0.0f);
+        dynamics.update(static_cast<float>(kTickTime));
+        recorder.recordAircraft(0, tick * kTickTime, dynamics);
+        positions.push_back(dynamics.getState().position);
+    }
+    const RecordedTrack& track = recorder.getTrack(0);
+    CHECK(track.getTickCount() == kTicks);
+
+    // Round trip
+    std::vector<uint8_t> blob;
+    track.serialize(blob);
+    std::unique_ptr<RecordedTrack> loaded = RecordedTrack::deserialize(blob.data(), blob.size());
+    CHECK(loaded != nullptr);
+    if (!loaded) {
+        return test::result("flight_recorder_test");
+    }
+    std::vector<uint8_t> again;
+    loaded->serialize(again);
+    CHECK(again == blob);
+    CHECK(sameFrames(track, *loaded));
+    CHECK(sameFrames(track, *track.clone()));
+
+    // Playback at the recorded ticks reproduces the flight within quantization
+    TrackPlayer player(*loaded);
+    RecordedSample sample;
+    float worst = 0.0f;
+    for (int tick = 0; tick < kTicks; tick += 7) {
+        player.sample(tick * kTickTime, sample);
+        worst = std::max(worst, (sample.state.position - positions[tick]).length());
+    }
+    CHECK(worst < 0.1f);
+
+    // Truncated or extended blobs never load
+    for (size_t size = 0; size < blob.size(); size += 13) {
+        CHECK(RecordedTrack::deserialize(blob.data(), size) == nullptr);
+    }
+    std::vector<uint8_t> longer = blob;
+    longer.push_back(0);
+    CHECK(RecordedTrack::deserialize(longer.data(), longer.size()) == nullptr);
+
+    // Prediction history that disagrees with the stream never loads (header, name, four
+    // fields, then the two frames)
+    size_t history = 12 + track.getAircraftName().size() + 16;
+    for (size_t byte = history; byte < history + 2 * sizeof(RecordedFrame); byte += 5) {
+        std::vector<uint8_t> corrupt = blob;
+        corrupt[byte] ^= 0x10;
+        CHECK(RecordedTrack::deserialize(corrupt.data(), corrupt.size()) == nullptr);
+    }
+
+    // Bit flips: whatever still parses must play back without reading out of bounds
+    int accepted = 0, total = 0;
+    for (size_t byte = 0; byte < blob.size(); byte += 3) {
+        std::vector<uint8_t> corrupt = blob;
+        corrupt[byte] ^= static_cast<uint8_t>(1u << (byte % 8));
+        total++;
+        std::unique_ptr<RecordedTrack> parsed = RecordedTrack::deserialize(corrupt.data(), corrupt.size());
+        if (!parsed) {
+            continue;
+        }
+        accepted++;
+        CHECK(parsed->getTickCount() == kTicks);
+        TrackPlayer corruptPlayer(*parsed);
+        for (double time = -1.0; time < 40.0; time += 0.37) {
+            corruptPlayer.sample(time, sample);
+        }
+        corruptPlayer.seek(10.0);
+        corruptPlayer.sample(5.0, sample);
+        CHECK(std::isfinite(corruptPlayer.getEndTime()));
+    }
+    CHECK(accepted < total);
+
+    // Track indices may only append the next track
+    FlightRecorder indexed(30);
+    CHECK(!indexed.recordAircraft(-1, 0.0, dynamics));
+    CHECK(!indexed.recordAircraft(1000000000, 0.0, dynamics));
+    CHECK(!indexed.recordAircraft(1, 0.0, dynamics));
+    CHECK(indexed.getTrackCount() == 0);
+    CHECK(indexed.recordAircraft(0, 0.0, dynamics));
+    CHECK(indexed.recordAircraft(1, 0.0, dynamics));
+    CHECK(indexed.recordAircraft(0, kTickTime, dynamics));
+    CHECK(!indexed.recordAircraft(3, 0.0, dynamics));
+    CHECK(indexed.getTrackCount() == 2);
+    CHECK(indexed.getTrack(0).getTickCount() == 2);
+
+    // A diverged aircraft records NaN as 0 and clamps runaway values instead of overflowing
+    FlightDynamics diverged;
+    diverged.initialize(Vec3(0, 1000, 0), 0.2f);
+    AircraftState bad = diverged.getState();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    bad.position = Vec3(nan, 1e30f, -1e30f);
+    bad.velocity = Vec3(std::numeric_limits<float>::infinity(), 0.0f, 0.0f);
+    bad.heading = nan;
+    bad.throttle = 1e30f;
+    diverged.setState(bad);
+    FlightRecorder runaway(30);
+    CHECK(runaway.recordAircraft(0, 0.0, diverged));
+    CHECK(runaway.recordAircraft(0, nan, diverged));
+    TrackDecoder decoder(runaway.getTrack(0));
+    RecordedFrame frame;
+    int decoded = 0;
+    while (decoder.next(frame)) {
+        CHECK(frame.values[REC_POSITION_X] == 0);
+        CHECK(frame.values[REC_POSITION_Y] > 2000000000);
+        CHECK(frame.values[REC_POSITION_Z] < -2000000000);
+        CHECK(frame.values[REC_VELOCITY_X] == 0);
+        CHECK(frame.values[REC_HEADING] == 0);
+        CHECK(frame.values[REC_THROTTLE] > 2000000000);
+        decoded++;
+    }
+    CHECK(decoded == 2);
+    return test::result("flight_recorder_test");
+}
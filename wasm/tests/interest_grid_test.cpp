@@ -0,0 +1,128 @@
+// Interest grid: for moving entities and observers, every observer's bands agree with a
+// brute-force distance filter (up to hysteresis), and its relevant list and enter/leave
+// events stay consistent with those bands.
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "interest_grid.h"
+#include "test_check.h"
+
+namespace {
+
+const int kEntities = 300;
+const int kObservers = 4;
+const int kTicks = 600;
+const float kHysteresis = 0.05f;
+const std::vector<InterestBand> kBands = {{800.0f, 1}, {2000.0f, 4}, {5000.0f, 15}};
+
+uint32_t randomState = 987654321u;
+
+float randomUnit() {
+    randomState = randomState * 1664525u + 1013904223u;
+    return static_cast<float>(randomState >> 8) / 16777216.0f;
+}
+
+float randomRange(float low, float high) {
+    return low + (high - low) * randomUnit();
+}
+
+// Nearest band whose radius contains the distance, as the grid's enter test computes it
+int bruteForceBand(const Vec3& observer, const Vec3& entity) {
+    float distanceSquared = (entity - observer).lengthSquared();
+    for (size_t i = 0; i < kBands.size(); ++i) {
+        if (distanceSquared <= kBands[i].radius * kBands[i].radius) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool withinLeave(const Vec3& observer, const Vec3& entity, int band) {
+    float leave = kBands[band].radius * (1.0f + kHysteresis);
+    return (entity - observer).lengthSquared() <= leave * leave;
+}
+
+} // namespace
+
+int main() {
+    InterestGrid grid(1000.0f, kHysteresis);
+    std::vector<Vec3> entityPositions;
+    std::vector<Vec3> entityVelocities;
+    std::vector<bool> alive(kEntities, true);
+    for (int i = 0; i < kEntities; ++i) {
+        entityPositions.push_back(Vec3(randomRange(-15000, 15000), 1000.0f, randomRange(-15000, 15000)));
+        entityVelocities.push_back(Vec3(randomRange(-60, 60), 0.0f, randomRange(-60, 60)));
+        CHECK(grid.addEntity(entityPositions[i]) == i);
+    }
+    std::vector<Vec3> observerPositions;
+    // Per observer, the relevant set rebuilt from its enter/leave events alone
+    std::vector<std::vector<int>> fromEvents(kObservers, std::vector<int>(kEntities, -1));
+    for (int o = 0; o < kObservers; ++o) {
+        observerPositions.push_back(Vec3(randomRange(-5000, 5000), 1000.0f, randomRange(-5000, 5000)));
+        CHECK(grid.addObserver(observerPositions[o], kBands) == o);
+    }
+
+    int mismatches = 0;
+    int checked = 0;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        // Observers first, then every entity moves, so each entity is evaluated this tick
+        for (int o = 0; o < kObservers; ++o) {
+            observerPositions[o] = observerPositions[o] + Vec3(40.0f * (o - 1.5f), 0.0f, 25.0f);
+            grid.moveObserver(o, observerPositions[o]);
+        }
+        for (int i = 0; i < kEntities; ++i) {
+            if (!alive[i]) {
+                continue;
+            }
+            if (randomUnit() < 0.02f) {
+                entityVelocities[i] = Vec3(randomRange(-60, 60), 0.0f, randomRange(-60, 60));
+            }
+            entityPositions[i] = entityPositions[i] + entityVelocities[i];
+            grid.moveEntity(i, entityPositions[i]);
+        }
+        if (tick % 100 == 50) {
+            int removed = static_cast<int>(randomUnit() * kEntities);
+            alive[removed] = false;
+            grid.removeEntity(removed);
+        }
+
+        for (int o = 0; o < kObservers; ++o) {
+            for (const InterestEvent& event : grid.getEvents(o)) {
+                fromEvents[o][event.entity] = event.band;
+            }
+            grid.clearEvents(o);
+
+            std::vector<int> relevant = grid.getRelevant(o);
+            std::sort(relevant.begin(), relevant.end());
+            std::vector<int> expectedRelevant;
+            for (int i = 0; i < kEntities; ++i) {
+                const int band = grid.getBand(o, i);
+                const int brute = alive[i] ? bruteForceBand(observerPositions[o], entityPositions[i]) : -1;
+                checked++;
+                if (band >= 0) {
+                    expectedRelevant.push_back(i);
+                }
+                // Inside a band: tracked, in that band or a nearer one kept by hysteresis.
+                // Outside all bands: dropped, unless still within the hysteresis margin.
+                bool agrees = alive[i] || band < 0;
+                if (brute >= 0) {
+                    agrees = agrees && band >= 0 && band <= brute;
+                }
+                if (band >= 0) {
+                    agrees = agrees && alive[i] && withinLeave(observerPositions[o], entityPositions[i], band);
+                }
+                mismatches += agrees ? 0 : 1;
+                CHECK((fromEvents[o][i] >= 0) == (band >= 0));
+            }
+            CHECK(relevant == expectedRelevant);
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(checked == kTicks * kObservers * kEntities);
+
+    // Removing an observer clears everything it tracked
+    grid.removeObserver(0);
+    CHECK(grid.getRelevant(0).empty());
+    return test::result("interest_grid_test");
+}
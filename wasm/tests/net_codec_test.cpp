@@ -0,0 +1,240 @@
+// Snapshot codec: lossless round trip, recovery under 30% loss in both directions,
+// despawns, and malformed packets.
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "net_codec.h"
+#include "test_check.h"
+
+namespace {
+
+const int kEntities = 24;
+
+// Smoothly changing state, so most packets use the delta forms
+NetEntityState makeState(int entity, int tick) {
+    float t = tick * 0.05f + entity;
+    AircraftState state;
+    state.position = Vec3(entity * 500.0f + 150.0f * t, 1000.0f + 40.0f * std::sin(t), -entity * 300.0f);
+    state.velocity = Vec3(150.0f, 40.0f * 0.05f * std::cos(t), 3.0f * std::sin(t));
+    state.heading = std::fmod(0.2f * t, 6.0f) - 3.0f;
+    state.pitch = 0.1f * std::sin(t);
+    state.roll = 0.5f * std::sin(0.7f * t);
+    state.headingRate = 0.2f;
+    state.pitchRate = 0.1f * std::cos(t);
+    state.rollRate = 0.35f * std::cos(0.7f * t);
+    state.throttle = 0.5f + 0.4f * std::sin(0.3f * t);
+    state.aileron = 0.3f * std::sin(t);
+    state.elevator = 0.1f * std::cos(t);
+    state.rudder = 0.0f;
+    NetEntityState out;
+    quantizeNetState(state, 2000.0f - tick * 0.1f, out);
+    return out;
+}
+
+bool sameState(const NetEntityState& a, const NetEntityState& b) {
+    return std::memcmp(a.values, b.values, sizeof(a.values)) == 0;
+}
+
+// Server and client joined by two loopback channels; the client acknowledges what it decodes
+struct Link {
+    SnapshotEncoder encoder;
+    SnapshotDecoder decoder;
+    LoopbackChannel downlink;
+    LoopbackChannel uplink;
+    std::vector<uint8_t> packet;
+    std::vector<uint8_t> received;
+    int rejected;
+
+    Link(size_t budget, float loss)
+        : encoder(budget), downlink(2, loss, 11), uplink(2, loss, 23), packet(budget), rejected(0) {}
+
+    void step() {
+        size_t size = encoder.writePacket(packet.data(), packet.size());
+        downlink.send(packet.data(), size);
+        downlink.advance();
+        uplink.advance();
+        while (downlink.receive(received)) {
+            uint16_t sequence;
+            if (!decoder.readPacket(received.data(), received.size(), sequence)) {
+                rejected++;
+                continue;
+            }
+            uint8_t ack[2] = {static_cast<uint8_t>(sequence), static_cast<uint8_t>(sequence >> 8)};
+            uplink.send(ack, sizeof(ack));
+        }
+        while (uplink.receive(received)) {
+            encoder.acknowledge(static_cast<uint16_t>(received[0] | received[1] << 8));
+        }
+    }
+};
+
+void testRoundTrip() {
+    Link link(1200, 0.0f);
+    for (int tick = 0; tick < 200; ++tick) {
+        for (int i = 0; i < kEntities; ++i) {
+            link.encoder.setEntity(static_cast<uint16_t>(i), makeState(i, tick), 1.0f);
+        }
+        link.step();
+    }
+    // Drain the channel latency
+    for (int tick = 0; tick < 4; ++tick) {
+        link.step();
+    }
+    CHECK(link.rejected == 0);
+
+    // A budget this large sends every entity in every packet
+    for (int i = 0; i < kEntities; ++i) {
+        NetEntityState state;
+        CHECK(link.decoder.getEntity(static_cast<uint16_t>(i), state));
+        CHECK(sameState(state, makeState(i, 199)));
+    }
+
+    // Dequantizing gets back close to the original values
+    AircraftState state;
+    float fuel = 0;
+    dequantizeNetState(makeState(3, 50), state, fuel);
+    CHECK(std::fabs(fuel - 1995.0f) < 1.0f);
+    CHECK(std::fabs(state.position.y - (1000.0f + 40.0f * std::sin(50 * 0.05f + 3))) < 1.0f);
+}
+
+void testLossRecovery() {
+    // Tight budget and 30% loss each way; once the states stop changing every entity must
+    // converge to the sender's state through retransmission and baseline fallback
+    Link link(300, 0.3f);
+    for (int tick = 0; tick < 600; ++tick) {
+        for (int i = 0; i < kEntities; ++i) {
+            link.encoder.setEntity(static_cast<uint16_t>(i), makeState(i, std::min(tick, 400)), 1.0f);
+        }
+        link.step();
+    }
+    CHECK(link.rejected == 0);
+    for (int i = 0; i < kEntities; ++i) {
+        NetEntityState state;
+        CHECK(link.decoder.getEntity(static_cast<uint16_t>(i), state));
+        CHECK(sameState(state, makeState(i, 400)));
+    }
+}
+
+void testDespawn() {
+    Link link(400, 0.3f);
+    int removed = 0;
+    for (int tick = 0; tick < 400; ++tick) {
+        if (tick == 100) {
+            for (int i = 0; i < kEntities / 2; ++i) {
+                link.encoder.removeEntity(static_cast<uint16_t>(i));
+            }
+        }
+        for (int i = tick < 100 ? 0 : kEntities / 2; i < kEntities; ++i) {
+            link.encoder.setEntity(static_cast<uint16_t>(i), makeState(i, tick), 1.0f);
+        }
+        link.step();
+        removed += static_cast<int>(link.decoder.getRemovedEntities().size());
+    }
+    CHECK(removed == kEntities / 2);
+    for (int i = 0; i < kEntities; ++i) {
+        NetEntityState state;
+        CHECK(link.decoder.getEntity(static_cast<uint16_t>(i), state) == (i >= kEntities / 2));
+    }
+}
+
+void testMalformedPackets() {
+    // Record a valid stream, then feed corrupted copies to a decoder that has seen the stream
+    SnapshotEncoder encoder(300);
+    std::vector<std::vector<uint8_t>> packets;
+    std::vector<uint8_t> buffer(300);
+    for (int tick = 0; tick < 40; ++tick) {
+        for (int i = 0; i < kEntities; ++i) {
+            encoder.setEntity(static_cast<uint16_t>(i), makeState(i, tick), 1.0f + i % 3);
+        }
+        size_t size = encoder.writePacket(buffer.data(), buffer.size());
+        packets.emplace_back(buffer.begin(), buffer.begin() + size);
+        encoder.acknowledge(static_cast<uint16_t>(tick));
+    }
+
+    uint32_t random = 12345;
+    auto next = [&random]() {
+        random = random * 1664525u + 1013904223u;
+        return random >> 8;
+    };
+
+    int accepted = 0;
+    for (int round = 0; round < 4000; ++round) {
+        SnapshotDecoder decoder;
+        const size_t split = 20 + round % 20;
+        uint16_t sequence;
+        for (size_t i = 0; i < split; ++i) {
+            decoder.readPacket(packets[i].data(), packets[i].size(), sequence);
+        }
+        std::vector<NetEntityState> before(kEntities);
+        std::vector<bool> known(kEntities);
+        for (int i = 0; i < kEntities; ++i) {
+            known[i] = decoder.getEntity(static_cast<uint16_t>(i), before[i]);
+        }
+
+        std::vector<uint8_t> corrupt = packets[split];
+        switch (round % 3) {
+        case 0:     // Bit flips
+            for (int flips = 1 + next() % 4; flips > 0 && !corrupt.empty(); --flips) {
+                corrupt[next() % corrupt.size()] ^= static_cast<uint8_t>(1u << (next() % 8));
+            }
+            break;
+        case 1:     // Truncation
+            corrupt.resize(next() % corrupt.size());
+            break;
+        default:    // Noise
+            for (uint8_t& byte : corrupt) {
+                byte = static_cast<uint8_t>(next());
+            }
+            break;
+        }
+
+        if (decoder.readPacket(corrupt.data(), corrupt.size(), sequence)) {
+            accepted++;
+            continue;
+        }
+        // A rejected packet changes nothing
+        for (int i = 0; i < kEntities; ++i) {
+            NetEntityState after;
+            bool present = decoder.getEntity(static_cast<uint16_t>(i), after);
+            CHECK(present == known[i]);
+            CHECK(!present || sameState(after, before[i]));
+        }
+    }
+    // Many corruptions still decode (flips inside field values); most must not
+    CHECK(accepted < 4000);
+}
+
+// Non-finite and huge angles quantize to fixed values instead of overflowing
+void testNonFiniteAngles() {
+    AircraftState state;
+    state.heading = std::numeric_limits<float>::quiet_NaN();
+    state.pitch = std::numeric_limits<float>::infinity();
+    state.roll = 1e30f;
+    NetEntityState out;
+    quantizeNetState(state, 0.0f, out);
+    CHECK(out.values[NET_HEADING] == 0);
+    CHECK(out.values[NET_PITCH] == 0);
+
+    // Whole turns reduce away: an angle and the same angle a few turns on match
+    AircraftState turned;
+    turned.heading = 1.0f;
+    NetEntityState base, wrapped;
+    quantizeNetState(turned, 0.0f, base);
+    turned.heading = 1.0f + 4.0f * 2.0f * static_cast<float>(M_PI);
+    quantizeNetState(turned, 0.0f, wrapped);
+    uint32_t difference = (base.values[NET_HEADING] - wrapped.values[NET_HEADING]) & 0xffffu;
+    CHECK(difference <= 2 || difference >= 0xfffeu);
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip();
+    testLossRecovery();
+    testDespawn();
+    testMalformedPackets();
+    testNonFiniteAngles();
+    return test::result("net_codec_test");
+}
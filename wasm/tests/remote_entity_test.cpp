@@ -0,0 +1,142 @@
+// Dead reckoning: remote aircraft fed 10 Hz updates track the sender, a correction is
+// blended out without a visible jump and decays within its bound, large errors snap, and
+// entities without updates go stale.
+
+#include <algorithm>
+#include <cmath>
+#include "remote_entity.h"
+#include "test_check.h"
+
+namespace {
+
+const float kTickTime = 1.0f / 60.0f;
+const int kUpdateInterval = 6;      // 10 Hz state updates
+
+struct Flight {
+    FlightDynamics sender;
+    RemoteEntitySet remote;
+    int tick;
+
+    Flight() : tick(0) {
+        sender.initialize(Vec3(0.0f, 1000.0f, 0.0f), 0.3f);
+        sender.setThrottle(0.8f);
+        remote.addEntity();
+    }
+
+    // One frame; updates carry the sender time of their state
+    void step(bool send = true) {
+        sender.setControlSurfaces(tick % 240 < 120 ? 0.2f : -0.2f, 0.0f, 0.0f);
+        sender.update(kTickTime);
+        tick++;
+        remote.update(kTickTime);
+        if (send && tick % kUpdateInterval == 0) {
+            remote.applyUpdate(0, sender.getState(), sender.getFuel(), tick * static_cast<double>(kTickTime));
+        }
+    }
+
+    float truthError() const {
+        return (remote.getDisplayState(0).position - sender.getState().position).length();
+    }
+};
+
+void testTracking() {
+    Flight flight;
+    float worst = 0.0f;
+    for (int i = 0; i < 60 * 20; ++i) {
+        flight.step();
+        if (i > 60) {
+            worst = std::max(worst, flight.truthError());
+        }
+    }
+    CHECK(worst < 1.0f);
+    CHECK(!flight.remote.isStale(0));
+}
+
+void testCorrectionDecay() {
+    Flight flight;
+    for (int i = 0; i < 60 * 5; ++i) {
+        flight.step();
+    }
+
+    // The sender is displaced 40 m; the next update shows up as a correction offset
+    AircraftState state = flight.sender.getState();
+    state.position = state.position + Vec3(0.0f, 0.0f, 40.0f);
+    flight.sender.setState(state);
+    do {
+        flight.step();
+    } while (flight.tick % kUpdateInterval != 0);
+    Vec3 shown = flight.remote.getDisplayState(0).position;
+    const RemoteSmoothing& smoothing = flight.remote.getSmoothing();
+    float error = flight.remote.getPositionError(0);
+    CHECK(error > 35.0f && error < 45.0f);
+
+    // Continuous display: per-frame motion stays near the airspeed, no 40 m pop
+    const float speed = flight.sender.getState().velocity.length();
+    float previousError = error;
+    int frames = 0;
+    while (flight.remote.getPositionError(0) > 0.0f && frames < 600) {
+        flight.step();
+        frames++;
+        Vec3 next = flight.remote.getDisplayState(0).position;
+        CHECK((next - shown).length() < speed * kTickTime + 5.0f);
+        shown = next;
+
+        float current = flight.remote.getPositionError(0);
+        CHECK(current <= previousError + 0.5f);
+        // Never slower than the exponential or the minimum correction speed
+        float bound = std::max(0.0f, std::min(error * std::exp(-frames * kTickTime / smoothing.correctionTime),
+                                              error - frames * kTickTime * smoothing.minCorrectionSpeed));
+        CHECK(current <= bound + 1.0f);
+        previousError = current;
+    }
+    // Settles within the exponential phase plus the linear tail, well under two seconds
+    CHECK(frames * kTickTime < 2.0f);
+    for (int i = 0; i < 60; ++i) {
+        flight.step();
+    }
+    CHECK(flight.truthError() < 1.0f);
+}
+
+void testSnapAndStale() {
+    Flight flight;
+    for (int i = 0; i < 60; ++i) {
+        flight.step();
+    }
+
+    // Beyond the snap distance the correction is applied at once
+    AircraftState state = flight.sender.getState();
+    state.position = state.position + Vec3(500.0f, 0.0f, 0.0f);
+    flight.sender.setState(state);
+    for (int i = 0; i < kUpdateInterval; ++i) {
+        flight.step();
+    }
+    CHECK(flight.remote.getPositionError(0) == 0.0f);
+    CHECK(flight.truthError() < 1.0f);
+
+    // Without updates the entity extrapolates for maxExtrapolation, then freezes
+    const float limit = flight.remote.getSmoothing().maxExtrapolation;
+    int frames = 0;
+    while (!flight.remote.isStale(0) && frames < 600) {
+        flight.step(false);
+        frames++;
+    }
+    CHECK(std::fabs(frames * kTickTime - limit) < 0.15f);
+    Vec3 frozen = flight.remote.getDisplayState(0).position;
+    flight.step(false);
+    CHECK((flight.remote.getDisplayState(0).position - frozen).length() == 0.0f);
+
+    // A fresh update revives it
+    for (int i = 0; i < kUpdateInterval; ++i) {
+        flight.step();
+    }
+    CHECK(!flight.remote.isStale(0));
+}
+
+} // namespace
+
+int main() {
+    testTracking();
+    testCorrectionDecay();
+    testSnapAndStale();
+    return test::result("remote_entity_test");
+}
@@ -0,0 +1,83 @@
+// Rollback: inputs that arrive late and are re-simulated must end in exactly the state of a
+// simulation that had every input on time.
+
+#include <cmath>
+#include <limits>
+#include "rollback.h"
+#include "test_check.h"
+
+namespace {
+
+const int kAircraft = 4;
+const int kTicks = 600;
+
+ControlInputs scriptedInput(int aircraft, int64_t tick) {
+    float t = static_cast<float>(tick) / 60.0f + aircraft;
+    ControlInputs input;
+    input.throttle = 0.6f + 0.3f * std::sin(0.4f * t);
+    input.aileron = 0.4f * std::sin(1.3f * t);
+    input.elevator = 0.15f * std::sin(0.7f * t);
+    input.rudder = 0.05f * std::cos(t);
+    return input;
+}
+
+void addAircraft(RollbackSimulator& simulator) {
+    for (int i = 0; i < kAircraft; ++i) {
+        simulator.addAircraft(Vec3(i * 200.0f, 1500.0f, 0.0f), 0.3f * i);
+    }
+    simulator.setDeterministic(true);
+}
+
+} // namespace
+
+int main() {
+    RollbackSimulator onTime(64);
+    RollbackSimulator late(64);
+    addAircraft(onTime);
+    addAircraft(late);
+
+    for (int64_t tick = 0; tick < kTicks; ++tick) {
+        for (int i = 0; i < kAircraft; ++i) {
+            CHECK(onTime.setInput(i, tick, scriptedInput(i, tick)));
+
+            // Aircraft i's inputs arrive in bursts every 5 + 7 * i ticks, so most ticks run on
+            // predicted input and are rolled back when the real one shows up
+            const int64_t delay = 5 + 7 * i;
+            if (tick % delay == delay - 1) {
+                for (int64_t t = tick - delay + 1; t <= tick; ++t) {
+                    CHECK(late.setInput(i, t, scriptedInput(i, t)));
+                }
+            }
+        }
+        onTime.step();
+        late.step();
+    }
+
+    // Deliver everything still outstanding and settle
+    for (int i = 0; i < kAircraft; ++i) {
+        for (int64_t t = kTicks - 40; t < kTicks; ++t) {
+            CHECK(late.setInput(i, t, scriptedInput(i, t)));
+        }
+    }
+    onTime.step(0);
+    late.step(0);
+
+    CHECK(late.getRollbackCount() > 0);
+    CHECK(onTime.getRollbackCount() == 0);
+    CHECK(late.getCurrentTick() == onTime.getCurrentTick());
+    CHECK(late.getChecksum() == onTime.getChecksum());
+    for (int i = 0; i < kAircraft; ++i) {
+        CHECK(late.getAircraft(i).checksum(1) == onTime.getAircraft(i).checksum(1));
+    }
+
+    // Inputs older than the history cannot be applied
+    CHECK(!late.setInput(0, late.getOldestTick() - 1, scriptedInput(0, 0)));
+
+    // Constructor arguments from JS are sanitized
+    RollbackSimulator oversized(1 << 30, std::numeric_limits<float>::quiet_NaN());
+    addAircraft(oversized);
+    CHECK(oversized.getTickDuration() == 1.0f / 60.0f);
+    CHECK(!oversized.setInput(0, RollbackSimulator::kMaxHistoryLength * 2, scriptedInput(0, 0)));
+    CHECK(RollbackSimulator(64, -1.0f).getTickDuration() == 1.0f / 60.0f);
+    return test::result("rollback_test");
+}
@@ -0,0 +1,113 @@
+// Multi-rate scheduler: tasks run at their rates with phases spread over the ticks, sliced
+// tasks step every item once per period with even slices, and advance() runs whole ticks,
+// caps catch-up and ignores bad deltas.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "scheduler.h"
+#include "test_check.h"
+
+namespace {
+
+// Four 60 Hz tasks on a 240 Hz scheduler: each runs every fourth tick, one per tick
+void testPhases() {
+    MultiRateScheduler scheduler(240.0f);
+    std::vector<int> runs(4, 0);
+    std::vector<int> perTick(240, 0);
+    int64_t tick = 0;
+    for (int task = 0; task < 4; ++task) {
+        scheduler.addTask("task", 60.0f, [&runs, &perTick, &tick, task](float deltaTime) {
+            CHECK(deltaTime == 4.0f / 240.0f);
+            runs[task]++;
+            perTick[tick % 240]++;
+        });
+    }
+    for (tick = 0; tick < 240; ++tick) {
+        scheduler.step();
+    }
+    for (int task = 0; task < 4; ++task) {
+        CHECK(runs[task] == 60);
+        CHECK(scheduler.getStats(task).period == 4);
+    }
+    CHECK(*std::max_element(perTick.begin(), perTick.end()) == 1);
+
+    // A disabled task stops running; unknown ids are refused
+    CHECK(scheduler.setEnabled(2, false));
+    CHECK(!scheduler.setEnabled(4, true));
+    CHECK(!scheduler.setEnabled(-1, true));
+    for (int i = 0; i < 240; ++i) {
+        scheduler.step();
+    }
+    CHECK(runs[2] == 60);
+    CHECK(runs[0] == 120);
+}
+
+// A 20 Hz sliced task over 1000 items on a 240 Hz scheduler: 12 slices of 83-84 items,
+// every item stepped exactly once per period, also while the item count changes
+void testSlices() {
+    MultiRateScheduler scheduler(240.0f);
+    int count = 1000;
+    std::vector<int> steps(2000, 0);
+    std::vector<int> sliceSizes;
+    scheduler.addSlicedTask("entities", 20.0f, [&count]() { return count; },
+                            [&steps, &sliceSizes](int begin, int end, float deltaTime) {
+        CHECK(deltaTime == 12.0f / 240.0f);
+        sliceSizes.push_back(end - begin);
+        for (int i = begin; i < end; ++i) {
+            steps[i]++;
+        }
+    });
+    for (int tick = 0; tick < 12 * 5; ++tick) {
+        scheduler.step();
+    }
+    CHECK(sliceSizes.size() == 60u);
+    CHECK(*std::min_element(sliceSizes.begin(), sliceSizes.end()) >= 83);
+    CHECK(*std::max_element(sliceSizes.begin(), sliceSizes.end()) <= 84);
+    for (int i = 0; i < count; ++i) {
+        CHECK(steps[i] == 5);
+    }
+
+    // Grown at a period boundary: the new items join the rotation
+    count = 2000;
+    for (int tick = 0; tick < 12; ++tick) {
+        scheduler.step();
+    }
+    for (int i = 0; i < count; ++i) {
+        CHECK(steps[i] == (i < 1000 ? 6 : 1));
+    }
+}
+
+void testAdvance() {
+    MultiRateScheduler scheduler(60.0f);
+    int runs = 0;
+    scheduler.addTask("count", 60.0f, [&runs](float) { runs++; });
+
+    // Whole ticks run, the remainder carries over
+    CHECK(scheduler.advance(1.5 / 60.0) == 1);
+    CHECK(scheduler.advance(0.5 / 60.0) == 1);
+    CHECK(runs == 2);
+
+    // Bad deltas from JS are ignored
+    CHECK(scheduler.advance(std::numeric_limits<double>::quiet_NaN()) == 0);
+    CHECK(scheduler.advance(std::numeric_limits<double>::infinity()) == 0);
+    CHECK(scheduler.advance(-1.0) == 0);
+    CHECK(scheduler.getTick() == 2);
+
+    // A huge delta runs the catch-up limit, drops the rest and leaves no backlog
+    scheduler.setMaxCatchUpTicks(8);
+    CHECK(scheduler.advance(1e300) == 8);
+    CHECK(scheduler.getDroppedTicks() > 0);
+    CHECK(scheduler.advance(0.0) == 0);
+    CHECK(scheduler.advance(1.0 / 60.0) <= 2);
+}
+
+} // namespace
+
+int main() {
+    testPhases();
+    testSlices();
+    testAdvance();
+    return test::result("scheduler_test");
+}
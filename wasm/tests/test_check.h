@@ -0,0 +1,32 @@
+#pragma once
+
+// Minimal checks for the native tests. A failed CHECK prints its location and is counted;
+// each test's main returns non-zero when any check failed, which is all ctest looks at.
+
+#include <cstdio>
+
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline int result(const char* name) {
+    if (failures() == 0) {
+        std::printf("%s: all checks passed\n", name);
+        return 0;
+    }
+    std::printf("%s: %d checks failed\n", name, failures());
+    return 1;
+}
+
+} // namespace test
+
+#define CHECK(condition)                                                                      \
+    do {                                                                                      \
+        if (!(condition)) {                                                                   \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            test::failures()++;                                                               \
+        }                                                                                     \
+    } while (0)
@@ -0,0 +1,100 @@
+// Trim solver: converged points meet the residual tolerance and really fly level, stalled
+// points are reported as such, and the cache is thread-count independent.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "trim.h"
+#include "test_check.h"
+
+namespace {
+
+const std::vector<float> kAltitudes = {0.0f, 3000.0f, 8000.0f};
+const std::vector<float> kSpeeds = {40.0f, 150.0f, 250.0f, 350.0f};
+
+bool sameResult(const TrimResult& a, const TrimResult& b) {
+    return std::memcmp(&a.throttle, &b.throttle, sizeof(float)) == 0 &&
+           std::memcmp(&a.elevator, &b.elevator, sizeof(float)) == 0 &&
+           std::memcmp(&a.alpha, &b.alpha, sizeof(float)) == 0 &&
+           a.converged == b.converged;
+}
+
+void testSolve() {
+    AircraftProperties props;
+    TrimSettings settings;
+    for (float altitude : kAltitudes) {
+        // Far below stall speed there is no level flight
+        TrimResult stalled = solveTrim(props, altitude, 40.0f, settings);
+        CHECK(!stalled.converged);
+        CHECK(stalled.residual >= settings.tolerance);
+
+        for (size_t s = 1; s < kSpeeds.size(); ++s) {
+            TrimResult trim = solveTrim(props, altitude, kSpeeds[s], settings);
+            CHECK(trim.converged);
+            CHECK(trim.residual < settings.tolerance);
+            CHECK(trim.throttle >= 0.0f && trim.throttle <= 1.0f);
+
+            // Released in the trimmed state, the aircraft holds altitude and speed
+            FlightDynamics dynamics;
+            dynamics.setProperties(props);
+            dynamics.setFuel(props.maxFuel * settings.fuelFraction);
+            applyTrim(dynamics, Vec3(0.0f, altitude, 0.0f), 0.3f, kSpeeds[s], trim);
+            for (int tick = 0; tick < 600; ++tick) {
+                dynamics.update(1.0f / 60.0f);
+            }
+            const AircraftState& state = dynamics.getState();
+            CHECK(std::fabs(state.position.y - altitude) < 2.0f);
+            CHECK(std::fabs(state.airspeed - kSpeeds[s]) < 1.0f);
+        }
+    }
+}
+
+void testCache() {
+    std::vector<AircraftProperties> aircraft(2);
+    aircraft[1].name = "Heavy";
+    aircraft[1].emptyMass *= 1.5f;
+
+    TrimCache serial, parallel;
+    CHECK(serial.compute(aircraft, kAltitudes, kSpeeds, 1));
+    CHECK(parallel.compute(aircraft, kAltitudes, kSpeeds, 4));
+    for (const AircraftProperties& props : aircraft) {
+        const TrimTable* a = serial.find(props.name);
+        const TrimTable* b = parallel.find(props.name);
+        CHECK(a != nullptr && b != nullptr);
+        if (!a || !b) {
+            continue;
+        }
+        for (size_t i = 0; i < kAltitudes.size(); ++i) {
+            for (size_t s = 0; s < kSpeeds.size(); ++s) {
+                CHECK(sameResult(a->at(i, s), b->at(i, s)));
+                // Lookup at a grid point returns that point
+                TrimResult exact = a->lookup(kAltitudes[i], kSpeeds[s]);
+                CHECK(std::fabs(exact.throttle - a->at(i, s).throttle) < 1e-6f);
+            }
+        }
+        // Between points the blend stays within the surrounding cell
+        TrimResult mid = a->lookup(1500.0f, 200.0f);
+        float low = std::min(std::min(a->at(0, 1).throttle, a->at(0, 2).throttle),
+                             std::min(a->at(1, 1).throttle, a->at(1, 2).throttle));
+        float high = std::max(std::max(a->at(0, 1).throttle, a->at(0, 2).throttle),
+                              std::max(a->at(1, 1).throttle, a->at(1, 2).throttle));
+        CHECK(mid.converged);
+        CHECK(mid.throttle >= low && mid.throttle <= high);
+    }
+
+    // Unsorted or repeated axes are rejected and leave the tables alone
+    const TrimResult before = serial.find(aircraft[0].name)->at(1, 1);
+    CHECK(!serial.compute(aircraft, {3000.0f, 0.0f}, kSpeeds, 1));
+    CHECK(!serial.compute(aircraft, kAltitudes, {150.0f, 150.0f}, 1));
+    CHECK(serial.find(aircraft[0].name)->getSpeeds() == kSpeeds);
+    CHECK(sameResult(serial.find(aircraft[0].name)->at(1, 1), before));
+}
+
+} // namespace
+
+int main() {
+    testSolve();
+    testCache();
+    return test::result("trim_test");
+}
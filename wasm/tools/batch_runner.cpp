@@ -0,0 +1,299 @@
+// Headless Monte Carlo runner for flight-model regression sweeps.
+// Runs many independent FlightDynamics instances with randomized initial conditions
+// and control schedules on a work-stealing pool, then writes per-aircraft statistics as CSV.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "dat_loader.h"
+#include "simulation.h"
+#include "thread_pool.h"
+
+namespace {
+
+struct RunnerOptions {
+    int runs = 1000;
+    float duration = 120.0f;        // Simulated seconds per run
+    float timeStep = 1.0f / 60.0f;
+    int threads = 0;
+    unsigned int seed = 1;
+    std::string aircraftList;       // aircraft.lst; default F-16 when empty
+    std::string output = "batch_summary.csv";
+    std::string detailOutput;       // Optional per-run CSV
+    float minAltitude = -100.0f;    // Runs going lower (m) count as diverged
+    float maxLoadFactor = 20.0f;    // Runs pulling more (g) count as diverged
+};
+
+// Why a run stopped early
+enum Divergence {
+    DIVERGENCE_NONE = 0,
+    DIVERGENCE_RUNAWAY,             // Non-finite state or physically meaningless speed/altitude
+    DIVERGENCE_BELOW_GROUND,        // Below options.minAltitude
+    DIVERGENCE_LOAD_FACTOR,         // Above options.maxLoadFactor
+    DIVERGENCE_COUNT
+};
+
+const char* const kDivergenceNames[DIVERGENCE_COUNT] = {"", "runaway", "below_ground", "load_factor"};
+
+struct RunResult {
+    int aircraftIndex = 0;
+    float initialAltitude = 0;
+    float initialSpeed = 0;
+    float maxG = 0;
+    float minAltitude = 0;
+    float maxAirspeed = 0;
+    bool diverged = false;
+    Divergence divergence = DIVERGENCE_NONE;
+    float divergenceTime = 0;
+    float simulatedTime = 0;
+};
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "  --runs N         number of runs (default 1000)\n"
+                "  --duration S     simulated seconds per run (default 120)\n"
+                "  --dt S           physics time step (default 1/60)\n"
+                "  --threads N      worker threads, 0 = all cores (default 0)\n"
+                "  --seed N         base random seed (default 1)\n"
+                "  --aircraft PATH  aircraft.lst to sample aircraft types from\n"
+                "  --out PATH       per-aircraft summary CSV (default batch_summary.csv)\n"
+                "  --detail PATH    per-run CSV\n"
+                "  --min-altitude M runs below this altitude in m diverge (default -100)\n"
+                "  --max-g G        runs above this load factor diverge (default 20)\n", program);
+}
+
+bool parseOptions(int argc, char** argv, RunnerOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--runs" && hasValue) {
+            options.runs = std::atoi(argv[++i]);
+        } else if (arg == "--duration" && hasValue) {
+            options.duration = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--dt" && hasValue) {
+            options.timeStep = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--aircraft" && hasValue) {
+            options.aircraftList = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            options.output = argv[++i];
+        } else if (arg == "--detail" && hasValue) {
+            options.detailOutput = argv[++i];
+        } else if (arg == "--min-altitude" && hasValue) {
+            options.minAltitude = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--max-g" && hasValue) {
+            options.maxLoadFactor = static_cast<float>(std::atof(argv[++i]));
+        } else {
+            return false;
+        }
+    }
+    return options.runs > 0 && options.duration > 0 && options.timeStep > 0 && options.maxLoadFactor > 0;
+}
+
+bool isFiniteState(const AircraftState& state) {
+    return std::isfinite(state.position.x) && std::isfinite(state.position.y) &&
+           std::isfinite(state.position.z) && std::isfinite(state.velocity.x) &&
+           std::isfinite(state.velocity.y) && std::isfinite(state.velocity.z) &&
+           std::isfinite(state.pitch) && std::isfinite(state.heading) && std::isfinite(state.roll);
+}
+
+// One run: random start, piecewise-constant random controls held for 1-5 s each
+RunResult simulateRun(const std::vector<AircraftProperties>& aircraft, const RunnerOptions& options,
+                      int runIndex) {
+    std::mt19937 rng(options.seed * 1000003u + static_cast<unsigned int>(runIndex));
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> surface(-1.0f, 1.0f);
+
+    RunResult result;
+    result.aircraftIndex = static_cast<int>(rng() % aircraft.size());
+    const AircraftProperties& props = aircraft[result.aircraftIndex];
+
+    FlightDynamics dynamics;
+    dynamics.setProperties(props);
+    result.initialAltitude = 500.0f + unit(rng) * 9500.0f;
+    float heading = (unit(rng) * 2.0f - 1.0f) * static_cast<float>(M_PI);
+    dynamics.initialize(Vec3(0, result.initialAltitude, 0), heading);
+
+    AircraftState state = dynamics.getState();
+    float minSpeed = std::max(props.minManeuverableSpeed, 50.0f);
+    result.initialSpeed = minSpeed + unit(rng) * std::max(0.0f, props.maxSpeed * 0.8f - minSpeed);
+    state.velocity = Vec3(result.initialSpeed * std::cos(heading), 0, result.initialSpeed * std::sin(heading));
+    state.airspeed = result.initialSpeed;
+    dynamics.setState(state);
+
+    const float gravity = 9.81f;
+    const float dt = options.timeStep;
+    const int steps = static_cast<int>(options.duration / dt);
+    result.minAltitude = result.initialAltitude;
+    result.maxAirspeed = result.initialSpeed;
+
+    ControlInputs controls;
+    float nextChange = 0.0f;
+    Vec3 previousVelocity = state.velocity;
+
+    for (int step = 0; step < steps; ++step) {
+        float time = step * dt;
+        if (time >= nextChange) {
+            controls.throttle = unit(rng);
+            controls.aileron = surface(rng);
+            controls.elevator = surface(rng);
+            controls.rudder = surface(rng);
+            dynamics.setControls(controls);
+            nextChange = time + 1.0f + unit(rng) * 4.0f;
+        }
+
+        dynamics.update(dt);
+        const AircraftState& current = dynamics.getState();
+        result.simulatedTime = time + dt;
+
+        // Diverged: non-finite state or physically meaningless speed/altitude
+        if (!isFiniteState(current) || current.airspeed > props.maxSpeed * 10.0f ||
+            std::fabs(current.altitude) > 100000.0f) {
+            result.divergence = DIVERGENCE_RUNAWAY;
+        } else {
+            // Load factor from specific force (acceleration minus gravity)
+            float ax = (current.velocity.x - previousVelocity.x) / dt;
+            float ay = (current.velocity.y - previousVelocity.y) / dt + gravity;
+            float az = (current.velocity.z - previousVelocity.z) / dt;
+            float g = std::sqrt(ax * ax + ay * ay + az * az) / gravity;
+            previousVelocity = current.velocity;
+
+            result.maxG = std::max(result.maxG, g);
+            result.minAltitude = std::min(result.minAltitude, current.altitude);
+            result.maxAirspeed = std::max(result.maxAirspeed, current.airspeed);
+
+            // Finite but outside what the flight model is meant to produce
+            if (current.altitude < options.minAltitude) {
+                result.divergence = DIVERGENCE_BELOW_GROUND;
+            } else if (g > options.maxLoadFactor) {
+                result.divergence = DIVERGENCE_LOAD_FACTOR;
+            }
+        }
+
+        if (result.divergence != DIVERGENCE_NONE) {
+            result.diverged = true;
+            result.divergenceTime = result.simulatedTime;
+            break;
+        }
+    }
+
+    return result;
+}
+
+bool writeSummary(const std::string& path, const std::vector<AircraftProperties>& aircraft,
+                  const std::vector<RunResult>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    out << "aircraft,runs,diverged,max_g,mean_max_g,min_altitude,max_airspeed,simulated_seconds\n";
+    for (size_t a = 0; a < aircraft.size(); ++a) {
+        int runs = 0, diverged = 0;
+        float maxG = 0, sumMaxG = 0, minAltitude = 0, maxAirspeed = 0;
+        double simulated = 0;
+        for (const RunResult& run : results) {
+            if (run.aircraftIndex != static_cast<int>(a)) {
+                continue;
+            }
+            minAltitude = runs == 0 ? run.minAltitude : std::min(minAltitude, run.minAltitude);
+            runs++;
+            diverged += run.diverged ? 1 : 0;
+            maxG = std::max(maxG, run.maxG);
+            sumMaxG += run.maxG;
+            maxAirspeed = std::max(maxAirspeed, run.maxAirspeed);
+            simulated += run.simulatedTime;
+        }
+        if (runs == 0) {
+            continue;
+        }
+        out << aircraft[a].name << ',' << runs << ',' << diverged << ',' << maxG << ','
+            << sumMaxG / runs << ',' << minAltitude << ',' << maxAirspeed << ',' << simulated << '\n';
+    }
+    return true;
+}
+
+bool writeDetail(const std::string& path, const std::vector<AircraftProperties>& aircraft,
+                 const std::vector<RunResult>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    out << "run,aircraft,initial_altitude,initial_speed,max_g,min_altitude,max_airspeed,diverged,divergence_time,"
+           "divergence\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const RunResult& run = results[i];
+        out << i << ',' << aircraft[run.aircraftIndex].name << ',' << run.initialAltitude << ','
+            << run.initialSpeed << ',' << run.maxG << ',' << run.minAltitude << ','
+            << run.maxAirspeed << ',' << (run.diverged ? 1 : 0) << ',' << run.divergenceTime << ','
+            << kDivergenceNames[run.divergence] << '\n';
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    RunnerOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<AircraftProperties> aircraft;
+    if (!options.aircraftList.empty()) {
+        aircraft = loadAircraftList(options.aircraftList);
+        if (aircraft.empty()) {
+            std::fprintf(stderr, "No aircraft loaded from %s\n", options.aircraftList.c_str());
+            return 1;
+        }
+    } else {
+        aircraft.push_back(AircraftProperties());
+    }
+
+    std::vector<RunResult> results(options.runs);
+    WorkStealingPool pool(options.threads);
+
+    auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(results.size(), [&](size_t run) {
+        results[run] = simulateRun(aircraft, options, static_cast<int>(run));
+    });
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double simulatedSeconds = 0;
+    int divergences = 0;
+    int byDivergence[DIVERGENCE_COUNT] = {};
+    for (const RunResult& run : results) {
+        simulatedSeconds += run.simulatedTime;
+        divergences += run.diverged ? 1 : 0;
+        byDivergence[run.divergence]++;
+    }
+
+    if (!writeSummary(options.output, aircraft, results)) {
+        std::fprintf(stderr, "Failed to write %s\n", options.output.c_str());
+        return 1;
+    }
+    if (!options.detailOutput.empty() && !writeDetail(options.detailOutput, aircraft, results)) {
+        std::fprintf(stderr, "Failed to write %s\n", options.detailOutput.c_str());
+        return 1;
+    }
+
+    std::printf("%d runs on %d threads, %d diverged (%d runaway, %d below %.0f m, %d above %.1f g)\n",
+                options.runs, std::max(1, pool.getThreadCount()), divergences,
+                byDivergence[DIVERGENCE_RUNAWAY], byDivergence[DIVERGENCE_BELOW_GROUND], options.minAltitude,
+                byDivergence[DIVERGENCE_LOAD_FACTOR], options.maxLoadFactor);
+    std::printf("%.0f simulated s in %.3f wall s (%.0f simulated s per wall s)\n",
+                simulatedSeconds, wallSeconds, simulatedSeconds / std::max(wallSeconds, 1e-9));
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Energy-maneuverability diagram generator.
+// Evaluates specific excess power and turn performance over a Mach x altitude grid
+// for one or more aircraft and writes a CSV per aircraft.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "dat_loader.h"
+#include "energy_maneuverability.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options] <aircraft.dat | aircraft.lst>\n"
+                "  --mach MIN MAX N       Mach axis (default 0.1 2.0 96)\n"
+                "  --altitude MIN MAX N   altitude axis in m (default 0 15000 64)\n"
+                "  --throttle T           fraction of maximum thrust (default 1)\n"
+                "  --out DIR              output directory for <name>_em.csv (default .)\n", program);
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    EnergyGridSpec spec;
+    std::string input;
+    std::string outputDir = ".";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--mach" && i + 3 < argc) {
+            spec.minMach = static_cast<float>(std::atof(argv[++i]));
+            spec.maxMach = static_cast<float>(std::atof(argv[++i]));
+            spec.machSteps = std::atoi(argv[++i]);
+        } else if (arg == "--altitude" && i + 3 < argc) {
+            spec.minAltitude = static_cast<float>(std::atof(argv[++i]));
+            spec.maxAltitude = static_cast<float>(std::atof(argv[++i]));
+            spec.altitudeSteps = std::atoi(argv[++i]);
+        } else if (arg == "--throttle" && i + 1 < argc) {
+            spec.throttle = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--out" && i + 1 < argc) {
+            outputDir = argv[++i];
+        } else if (input.empty() && arg[0] != '-') {
+            input = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (input.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!spec.isValid()) {
+        std::fprintf(stderr, "Mach bounds must be positive, altitudes non-negative, and MIN <= MAX\n");
+        return 1;
+    }
+
+    std::vector<AircraftProperties> aircraft;
+    if (endsWith(input, ".lst")) {
+        aircraft = loadAircraftList(input);
+    } else {
+        AircraftProperties props;
+        if (loadAircraftDat(input, props)) {
+            aircraft.push_back(props);
+        }
+    }
+    if (aircraft.empty()) {
+        std::fprintf(stderr, "No aircraft loaded from %s\n", input.c_str());
+        return 1;
+    }
+
+    EnergyManeuverabilityDiagram diagram;
+    double computeSeconds = 0;
+    size_t evaluations = 0;
+
+    for (const AircraftProperties& props : aircraft) {
+        auto start = std::chrono::steady_clock::now();
+        diagram.compute(props, spec);
+        computeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        evaluations += diagram.getMachs().size() * diagram.getAltitudes().size();
+
+        std::string path = outputDir + "/" + props.name + "_em.csv";
+        std::ofstream out(path);
+        if (!out) {
+            std::fprintf(stderr, "Failed to write %s\n", path.c_str());
+            return 1;
+        }
+        diagram.writeCsv(out);
+    }
+
+    std::printf("%zu aircraft, %zu grid points in %.3f ms (%.1f M points/s)\n",
+                aircraft.size(), evaluations, computeSeconds * 1000.0,
+                evaluations / std::max(computeSeconds, 1e-9) / 1e6);
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Native timing of the vmath batch kernels behind the batch math bindings.
+// Compares each kernel against a loop over the same packed arrays using the per-element Vec3
+// and Quat operations. This measures the math only: the embind cost of the per-object JS
+// path (one wrapped object and delete() per result) comes on top and is what
+// benchmarkBatchMath in src/utils/batch-math.ts measures in the browser.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "vector_math.h"
+
+namespace {
+
+Vec3 loadVec3(const std::vector<float>& data, size_t i) {
+    return Vec3(data[i * 3], data[i * 3 + 1], data[i * 3 + 2]);
+}
+
+Quat loadQuat(const std::vector<float>& data, size_t i) {
+    return Quat(data[i * 4], data[i * 4 + 1], data[i * 4 + 2], data[i * 4 + 3]);
+}
+
+void storeVec3(std::vector<float>& data, size_t i, const Vec3& v) {
+    data[i * 3] = v.x;
+    data[i * 3 + 1] = v.y;
+    data[i * 3 + 2] = v.z;
+}
+
+void storeQuat(std::vector<float>& data, size_t i, const Quat& q) {
+    data[i * 4] = q.x;
+    data[i * 4 + 1] = q.y;
+    data[i * 4 + 2] = q.z;
+    data[i * 4 + 3] = q.w;
+}
+
+// Best of 'repeats' runs, in nanoseconds per element
+double timeRun(const std::function<void()>& run, size_t count, int repeats) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns / static_cast<double>(count));
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = 10000;
+    int repeats = 200;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--count" && i + 1 < argc) {
+            count = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeats = std::atoi(argv[++i]);
+        } else {
+            std::printf("Usage: %s [--count N] [--repeat R]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> a(count * 4), b(count * 4), vectors(count * 3), out(count * 4);
+    for (float& value : a) value = uniform(random);
+    for (float& value : b) value = uniform(random);
+    for (float& value : vectors) value = uniform(random);
+
+    struct Case {
+        const char* operation;
+        std::function<void()> perElement;
+        std::function<void()> batch;
+    };
+    const Case cases[] = {
+        {"add",
+         [&] { for (size_t i = 0; i < count; ++i) storeVec3(out, i, loadVec3(a, i) + loadVec3(b, i)); },
+         [&] { vmath::addVectors(a.data(), b.data(), out.data(), count); }},
+        {"cross",
+         [&] { for (size_t i = 0; i < count; ++i) storeVec3(out, i, loadVec3(a, i).cross(loadVec3(b, i))); },
+         [&] { vmath::crossVectors(a.data(), b.data(), out.data(), count); }},
+        {"normalize",
+         [&] { for (size_t i = 0; i < count; ++i) storeVec3(out, i, loadVec3(vectors, i).normalized()); },
+         [&] { vmath::normalizeVectors(vectors.data(), out.data(), count); }},
+        {"quaternion multiply",
+         [&] { for (size_t i = 0; i < count; ++i) storeQuat(out, i, loadQuat(a, i) * loadQuat(b, i)); },
+         [&] { vmath::multiplyQuaternions(a.data(), b.data(), out.data(), count); }},
+        {"rotate vector",
+         [&] { for (size_t i = 0; i < count; ++i) storeVec3(out, i, loadQuat(a, i).rotate(loadVec3(vectors, i))); },
+         [&] { vmath::rotateVectors(a.data(), vectors.data(), out.data(), count); }},
+    };
+
+    std::printf("backend %s, %zu elements, best of %d\n", vmath::kBackend, count, repeats);
+    std::printf("%-20s %14s %14s %8s\n", "operation", "per element", "batch", "ratio");
+    for (const Case& c : cases) {
+        double perElement = timeRun(c.perElement, count, repeats);
+        double batch = timeRun(c.batch, count, repeats);
+        std::printf("%-20s %11.2f ns %11.2f ns %7.2fx\n", c.operation, perElement, batch, perElement / batch);
+    }
+    return 0;
+}
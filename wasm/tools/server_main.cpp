@@ -0,0 +1,176 @@
+// Headless authoritative simulation server.
+// Hosts many independent sessions, each stepping its fleet at a fixed tick rate on a shared
+// work-stealing pool, with loopback clients standing in for players. Prints tick-time
+// percentiles, dropped ticks and per-client bandwidth.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "memory_stats.h"
+#include "sim_server.h"
+
+namespace {
+
+struct ServerOptions {
+    int sessions = 100;
+    float duration = 10.0f;         // Server seconds to run
+    int threads = 0;
+    bool realtime = false;          // Pace ticks to the wall clock instead of running flat out
+    bool checkAllocations = false;  // Count heap allocations made while stepping sessions
+    float snapshotRate = 20.0f;
+    float latency = 0.05f;          // One-way loopback latency (s)
+    SessionConfig session;
+};
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "  --sessions N       sessions to host (default 100)\n"
+                "  --aircraft N       aircraft per session (default 32)\n"
+                "  --clients N        loopback players per session (default 4)\n"
+                "  --tick-rate HZ     physics ticks per second (default 60)\n"
+                "  --snapshot-rate HZ snapshots per second to each client (default 20)\n"
+                "  --budget BYTES     snapshot packet budget (default 400)\n"
+                "  --latency S        one-way loopback latency (default 0.05)\n"
+                "  --loss F           loopback packet loss 0..1 (default 0)\n"
+                "  --full-radius M    full physics within M of a player, 0 = everywhere (default 5000)\n"
+                "  --duration S       server seconds to run (default 10)\n"
+                "  --threads N        worker threads, 0 = all cores (default 0)\n"
+                "  --realtime         pace ticks to the wall clock\n"
+                "  --check-allocations report heap allocations inside session ticks\n", program);
+}
+
+bool parseOptions(int argc, char** argv, ServerOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sessions" && hasValue) {
+            options.sessions = std::atoi(argv[++i]);
+        } else if (arg == "--aircraft" && hasValue) {
+            options.session.aircraftCount = std::atoi(argv[++i]);
+        } else if (arg == "--clients" && hasValue) {
+            options.session.clientCount = std::atoi(argv[++i]);
+        } else if (arg == "--tick-rate" && hasValue) {
+            options.session.tickRate = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--snapshot-rate" && hasValue) {
+            options.snapshotRate = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--budget" && hasValue) {
+            options.session.packetBudget = static_cast<size_t>(std::atoi(argv[++i]));
+        } else if (arg == "--latency" && hasValue) {
+            options.latency = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--loss" && hasValue) {
+            options.session.lossRate = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--full-radius" && hasValue) {
+            options.session.fullPhysicsRadius = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--duration" && hasValue) {
+            options.duration = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--realtime") {
+            options.realtime = true;
+        } else if (arg == "--check-allocations") {
+            options.checkAllocations = true;
+        } else {
+            return false;
+        }
+    }
+
+    SessionConfig& session = options.session;
+    if (options.sessions <= 0 || options.duration <= 0 || session.tickRate <= 0 ||
+        options.snapshotRate <= 0 || session.clientCount < 0 || session.packetBudget < 16) {
+        return false;
+    }
+    session.snapshotInterval = std::max(1, static_cast<int>(std::lround(session.tickRate / options.snapshotRate)));
+    session.latencyTicks = std::max(0, static_cast<int>(std::lround(options.latency * session.tickRate)));
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ServerOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    SimServer server(options.threads);
+    for (int i = 0; i < options.sessions; ++i) {
+        server.addSession(options.session);
+    }
+
+    memory::setHotPathCheck(options.checkAllocations);
+    const double tickDuration = 1.0 / options.session.tickRate;
+    auto start = std::chrono::steady_clock::now();
+    while (server.getTime() < options.duration) {
+        if (options.realtime) {
+            double next = server.getNextTickTime();
+            std::this_thread::sleep_until(start + std::chrono::duration<double>(next));
+            double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            server.advance(now - server.getTime());
+        } else {
+            server.advance(tickDuration);
+        }
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Tick times: combined and worst session
+    TickHistogram combined = server.getCombinedHistogram();
+    double worstP99 = 0;
+    int worstSession = 0;
+    double totalBytes = 0, maxClientBytes = 0;
+    int clients = 0;
+    for (int i = 0; i < server.getSessionCount(); ++i) {
+        const ServerSession& session = server.getSession(i);
+        double p99 = session.getHistogram().getPercentile(0.99);
+        if (p99 > worstP99) {
+            worstP99 = p99;
+            worstSession = i;
+        }
+        for (int c = 0; c < session.getClientCount(); ++c) {
+            double bytes = static_cast<double>(session.getBytesSent(c));
+            totalBytes += bytes;
+            maxClientBytes = std::max(maxClientBytes, bytes);
+            clients++;
+        }
+    }
+
+    const double serverSeconds = server.getTime();
+    std::printf("%d sessions x %d aircraft, %d clients each, on %d threads\n", options.sessions,
+                std::max(options.session.aircraftCount, options.session.clientCount),
+                options.session.clientCount, std::max(1, server.getThreadCount()));
+    std::printf("%.1f server s in %.3f wall s (%.1fx real time), %llu ticks, %lld dropped\n",
+                serverSeconds, wallSeconds, serverSeconds / std::max(wallSeconds, 1e-9),
+                static_cast<unsigned long long>(combined.getCount()),
+                static_cast<long long>(server.getDroppedTicks()));
+    std::printf("tick time: mean %.1f us, p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+                combined.getMean() * 1e6, combined.getPercentile(0.5) * 1e6,
+                combined.getPercentile(0.99) * 1e6, combined.getPercentile(0.999) * 1e6,
+                combined.getMax() * 1e6);
+    std::printf("worst session %d: p99 %.1f us (tick budget %.1f us)\n", worstSession, worstP99 * 1e6,
+                tickDuration * 1e6);
+    if (clients > 0) {
+        std::printf("snapshot bandwidth per client: mean %.1f kbit/s, max %.1f kbit/s\n",
+                    totalBytes * 8.0 / clients / serverSeconds / 1000.0,
+                    maxClientBytes * 8.0 / serverSeconds / 1000.0);
+    }
+    std::printf("heap: %.1f MB in use, %.1f MB peak, %llu allocations\n", memory::getCurrentBytes() / 1e6,
+                memory::getPeakBytes() / 1e6, static_cast<unsigned long long>(memory::getAllocationCount()));
+    for (int tag = 0; tag < MEM_TAG_COUNT; ++tag) {
+        MemoryTagStats stats = memory::getTagStats(tag);
+        if (stats.allocations > 0) {
+            std::printf("  %-9s %8.1f KB in use, %8.1f KB peak, %llu allocations\n", memory::tagName(tag),
+                        stats.currentBytes / 1e3, stats.peakBytes / 1e3,
+                        static_cast<unsigned long long>(stats.allocations));
+        }
+    }
+    if (options.checkAllocations) {
+        std::printf("allocations inside session ticks: %llu\n",
+                    static_cast<unsigned long long>(memory::getHotPathAllocations()));
+    }
+    return 0;
+}